@@ -1,4 +1,4 @@
-﻿/*
+/*
  * Students' Information Management System / 学生信息管理系统 / SIMS
  * Copyright (c) 2025 陈宸 (Chen Chen / MccoyFreyr / Cchen / Mccoy)
  * Licensed under the MIT License. See LICENSE file for details.
@@ -6,8 +6,33 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <conio.h> 
+#include <time.h>
+#include <limits.h>
+#include <stddef.h>
+#ifdef _WIN32
+#include <conio.h>
 #include <windows.h>
+#include <psapi.h>
+#include <io.h>
+#else
+#include <termios.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define Sleep(ms) usleep((ms) * 1000)
+#endif
+
+// 按列统计成绩时，x86 上使用 SSE2（x86-64 的基本指令集）；GCC/Clang 另编译一份 AVX2 版本，运行时按 CPU 选用
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define HAVE_SSE2 1
+#if defined(__GNUC__)
+#define HAVE_AVX2_TARGET 1
+#endif
+#endif
 
 // 颜色定义
 #define COLOR_RED     "\033[31m"
@@ -26,24 +51,488 @@
 #define COPYRIGHT_YEAR "2023-2025"
 #define LICENSE_TYPE "MIT License"
 
+// 数据快照文件
+#define SNAPSHOT_FILE    "students.sims"
+#define SNAPSHOT_MAGIC   "SIMS"
+#define SNAPSHOT_VERSION 2
+
+// 操作日志（预写日志）文件
+#define JOURNAL_FILE              "students.journal"
+#define JOURNAL_MAGIC             "SIMJ"
+#define JOURNAL_BUFFER_SIZE       (256 * 1024)       // 成组提交缓冲区大小
+#define JOURNAL_GROUP_COMMIT      64                 // 累计多少条记录后落盘一次
+#define JOURNAL_SYNC_INTERVAL_MS  200                // 两次落盘的最长间隔
+#define JOURNAL_COMPACT_BYTES     (32LL * 1024 * 1024) // 日志超过该大小时合并进快照
+#define JOURNAL_MAX_SCORES        1024               // 单条记录最多保存的成绩数
+
+// 数据文件锁：持有者才能修改快照与日志
+#define LOCK_FILE "students.lock"
+
+// 日志记录类型
+#define JOURNAL_ADD          1
+#define JOURNAL_MODIFY       2
+#define JOURNAL_DELETE       3
+#define JOURNAL_PRESET_ADD   4
+#define JOURNAL_PRESET_CLEAR 5
+
+// 分页浏览每页行数
+#define BROWSE_PAGE_SIZE 20
+
+// 输出缓冲区初始容量与上限（超过上限时分段写出）
+#define OUTPUT_BUFFER_INITIAL (1024 * 1024)
+#define OUTPUT_BUFFER_MAX     (16 * 1024 * 1024)
+
+// 导出格式
+#define EXPORT_CSV    0
+#define EXPORT_NDJSON 1               // 每行一个 JSON 对象（JSON Lines）
+
+// 批量导入
+#define IMPORT_BUFFER_SIZE  (4 * 1024 * 1024) // 读缓冲区大小
+#define IMPORT_FIXED_FIELDS 6                 // 姓名,性别,学号,班级,院系,专业
+#define IMPORT_MAX_FIELDS   256               // 每行最多字段数（含成绩）
+#define IMPORT_LINE_MAX     (64 * 1024)       // 多线程导入时单行最大长度
+#define IMPORT_MAX_THREADS  64                // 多线程导入最大线程数
+#define IMPORT_PARALLEL_MIN (8 * 1024 * 1024) // 文件超过该大小时使用多线程导入
+
+// 预设种类（与快照中预设的保存顺序一致）
+#define PRESET_SCORE_NAME 0
+#define PRESET_DEPARTMENT 1
+#define PRESET_MAJOR      2
+
+// 班级、院系、专业名称的最大字节数（含结尾'\0'，与快照记录中的定长字段一致）
+#define CLASS_NAME_SIZE      20
+#define DEPARTMENT_NAME_SIZE 30
+#define MAJOR_NAME_SIZE      30
+#define SCORE_NAME_SIZE      50
+
+// 学生记录内直接存放的成绩数量（浮点模式），超出时全部成绩改放到成绩池
+#define SCORE_INLINE_COUNT 8
+
 // 学生信息结构体
 typedef struct {
     char name[20];       // 姓名
     char gender[5];      // 性别
     char id[20];         // 学号
-    char className[20];  // 班级
-    char department[30]; // 院系
-    char major[30];      // 专业
-    float *scores;       // 成绩数组
+    unsigned char deleted; // 已标记删除、等待压缩（见 markStudentDeleted）
+    int classId;         // 班级（字典编号）
+    int departmentId;    // 院系（字典编号）
+    int majorId;         // 专业（字典编号）
     int scoreCount;      // 成绩数量
-    float totalScore;    // 成绩总和
+    union {
+        float totalScore;                       // 浮点模式
+        int totalHundredths;                    // 定点模式：精确的整数总和（百分之一分）
+    } total;             // 成绩总和（通过 studentTotal 读取）
+    union {
+        float inlineScores[SCORE_INLINE_COUNT]; // 放得下时直接存放在记录内
+        unsigned short inlineFixed[SCORE_INLINE_COUNT * 2];
+        float *heapScores;                      // 超出时从成绩池分配
+        unsigned short *heapFixed;
+    } scoreData;         // 成绩（通过 studentScore 读取，定点模式下为百分之一分）
 } Student;
 
-// 学生信息管理系统结构体
+// 改用字典编号之前的学生结构体布局（仅用于内存报告对比）
+typedef struct {
+    char name[20];
+    char gender[5];
+    char id[20];
+    char className[CLASS_NAME_SIZE];
+    char department[DEPARTMENT_NAME_SIZE];
+    char major[MAJOR_NAME_SIZE];
+    float *scores;
+    int scoreCount;
+    float totalScore;
+} EmbeddedStudent;
+
+// 成绩池参数：按规格分配（见 scoreClassSizes），小块从 256KB 的板块中切出
+#define SCORE_POOL_CLASSES    13
+#define SCORE_POOL_SLAB_BYTES (256 * 1024)
+
+// 成绩池板块（头部之后为块数据）
+typedef struct ScoreSlabTag {
+    struct ScoreSlabTag *next;
+    void *reserved;               // 保持块数据16字节对齐
+} ScoreSlab;
+
+// 超过最大规格、单独向系统申请的成绩数组（头部之后为成绩）
+typedef struct ScoreLargeBlockTag {
+    struct ScoreLargeBlockTag *prev;
+    struct ScoreLargeBlockTag *next;
+} ScoreLargeBlock;
+
+// 成绩池：学生的成绩数组都从这里分配，释放管理器时整体归还
+typedef struct {
+    ScoreSlab *slabs;             // 全部板块
+    ScoreSlab *currentSlab;       // 正在切分的板块
+    size_t currentUsed;           // 当前板块已切出的字节数
+    void *freeLists[SCORE_POOL_CLASSES]; // 各规格的空闲块链表（块首保存下一块地址，块只保证4字节对齐）
+    ScoreLargeBlock *largeBlocks; // 大块链表
+    long long allocCalls;         // 分配请求次数
+    long long freeCalls;          // 释放请求次数
+    long long systemAllocs;       // 向系统申请内存的次数
+    long long slabCount;          // 板块数量
+    size_t liveBytes;             // 使用中的小块字节数（按规格取整）
+    size_t freeBytes;             // 空闲链表中的字节数
+    size_t largeBytes;            // 大块字节数
+    size_t requestedBytes;        // 使用中的成绩实际字节数
+    size_t tailWasteBytes;        // 换板块时旧板块尾部放不下的字节数
+} ScorePool;
+
+// 快照文件头（文件开头，其后依次为学生记录、成绩数组、预设字符串、索引区）
+typedef struct {
+    char magic[4];                // 文件标识 "SIMS"
+    unsigned int version;         // 格式版本
+    unsigned int studentCount;    // 学生数量
+    unsigned int scoreTotal;      // 成绩总数
+    unsigned int scoreNameCount;  // 成绩名预设数量
+    unsigned int departmentCount; // 院系预设数量
+    unsigned int majorCount;      // 专业预设数量
+    unsigned int stringBytes;     // 预设字符串区字节数
+    unsigned int checksum;        // 文件头之后全部内容的校验和
+    unsigned int journalGeneration; // 快照之后应重放的最早日志代数
+    unsigned int indexBytes;      // 索引区字节数（版本2起；为0时没有索引区，加载后重建索引）
+} SnapshotHeader;
+
+// 版本1的文件头没有 indexBytes 字段
+#define SNAPSHOT_V1_HEADER_SIZE offsetof(SnapshotHeader, indexBytes)
+
+// 快照中的学生记录（定长，成绩保存在独立的成绩数组中）
+typedef struct {
+    char name[20];
+    char gender[5];
+    char id[20];
+    char className[CLASS_NAME_SIZE];
+    char department[DEPARTMENT_NAME_SIZE];
+    char major[MAJOR_NAME_SIZE];
+    char padding[3];
+    unsigned int scoreCount;      // 成绩数量
+    unsigned int scoreOffset;     // 在成绩数组中的起始位置
+    float totalScore;             // 成绩总和
+} SnapshotStudent;
+
+// 快照索引区的读取位置。索引区紧跟预设字符串（不保证对齐，按字节拷出），依次为：
+// 名称字典；各学生的班级、院系、专业编号（每人3个 int）；姓名字元字典；拼音检索键字典；学号哈希索引；
+// 学号有序索引；专业、院系、班级、姓名字元、拼音倒排索引；拼音检索键顺序。
+// 字典为数量、字节数和按编号依次以'\0'结尾的字符串；倒排索引为列表数、各列表长度和依次排列的学生下标
+typedef struct {
+    const unsigned char *data;    // 未读部分
+    size_t left;                  // 剩余字节数
+} SnapshotReader;
+
+// 只读映射的文件
+typedef struct {
+    const unsigned char *data;    // 映射地址
+    size_t size;                  // 文件大小
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int fd;
+#endif
+} MappedFile;
+
+// 日志文件头
+typedef struct {
+    char magic[4];                // 文件标识 "SIMJ"
+    unsigned int generation;      // 日志代数，每次合并进快照后加一
+} JournalFileHeader;
+
+// 日志记录头（其后紧跟 length 字节的负载）
+typedef struct {
+    unsigned int length;          // 负载长度
+    unsigned int checksum;        // 负载校验和
+    unsigned char type;           // 记录类型
+    unsigned char padding[3];
+} JournalRecordHeader;
+
+#ifdef _WIN32
+typedef HANDLE SimsThread;
+#else
+typedef pthread_t SimsThread;
+#endif
+
+// 操作日志
+typedef struct {
+    FILE *file;                   // 日志文件
+    char path[260];               // 日志文件路径
+    unsigned int generation;      // 当前日志代数
+    unsigned char *buffer;        // 成组提交缓冲区
+    size_t used;                  // 缓冲区已用字节数
+    int unsyncedRecords;          // 已写出但尚未落盘的记录数
+    long long lastSyncMs;         // 上次落盘时间
+    long long bytesWritten;       // 当前日志文件大小
+    int failed;                   // 写入失败标记
+    SimsThread compactThread;     // 后台压缩线程
+    int compacting;               // 后台压缩是否在进行
+    int compactFailed;            // 上次压缩未能写出快照（.old 日志尚未合并，不能删除）
+} Journal;
+
+// 后台压缩任务
+typedef struct {
+    unsigned char *data;          // 序列化好的快照内容
+    size_t size;
+    char snapshotPath[260];
+    char oldJournalPath[270];     // 合并完成后删除的旧日志
+    int *failed;                  // 写出快照失败时置1（指向 Journal.compactFailed）
+} CompactionJob;
+
+// 批量导入统计
+typedef struct {
+    long long rows;               // 数据行数（不含表头和空行）
+    long long imported;           // 成功导入数
+    long long rejected;           // 拒绝数
+    double seconds;               // 耗时
+} ImportStats;
+
+// 逐行读取文本文件（见 readFileLines）：首行（已去掉 UTF-8 BOM）以 headers 中任一前缀开头时作为表头跳过；
+// firstLine（可为NULL）在首行上调用，用于按首行内容确定格式；handleRow 在每个非空数据行上调用
+typedef struct {
+    const char *const *headers;   // 表头前缀，以NULL结尾
+    void (*firstLine)(void *context, const char *line);
+    void (*handleRow)(void *context, char *line, long long lineNumber);
+    void *context;
+} LineReader;
+
+// 批量导入的逐行状态（见 importStudents）
+typedef struct {
+    struct StudentManagerTag *manager;
+    FILE *report;
+    ImportStats *stats;
+    const char *ext;              // 文件扩展名（可为NULL）
+    char delimiter;               // 字段分隔符
+} ImportContext;
+
+// 成绩表合并的逐行状态（见 mergeCourseFile）
+typedef struct {
+    struct StudentManagerTag *manager;
+    int course;                   // 写入第几门成绩
+    FILE *report;
+    ImportStats *stats;
+} MergeContext;
+
+// 输出缓冲区
+typedef struct {
+    char *data;
+    size_t used;
+    size_t capacity;
+    int fd;                       // 写出的文件描述符
+    int failed;                   // 写出失败标记（如磁盘已满）
+} OutputBuffer;
+
+// 批量导入中被拒绝的行
+typedef struct {
+    long long line;               // 行号
+    const char *reason;           // 拒绝原因
+    char id[20];                  // 学号字段
+} ImportRejection;
+
+// 已通过校验、等待合并的学生
+typedef struct {
+    Student student;
+    long long line;               // 在分片内的行号
+    char className[CLASS_NAME_SIZE]; // 字典中尚无该班级时暂存名称，合并时登记
+} ImportedStudent;
+
+// 多线程导入的分片（每个工作线程一个）
+typedef struct {
+    struct StudentManagerTag *manager; // 只读：预设与已有学号
+    const char *begin;            // 分片起始（行首）
+    const char *end;              // 分片结束（下一行行首）
+    char delimiter;               // 字段分隔符
+    ImportedStudent *students;    // 线程本地的解析结果
+    int count;
+    int capacity;
+    ImportRejection *rejections;  // 线程本地的拒绝记录
+    int rejectionCount;
+    int rejectionCapacity;
+    long long lines;              // 分片内的行数
+    long long rows;               // 分片内的数据行数
+    ScorePool scorePool;          // 线程本地的成绩池（合并时复制进管理器的成绩池）
+} ImportShard;
+
+// 学号哈希索引槽位
+typedef struct {
+    unsigned int hash;      // 学号哈希值
+    int index;              // 学生下标（ID_INDEX_EMPTY 为空槽，ID_INDEX_DELETED 为删除标记）
+} IdIndexSlot;
+
+#define ID_INDEX_EMPTY   -1
+#define ID_INDEX_DELETED -2
+
+// 学号有序索引：主数组按学号排序；新增学生先追加到增量缓冲区，查询时再排序，缓冲区较大时并入主数组
+typedef struct {
+    int *sorted;            // 按学号排序的学生下标
+    int sortedCount;
+    int sortedCapacity;
+    int *delta;             // 增量缓冲区：尚未并入主数组的学生下标
+    int deltaCount;
+    int deltaCapacity;
+    int deltaSorted;        // 增量缓冲区是否已按学号排序
+} IdOrderIndex;
+
+// 增量缓冲区超过这个大小时，查询前先归并进主数组
+#define ID_ORDER_DELTA_MAX 4096
+
+// 排序增量缓冲区用的临时项（复制学号，比较时不必访问学生记录）
+typedef struct {
+    char id[20];
+    int index;
+} IdOrderItem;
+
+// 成绩排行树结点：按总分从高到低排列，总分相同时下标小的在前
+typedef struct {
+    int key;                // 总分（百分之一分）
+    int index;              // 学生下标
+    int left;               // 左右子结点在结点数组中的位置，-1 表示空
+    int right;
+    int size;               // 子树结点数（用于按名次定位）
+} RankNode;
+
+// 成绩排行树：按子树大小增强的树堆（treap），结点存放在数组中，删除的结点通过空闲链表复用
+// 排名、百分位、前K名查询均为 O(log n)（前K名另加 K）
+typedef struct {
+    RankNode *nodes;
+    int nodeCount;
+    int nodeCapacity;
+    int freeHead;           // 空闲结点链表（借用 left 串起来）
+    int root;
+    int built;              // 是否已建立（排行只在首次查询时建立，之后随增删改维护）
+} RankTree;
+
+// 排行范围
+#define RANK_SCOPE_ALL   0  // 全体学生
+#define RANK_SCOPE_MAJOR 1  // 同一专业
+#define RANK_SCOPE_CLASS 2  // 同一班级
+#define RANK_NIL -1
+
+// 成绩分布直方图的格数：0.00 ~ 100.00 分每百分之一分一格，分位数可以精确求出
+// 每100格另记一个小计，求分位数时先按小计跳过整段，只需访问约200个计数
+#define HISTOGRAM_BINS   10001
+#define HISTOGRAM_BLOCK  100
+#define HISTOGRAM_BLOCKS ((HISTOGRAM_BINS + HISTOGRAM_BLOCK - 1) / HISTOGRAM_BLOCK)
+
+// 成绩分布：按课程位置保存每个分数的人数，建立后随增删改维护，查询时不必再扫描学生
+typedef struct {
+    int **counts;           // counts[j][h]：第 j 门成绩为 h/100 分的人数，其后是 HISTOGRAM_BLOCKS 个小计（未分配的课程为NULL）
+    int *totals;            // totals[j]：第 j 门有成绩的人数
+    int courseCount;        // 已分配的课程数
+    int built;              // 是否已建立（首次查询时建立）
+} ScoreHistogram;
+
+// 字符串字典：班级、院系、专业等重复文本只保存一份，学生记录中保存编号
+typedef struct {
+    char **strings;               // 编号 -> 字符串
+    unsigned int *hashes;         // 编号 -> 字符串哈希
+    int count;
+    int capacity;
+    int *slots;                   // 开放寻址哈希表，保存编号（-1 为空槽）
+    int slotCapacity;             // 槽位数（2的幂）
+    size_t textBytes;             // 字符串总字节数（含结尾'\0'）
+} StringDict;
+
+// 倒排列表：某个字段值对应的学生下标（升序）
+typedef struct {
+    int *items;                   // 学生下标
+    int count;
+    int capacity;
+} PostingList;
+
+// 倒排索引：字段值编号 -> 倒排列表
+typedef struct {
+    PostingList *lists;           // 按字段值在字典中的编号直接下标访问
+    int capacity;
+} PostingIndex;
+
+// 列式镜像：按列连续存放学生的分析字段，第 i 行对应第 i 名学生
+// 只在需要整列扫描时按需重建，增删改学生后标记失效
+typedef struct {
+    int valid;                    // 为0时需要重建
+    int count;                    // 行数
+    int capacity;                 // 各列已分配的行数
+    char (*ids)[20];              // 学号
+    float *totals;                // 成绩总和
+    int *classIds;                // 班级（字典编号）
+    int *departmentIds;           // 院系（字典编号）
+    int *majorIds;                // 专业（字典编号）
+    float **scoreColumns;         // 第 j 门成绩，没有该门成绩时为 COLUMN_SCORE_MISSING
+    int scoreColumnCount;
+    int scoreColumnCapacity;
+} StudentColumns;
+
+#define COLUMN_SCORE_MISSING -1.0f
+
+// 及格线
+#define PASS_SCORE 60.0f
+
+// 一门课程的统计结果（只计有该门成绩的学生）
+typedef struct {
+    int count;                    // 有成绩的人数
+    int passCount;                // 及格人数
+    float min;                    // 最低分（没有成绩时为0）
+    float max;                    // 最高分（没有成绩时为0）
+    double sum;                   // 成绩总和
+    double sumSquares;            // 成绩平方和（计算方差用）
+} CourseStats;
+
+// 姓名字元索引每个姓名（或查询文本）最多拆分的字数
+#define NAME_GRAM_MAX 32
+
+// 拼音检索键（全拼或首字母）的最大长度
+#define PINYIN_KEY_SIZE 128
+
+// 一个拼音音节及读该音的汉字
+typedef struct {
+    const char *syllable;         // 音节（小写、不带声调，ü 写作 v）
+    const char *chars;            // 读该音的汉字（UTF-8）
+} PinyinSyllable;
+
+// 拼音查找表项
+typedef struct {
+    unsigned int codepoint;       // 汉字码位
+    unsigned short syllable;      // 在 pinyinSyllables 中的下标
+} PinyinEntry;
+
+// 拼音键排序用的临时项
+typedef struct {
+    const char *key;              // 键文本
+    int id;                       // 键编号
+} PinyinOrderItem;
+
+// 按姓名复用的姓名索引键（批量建索引时使用，同名学生只拆分字元、转换拼音一次）
 typedef struct {
-    Student *students;      // 学生数组
-    int capacity;           // 容量
+    int *start;                   // 整名键编号 -> keys 中该姓名的起始位置，-1 为尚未记录
+    int startCapacity;
+    int *keys;                    // 每个姓名依次存放：字元键个数、字元键……、拼音键个数、拼音键……
+    int keyCount;
+    int keyCapacity;
+} NameKeyCache;
+
+// 学生分块存储参数：每块固定容量，扩容只追加新块，已有学生的地址保持不变
+#define STUDENT_CHUNK_SHIFT 12
+#define STUDENT_CHUNK_SIZE  (1 << STUDENT_CHUNK_SHIFT)
+#define STUDENT_CHUNK_MASK  (STUDENT_CHUNK_SIZE - 1)
+
+// 逐个删除留下的空位超过学生总数的 1/DELETE_COMPACT_RATIO 时压缩一次
+#define DELETE_COMPACT_RATIO 8
+
+// 学生信息管理系统结构体
+typedef struct StudentManagerTag {
+    Student **studentChunks; // 学生分块数组（每块 STUDENT_CHUNK_SIZE 个学生）
+    int chunkCount;          // 已分配块数
+    int chunkCapacity;       // 块指针数组容量
+    int capacity;            // 容量（已分配块可容纳的学生数）
     int count;              // 当前学生数量
+    IdIndexSlot *idIndex;   // 学号哈希索引（开放寻址，线性探测）
+    int idIndexCapacity;    // 哈希索引槽位数（2的幂）
+    int idIndexUsed;        // 已占用槽位数（含删除标记）
+    IdOrderIndex idOrder;   // 学号有序索引（前缀与范围查询）
+    RankTree rankAll;       // 全体学生的总分排行
+    RankTree *majorRanks;   // 各专业的总分排行（按专业编号下标访问）
+    int majorRankCapacity;
+    RankTree *classRanks;   // 各班级的总分排行（按班级编号下标访问）
+    int classRankCapacity;
+    ScoreHistogram histogramAll;        // 全体学生的成绩分布
+    ScoreHistogram *majorHistograms;    // 各专业的成绩分布（按专业编号下标访问）
+    int majorHistogramCapacity;
     char **scoreNames;      // 成绩名预设数组
     int scoreNameCount;     // 成绩名预设数量
     int scoreNameCapacity;  // 成绩名预设容量
@@ -53,11 +542,324 @@ typedef struct {
     char **majorNames;      // 专业预设数组
     int majorCount;         // 专业预设数量
     int majorCapacity;      // 专业预设容量
+    StringDict strings;     // 班级、院系、专业名称字典
+    PostingIndex majorIndex;      // 专业倒排索引
+    PostingIndex departmentIndex; // 院系倒排索引
+    PostingIndex classIndex;      // 班级倒排索引
+    StringDict nameGrams;         // 姓名字元（单字及相邻两字）字典
+    PostingIndex nameIndex;       // 姓名字元倒排索引
+    StringDict pinyinKeys;        // 姓名拼音检索键（全拼、首字母）字典
+    PostingIndex pinyinIndex;     // 拼音检索键倒排索引
+    int *pinyinOrder;             // 按文本排序的拼音检索键编号（前缀查找用）
+    int pinyinOrderCount;
+    int pinyinOrderCapacity;
+    int pinyinOrderSortedCount;   // pinyinOrder 前这么多个已排序，其后是新追加的键，查找前排序并归并
+    StudentColumns columns;       // 列式镜像（按需重建）
+    ScorePool scorePool;          // 全部学生的成绩数组
+    Journal *journal;       // 操作日志（NULL 表示不记录）
+    unsigned int snapshotGeneration; // 启动时加载的快照所含的日志代数（日志未能开启时据此合并）
+    int browseCursor;       // 分页浏览全部学生时的光标位置（下次进入时恢复）
+    int *deletedSlots;      // 已标记删除、等待压缩的学生下标（压缩前学生仍占着原位置）
+    int deletedCount;
+    int deletedCapacity;
 } StudentManager;
 
+// 是否输出颜色控制码（仅在标准输出为终端时开启）
+int useColor = 1;
+
+// 成绩存储模式：0 为 float，1 为16位定点（百分之一分）。只能在启动时、载入任何学生之前设置
+int fixedScoreMode = 0;
+
+// 整屏输出缓冲区（列表类界面先格式化到这里，再一次性写出）
+OutputBuffer screenBuffer = {NULL, 0, 0, 1, 0};
+
+// 数据文件锁的句柄（见 lockDataFiles），进程退出时由系统释放
+#ifdef _WIN32
+HANDLE dataLock = INVALID_HANDLE_VALUE;
+#else
+int dataLock = -1;
+#endif
+
 // 函数声明
 StudentManager *initManager(int capacity);
 void freeManager(StudentManager *manager);
+void freeStudentChunks(StudentManager *manager);
+// 学生分块存储相关函数
+Student *getStudent(StudentManager *manager, int index);
+int growStudentStore(StudentManager *manager);
+int appendStudent(StudentManager *manager, const Student *student);
+int buildStudentIndexes(StudentManager *manager);
+void makeSyntheticStudent(StudentManager *manager, Student *student, int seq);
+int addSyntheticStudents(StudentManager *manager, int first, int count, const int *order,
+                         int scoreCount, int randomNames, unsigned int *seed);
+long getPeakRssKb();
+void stressTestStore(int total);
+// 学号哈希索引相关函数
+unsigned int hashId(const char *id);
+int idIndexRebuild(StudentManager *manager, int slotCapacity);
+int idIndexInsert(StudentManager *manager, int index);
+int idIndexFindSlot(StudentManager *manager, const char *id);
+int idIndexFind(StudentManager *manager, const char *id);
+void idIndexRemove(StudentManager *manager, const char *id);
+void idIndexUpdate(StudentManager *manager, const char *id, int newIndex);
+int idOrderAdd(StudentManager *manager, int index);
+int idOrderLowerBound(StudentManager *manager, const int *items, int count, const char *id);
+void idOrderRemap(StudentManager *manager, const int *remap);
+int compareIdOrderItems(const void *a, const void *b);
+int idOrderPrepare(StudentManager *manager);
+int *idOrderScan(StudentManager *manager, const char *low, const char *high, size_t prefixLength, int *count);
+int *findStudentsByIdPrefix(StudentManager *manager, const char *prefix, int *count);
+int *findStudentsByIdRange(StudentManager *manager, const char *low, const char *high, int *count);
+void idOrderFree(IdOrderIndex *order);
+unsigned int rankPriority(int node);
+int rankBefore(const RankNode *node, int key, int index);
+int rankSize(const RankTree *tree, int node);
+void rankUpdate(RankTree *tree, int node);
+void rankSplit(RankTree *tree, int node, int key, int index, int *left, int *right);
+int rankMerge(RankTree *tree, int left, int right);
+int rankInsert(RankTree *tree, int key, int index);
+void rankErase(RankTree *tree, int key, int index);
+int rankCountBefore(const RankTree *tree, int key, int index);
+void rankCollect(const RankTree *tree, int node, int *result, int *count, int limit);
+void rankRemap(RankTree *tree, const int *remap);
+void rankFree(RankTree *tree);
+int rankKey(const Student *student);
+RankTree *rankScopeTree(StudentManager *manager, int scope, int id, int create);
+int compareRankNodes(const void *a, const void *b);
+int rankFixSizes(RankTree *tree, int node);
+RankTree *rankTreeFor(StudentManager *manager, int scope, int id);
+void rankIndexStudent(StudentManager *manager, int index);
+void rankUnindexStudent(StudentManager *manager, int index);
+void rankRemapAll(StudentManager *manager, const int *remap);
+int *rankTopStudents(StudentManager *manager, int scope, int id, int limit, int *count);
+int rankOfStudent(StudentManager *manager, int scope, int id, int index, int *rank, int *total, double *percentile);
+void rankFreeAll(StudentManager *manager);
+void histogramFree(ScoreHistogram *histogram);
+int histogramAddStudent(ScoreHistogram *histogram, const Student *student, int delta);
+ScoreHistogram *histogramFor(StudentManager *manager, int majorId);
+void histogramIndexStudent(StudentManager *manager, int index, int delta);
+int histogramQuantile(const ScoreHistogram *histogram, int j, double q);
+void histogramBuckets(const ScoreHistogram *histogram, int j, int buckets[10]);
+void histogramFreeAll(StudentManager *manager);
+void indexStudentScores(StudentManager *manager, int index);
+void unindexStudentScores(StudentManager *manager, int index);
+void benchmarkIdIndex(int maxCount);
+void makeRandomChineseName(char *name, unsigned int *seed);
+void benchmarkNameIndex(int count);
+void benchmarkPinyinIndex(int count);
+void benchmarkIdOrder(int count);
+void benchmarkRank(int count);
+void benchmarkCourseStats(int count);
+void benchmarkDistribution(int count);
+void benchmarkGraduation(int count);
+void benchmarkMergeScores(int count);
+void benchmarkColumns(int count);
+void benchmarkScorePool(int count);
+void benchmarkInlineScores(int count);
+// 专业、院系、班级倒排索引相关函数
+int dictLookup(const StringDict *dict, const char *text);
+int dictIntern(StringDict *dict, const char *text);
+const char *dictString(const StringDict *dict, int id);
+size_t dictMemoryBytes(const StringDict *dict);
+void dictFree(StringDict *dict);
+PostingList *postingFind(PostingIndex *postings, int key);
+PostingList *postingGet(PostingIndex *postings, int key);
+int postingLowerBound(const PostingList *list, int studentIndex);
+int postingAdd(PostingIndex *postings, int key, int studentIndex);
+void postingRemove(PostingIndex *postings, int key, int studentIndex);
+void postingRemap(PostingIndex *postings, const int *remap, int first);
+void postingFree(PostingIndex *postings);
+void indexStudent(StudentManager *manager, int index);
+void unindexStudent(StudentManager *manager, int index);
+int gallopLowerBound(const int *items, int from, int count, int value);
+int intersectPostings(const PostingList **lists, int listCount, int *result);
+int *filterStudents(StudentManager *manager, const char *major, const char *department, const char *className, int *count);
+int utf8CharLength(const char *text);
+int nameGramKeys(StringDict *grams, const char *name, int *keys, int intern, int onlyLongest);
+int nameExactKey(StringDict *grams, const char *name, int intern);
+void indexStudentName(StudentManager *manager, int index);
+void indexStudentNameCached(StudentManager *manager, int index, NameKeyCache *cache);
+void unindexStudentName(StudentManager *manager, int index);
+int *findStudentsByName(StudentManager *manager, const char *name, int *count);
+// 拼音索引相关函数
+unsigned int utf8Decode(const char *text, int *length);
+int comparePinyinEntries(const void *a, const void *b);
+int initPinyinTable();
+const char *pinyinOf(unsigned int codepoint);
+void namePinyinKeys(const char *name, char *full, size_t fullSize, char *initials, size_t initialsSize);
+int pinyinLowerBound(StudentManager *manager, const char *text);
+int comparePinyinOrderItems(const void *a, const void *b);
+int pinyinOrderPrepare(StudentManager *manager);
+int pinyinIndexAdd(StudentManager *manager, const char *key, int index);
+void indexStudentPinyin(StudentManager *manager, int index);
+void unindexStudentPinyin(StudentManager *manager, int index);
+int compareIndexes(const void *a, const void *b);
+int *findStudentsByPinyin(StudentManager *manager, const char *prefix, int *count);
+// 列式镜像相关函数
+void invalidateColumns(StudentManager *manager);
+StudentColumns *getColumns(StudentManager *manager);
+void freeColumns(StudentColumns *columns);
+void courseStatsScalar(const float *scores, int n, CourseStats *stats);
+void courseStatsMerge(CourseStats *stats, const CourseStats *tail);
+#ifdef HAVE_SSE2
+void courseStatsSse2(const float *scores, int n, CourseStats *stats);
+#endif
+#ifdef HAVE_AVX2_TARGET
+void courseStatsAvx2(const float *scores, int n, CourseStats *stats);
+#endif
+int courseStatsSimdLevel();
+void courseStatsCompute(const float *scores, int n, CourseStats *stats);
+double courseMean(const CourseStats *stats);
+double courseVariance(const CourseStats *stats);
+CourseStats *computeCourseStats(StudentManager *manager, const int *indexes, int count, int *courses);
+const char *courseName(StudentManager *manager, int j, char *buffer, size_t size);
+// 成绩池相关函数
+int scoreSizeClass(int count);
+float *scorePoolAlloc(ScorePool *pool, int count);
+void scorePoolFree(ScorePool *pool, float *scores, int count);
+float *scorePoolRealloc(ScorePool *pool, float *scores, int oldCount, int newCount);
+void scorePoolRelease(ScorePool *pool);
+void reportScorePool(const ScorePool *pool);
+int inlineScoreCapacity();
+int scorePoolSlots(int count);
+int scoreToHundredths(float score);
+float studentScore(const Student *student, int i);
+double studentTotal(const Student *student);
+int setStudentScores(ScorePool *pool, Student *student, const float *scores, int count);
+void copyStudentScores(const Student *student, float *scores);
+int setStudentScoreAt(ScorePool *pool, Student *student, int j, float score);
+void releaseStudentScores(ScorePool *pool, Student *student);
+// 数据快照相关函数
+unsigned int snapshotChecksum(const unsigned char *data, size_t size);
+int mapFile(const char *path, MappedFile *mapped);
+void unmapFile(MappedFile *mapped);
+int pushPresetName(char ***names, int *count, int *capacity, const char *name);
+void studentToRecord(StudentManager *manager, const Student *student, SnapshotStudent *record);
+int recordToStudent(StudentManager *manager, const SnapshotStudent *record, const float *scores,
+                    const int *nameIds, Student *student);
+size_t snapshotPut(unsigned char *out, size_t used, const void *data, size_t size);
+size_t snapshotPutUint(unsigned char *out, size_t used, unsigned int value);
+size_t snapshotPutDict(unsigned char *out, size_t used, const StringDict *dict);
+size_t snapshotPutPostings(unsigned char *out, size_t used, const PostingIndex *postings);
+size_t serializeSnapshotIndexes(StudentManager *manager, unsigned char *out);
+const unsigned char *snapshotTake(SnapshotReader *reader, size_t size);
+int snapshotTakeUint(SnapshotReader *reader, unsigned int *value);
+int snapshotTakeInts(SnapshotReader *reader, unsigned int count, int low, int high, int **items);
+int snapshotTakeDict(SnapshotReader *reader, StringDict *dict);
+int snapshotTakePostings(SnapshotReader *reader, PostingIndex *postings, int keyCount, int studentCount);
+int loadSnapshotIndexes(StudentManager *manager, SnapshotReader *reader);
+void clearStudentIndexes(StudentManager *manager);
+unsigned char *serializeSnapshot(StudentManager *manager, unsigned int journalGeneration, size_t *size);
+int syncFile(FILE *file);
+int writeSnapshotFile(const char *path, const unsigned char *data, size_t size);
+int saveSnapshot(StudentManager *manager, const char *path);
+int loadSnapshot(StudentManager *manager, const char *path, unsigned int *journalGeneration);
+// 操作日志相关函数
+long long currentTimeMs();
+double currentTimeUs();
+int startThread(SimsThread *thread, void *(*func)(void *), void *arg);
+void joinThread(SimsThread thread);
+Journal *journalOpen(const char *path, unsigned int generation);
+int journalCommit(Journal *journal, int forceSync);
+int journalAppend(Journal *journal, unsigned char type, const void *payload, unsigned int length);
+int journalWaitCompaction(Journal *journal);
+void journalClose(Journal *journal);
+unsigned int journalStudentPayload(StudentManager *manager, const Student *student, unsigned char *payload);
+void journalRecordStudent(StudentManager *manager, unsigned char type, const Student *student);
+void journalRecordDelete(StudentManager *manager, const char *id);
+void journalRecordPreset(StudentManager *manager, int list, const char *name);
+int markStudentDeleted(StudentManager *manager, int index);
+void unlinkStudentPostings(StudentManager *manager, int index);
+int compactStudents(StudentManager *manager);
+int compactOrUnlinkDeleted(StudentManager *manager);
+int compactStudentsIfNeeded(StudentManager *manager);
+int liveStudentCount(StudentManager *manager);
+int checkStudentIndexes(StudentManager *manager);
+int removeStudentAt(StudentManager *manager, int index);
+int bulkDeleteStudents(StudentManager *manager, const int *indexes, int count);
+int bulkMoveMajor(StudentManager *manager, int fromMajorId, int toMajorId);
+int bulkAddScore(StudentManager *manager, const int *indexes, int count, int course, float delta);
+int findCourse(StudentManager *manager, const char *text);
+void applyJournalRecord(StudentManager *manager, unsigned char type, const unsigned char *payload, unsigned int length);
+int replayJournal(StudentManager *manager, const char *path, unsigned int minGeneration);
+int compactJournal(StudentManager *manager);
+void compactJournalIfNeeded(StudentManager *manager);
+int replayJournals(StudentManager *manager, unsigned int generation);
+int foldJournals(StudentManager *manager, unsigned int generation);
+int recoverManager(StudentManager *manager, int *snapshotResult);
+int recoverManagerReadOnly(StudentManager *manager, int *snapshotResult);
+int saveBulkChanges(StudentManager *manager);
+int lockDataFiles();
+void unlockDataFiles();
+// 批量导入相关函数
+int splitFields(char *line, char delimiter, char **fields, int maxFields);
+int parseScoreText(const char *text, float *score);
+const char *parseImportRow(StudentManager *manager, ScorePool *pool, char **fields, int fieldCount, Student *student);
+int internImportFields(StudentManager *manager, Student *student, char **fields);
+void reportRejectedRow(FILE *report, long long line, const char *reason, const char *id);
+int readFileLines(FILE *file, const LineReader *reader, FILE *report, ImportStats *stats);
+void importFirstLine(void *context, const char *line);
+void importRow(void *context, char *line, long long lineNumber);
+int importStudents(StudentManager *manager, const char *path, const char *reportPath, ImportStats *stats);
+int getCpuCount();
+void addShardRejection(ImportShard *shard, long long line, const char *reason, const char *id);
+void *importShardWorker(void *arg);
+int compareRejections(const void *a, const void *b);
+int importStudentsParallel(StudentManager *manager, const char *path, const char *reportPath,
+                           int threadCount, ImportStats *stats);
+void mergeCourseRow(void *context, char *line, long long lineNumber);
+int mergeCourseFile(StudentManager *manager, FILE *file, int course, FILE *report, ImportStats *stats);
+int mergeCourseScores(StudentManager *manager, const char *path, int course, const char *reportPath, ImportStats *stats);
+// 缓冲渲染相关函数
+void outputReserve(OutputBuffer *out, size_t extra);
+void outputAppend(OutputBuffer *out, const char *text, size_t length);
+void outputString(OutputBuffer *out, const char *text);
+void outputColor(OutputBuffer *out, const char *color);
+void outputInt(OutputBuffer *out, long long value);
+int formatFixed2(char *text, size_t size, double value);
+void outputFixed2(OutputBuffer *out, double value);
+int utf8DisplayWidth(const char *text);
+void outputPadded(OutputBuffer *out, const char *text, int width);
+void outputFlush(OutputBuffer *out);
+void renderStudentDetail(OutputBuffer *out, StudentManager *manager, const Student *student, int seq);
+void renderTableHeader(OutputBuffer *out);
+void renderStudentRow(OutputBuffer *out, StudentManager *manager, const Student *student, int seq);
+void benchmarkRender(int count);
+int findListPosition(const int *indexes, int total, int index);
+void browseStudents(StudentManager *manager, const int *indexes, int total, const char *title);
+// 批处理模式相关函数
+void printStudentLine(FILE *out, StudentManager *manager, const Student *student);
+void reportStudentMemory(StudentManager *manager);
+void benchmarkStringDict(int count);
+void writeCsvField(FILE *out, const char *text);
+void outputCsvField(OutputBuffer *out, const char *text);
+void outputJsonString(OutputBuffer *out, const char *text);
+void outputScore(OutputBuffer *out, float score);
+void exportHeader(OutputBuffer *out, StudentManager *manager, int format, int scoreColumns);
+int exportRowMatches(const Student *student, const int *ids);
+int exportReserveKeys(StudentManager *manager, char ***keys, int *keyCount, int count);
+void exportStudentRow(OutputBuffer *out, StudentManager *manager, const Student *student, char **courseKeys);
+long long exportStudents(StudentManager *manager, OutputBuffer *out, int format,
+                         const char *major, const char *department, const char *className);
+void benchmarkExport(int count);
+int selfTestCheck(int condition, const char *message, int *failures);
+int selfTestRankMismatches(StudentManager *manager);
+int selfTestQuantileMismatches(StudentManager *manager);
+void selfTestIndexes(int *failures);
+int runSelfTest();
+void printBatchUsage();
+int batchImport(StudentManager *manager, int argc, char *argv[]);
+int batchQuery(StudentManager *manager, int argc, char *argv[]);
+int batchExport(StudentManager *manager, int argc, char *argv[]);
+int batchList(StudentManager *manager, int argc, char *argv[]);
+int batchRank(StudentManager *manager, int argc, char *argv[]);
+int batchCourses(StudentManager *manager, int argc, char *argv[]);
+int batchDistribution(StudentManager *manager, int argc, char *argv[]);
+int batchBulk(StudentManager *manager, int argc, char *argv[]);
+int batchMergeScores(StudentManager *manager, int argc, char *argv[]);
+int batchPreset(StudentManager *manager, int argc, char *argv[]);
+int batchStats(StudentManager *manager);
+int runBatch(int argc, char *argv[]);
 char getKey();
 void clearScreen();
 void setColor(const char *color);
@@ -65,14 +867,22 @@ void showMenu();
 void showSoftwareInfo();
 void showInstructions();
 void showDeveloperMessage();
+float *inputScores(StudentManager *manager, int *count);
 int addStudent(StudentManager *manager);
 int findStudentByName(StudentManager *manager, const char *name);
 int findStudentById(StudentManager *manager, const char *id);
-void displayStudent(const Student *student);
+void displayStudent(StudentManager *manager, const Student *student);
+int showSearchMatches(StudentManager *manager, int *matches, int count, const char *title);
 void searchStudents(StudentManager *manager);
+void showLeaderboard(StudentManager *manager);
+void showCourseStats(StudentManager *manager);
+void printScoreDistribution(const ScoreHistogram *histogram, int j, const char *name, const char *indent);
+void showScoreDistribution(StudentManager *manager);
+void bulkOperations(StudentManager *manager);
 void modifyStudent(StudentManager *manager);
 void deleteStudent(StudentManager *manager);
 void displayAllStudents(StudentManager *manager);
+void filterStudentsMenu(StudentManager *manager);
 int isValidScore(float score);
 int isValidGender(const char *gender);
 int isValidId(const char *id);
@@ -104,21 +914,59 @@ StudentManager *initManager(int capacity) {
         return NULL;
     }
     
-    manager->students = (Student *)malloc(sizeof(Student) * capacity);
-    if (manager->students == NULL) {
-        free(manager);
-        printf("内存分配失败！\n");
-        return NULL;
-    }
-    
-    manager->capacity = capacity;
+    // 预先分配足以容纳初始容量的学生块，之后按需追加
+    manager->studentChunks = NULL;
+    manager->chunkCount = 0;
+    manager->chunkCapacity = 0;
+    manager->capacity = 0;
     manager->count = 0;
+    manager->journal = NULL;
+    manager->snapshotGeneration = 0;
+    manager->browseCursor = 0;
+    manager->deletedSlots = NULL;
+    manager->deletedCount = 0;
+    manager->deletedCapacity = 0;
+    memset(&manager->strings, 0, sizeof(StringDict));
+    memset(&manager->columns, 0, sizeof(StudentColumns));
+    memset(&manager->scorePool, 0, sizeof(ScorePool));
+    memset(&manager->majorIndex, 0, sizeof(PostingIndex));
+    memset(&manager->departmentIndex, 0, sizeof(PostingIndex));
+    memset(&manager->classIndex, 0, sizeof(PostingIndex));
+    memset(&manager->idOrder, 0, sizeof(IdOrderIndex));
+    memset(&manager->rankAll, 0, sizeof(RankTree));
+    manager->majorRanks = NULL;
+    manager->majorRankCapacity = 0;
+    manager->classRanks = NULL;
+    manager->classRankCapacity = 0;
+    memset(&manager->histogramAll, 0, sizeof(ScoreHistogram));
+    manager->majorHistograms = NULL;
+    manager->majorHistogramCapacity = 0;
+    memset(&manager->nameGrams, 0, sizeof(StringDict));
+    memset(&manager->nameIndex, 0, sizeof(PostingIndex));
+    memset(&manager->pinyinKeys, 0, sizeof(StringDict));
+    memset(&manager->pinyinIndex, 0, sizeof(PostingIndex));
+    manager->pinyinOrder = NULL;
+    manager->pinyinOrderCount = 0;
+    manager->pinyinOrderCapacity = 0;
+    manager->pinyinOrderSortedCount = 0;
+    initPinyinTable();
+    do {
+        if (!growStudentStore(manager)) {
+            for (int i = 0; i < manager->chunkCount; i++) {
+                free(manager->studentChunks[i]);
+            }
+            free(manager->studentChunks);
+            free(manager);
+            printf("内存分配失败！\n");
+            return NULL;
+        }
+    } while (manager->capacity < capacity);
     
     // 初始化成绩名预设
     int scoreNameInitCapacity = 5;
     manager->scoreNames = (char **)malloc(sizeof(char *) * scoreNameInitCapacity);
     if (manager->scoreNames == NULL) {
-        free(manager->students);
+        freeStudentChunks(manager);
         free(manager);
         printf("内存分配失败！\n");
         return NULL;
@@ -131,7 +979,7 @@ StudentManager *initManager(int capacity) {
     manager->departmentNames = (char **)malloc(sizeof(char *) * departmentInitCapacity);
     if (manager->departmentNames == NULL) {
         free(manager->scoreNames);
-        free(manager->students);
+        freeStudentChunks(manager);
         free(manager);
         printf("内存分配失败！\n");
         return NULL;
@@ -145,7 +993,7 @@ StudentManager *initManager(int capacity) {
     if (manager->majorNames == NULL) {
         free(manager->departmentNames);
         free(manager->scoreNames);
-        free(manager->students);
+        freeStudentChunks(manager);
         free(manager);
         printf("内存分配失败！\n");
         return NULL;
@@ -153,22 +1001,37 @@ StudentManager *initManager(int capacity) {
     manager->majorCapacity = majorInitCapacity;
     manager->majorCount = 0;
     
+    // 初始化学号哈希索引（槽位数保持为容量的两倍以上，负载因子不超过0.5）
+    manager->idIndex = NULL;
+    manager->idIndexCapacity = 0;
+    manager->idIndexUsed = 0;
+    int slotCapacity = 16;
+    while (slotCapacity < capacity * 2) {
+        slotCapacity *= 2;
+    }
+    if (!idIndexRebuild(manager, slotCapacity)) {
+        free(manager->majorNames);
+        free(manager->departmentNames);
+        free(manager->scoreNames);
+        freeStudentChunks(manager);
+        free(manager);
+        printf("内存分配失败！\n");
+        return NULL;
+    }
+    
     return manager;
 }
 
 // 释放学生管理器
 void freeManager(StudentManager *manager) {
     if (manager != NULL) {
-        if (manager->students != NULL) {
-            // 释放每个学生的成绩数组
-            for (int i = 0; i < manager->count; i++) {
-                if (manager->students[i].scores != NULL) {
-                    free(manager->students[i].scores);
-                }
-            }
-            free(manager->students);
+        if (manager->studentChunks != NULL) {
+            freeStudentChunks(manager);
         }
         
+        // 成绩数组全部来自成绩池，整体释放
+        scorePoolRelease(&manager->scorePool);
+        
         // 释放成绩名预设数组
         if (manager->scoreNames != NULL) {
             for (int i = 0; i < manager->scoreNameCount; i++) {
@@ -199,445 +1062,8288 @@ void freeManager(StudentManager *manager) {
             free(manager->majorNames);
         }
         
+        // 释放学号哈希索引
+        if (manager->idIndex != NULL) {
+            free(manager->idIndex);
+        }
+        
+        // 释放倒排索引
+        postingFree(&manager->majorIndex);
+        postingFree(&manager->departmentIndex);
+        postingFree(&manager->classIndex);
+        postingFree(&manager->nameIndex);
+        dictFree(&manager->nameGrams);
+        postingFree(&manager->pinyinIndex);
+        dictFree(&manager->pinyinKeys);
+        free(manager->pinyinOrder);
+        idOrderFree(&manager->idOrder);
+        rankFreeAll(manager);
+        histogramFreeAll(manager);
+        free(manager->deletedSlots);
+        dictFree(&manager->strings);
+        freeColumns(&manager->columns);
+        
+        // 关闭操作日志
+        journalClose(manager->journal);
+        
         free(manager);
     }
 }
 
-// 显示院系列表
-void displayDepartments(StudentManager *manager) {
-    setColor(COLOR_YELLOW);
-    if (manager->departmentCount == 0) {
-        printf("\t\t当前没有预设的院系！\n");
-    } else {
-        printf("\t\t当前预设的院系列表：\n");
-        for (int i = 0; i < manager->departmentCount; i++) {
-            printf("\t\t%d. %s\n", i + 1, manager->departmentNames[i]);
+// 释放所有学生块
+void freeStudentChunks(StudentManager *manager) {
+    for (int i = 0; i < manager->chunkCount; i++) {
+        free(manager->studentChunks[i]);
+    }
+    free(manager->studentChunks);
+    manager->studentChunks = NULL;
+    manager->chunkCount = 0;
+    manager->chunkCapacity = 0;
+    manager->capacity = 0;
+}
+
+// 获取下标为 index 的学生
+Student *getStudent(StudentManager *manager, int index) {
+    return &manager->studentChunks[index >> STUDENT_CHUNK_SHIFT][index & STUDENT_CHUNK_MASK];
+}
+
+// 追加一个学生块（块指针数组按倍数扩容，学生本身不移动）
+int growStudentStore(StudentManager *manager) {
+    if (manager->chunkCount >= manager->chunkCapacity) {
+        int newCapacity = manager->chunkCapacity == 0 ? 8 : manager->chunkCapacity * 2;
+        Student **newChunks = (Student **)realloc(manager->studentChunks, sizeof(Student *) * newCapacity);
+        if (newChunks == NULL) {
+            return 0;
         }
+        manager->studentChunks = newChunks;
+        manager->chunkCapacity = newCapacity;
     }
-    setColor(COLOR_RESET);
+    
+    Student *chunk = (Student *)malloc(sizeof(Student) * STUDENT_CHUNK_SIZE);
+    if (chunk == NULL) {
+        return 0;
+    }
+    manager->studentChunks[manager->chunkCount++] = chunk;
+    manager->capacity += STUDENT_CHUNK_SIZE;
+    return 1;
 }
 
-// 添加院系
-void addDepartment(StudentManager *manager, const char *name) {
-    // 检查院系是否已存在
-    for (int i = 0; i < manager->departmentCount; i++) {
-        if (strcmp(manager->departmentNames[i], name) == 0) {
-            setColor(COLOR_RED);
-            printf("\t\t院系 '%s' 已存在！\n", name);
-            setColor(COLOR_RESET);
-            return;
+// 追加学生记录并加入学号索引（哈希与有序索引），成功返回新学生下标，失败返回-1
+int appendStudent(StudentManager *manager, const Student *student) {
+    if (manager->count >= manager->capacity && !growStudentStore(manager)) {
+        return -1;
+    }
+    
+    int index = manager->count;
+    *getStudent(manager, index) = *student;
+    getStudent(manager, index)->deleted = 0;
+    if (!idIndexInsert(manager, index)) {
+        return -1;
+    }
+    if (!idOrderAdd(manager, index)) {
+        idIndexRemove(manager, student->id);
+        return -1;
+    }
+    indexStudent(manager, index);
+    invalidateColumns(manager);
+    manager->count++;
+    return index;
+}
+
+// 为已拷入存储、尚未建索引的全部学生一次性建立索引（向刚初始化的管理器载入快照时使用）
+// 学号哈希按最终人数只重建一次，重建时顺带查重，不再逐条查找、逐条插入、随人数增长反复扩容；
+// 学号有序索引一次预留后整体追加；倒排、姓名与拼音索引按下标顺序追加，每个列表只在末尾写入，
+// 同名学生的姓名键只计算一次（见 indexStudentNameCached）。
+// 学号重复的学生保留先出现的（正常保存的快照不会出现）。内存不足返回0，此时学号索引已清空，调用者应放弃这批学生
+int buildStudentIndexes(StudentManager *manager) {
+    IdOrderIndex *order = &manager->idOrder;
+    if (manager->count > order->deltaCapacity) {
+        int *newDelta = (int *)realloc(order->delta, sizeof(int) * (size_t)manager->count);
+        if (newDelta == NULL) {
+            return 0;
         }
+        order->delta = newDelta;
+        order->deltaCapacity = manager->count;
+    }
+    // 与 initManager 相同，槽位数保持为人数的两倍以上
+    int slotCapacity = manager->idIndexCapacity;
+    while (slotCapacity < manager->count * 2) {
+        slotCapacity *= 2;
+    }
+    if (!idIndexRebuild(manager, slotCapacity)) {
+        return 0;
     }
     
-    // 检查是否需要扩容
-    if (manager->departmentCount >= manager->departmentCapacity) {
-        int newCapacity = manager->departmentCapacity * 2;
-        char **newDepartmentNames = (char **)realloc(manager->departmentNames, sizeof(char *) * newCapacity);
-        if (newDepartmentNames == NULL) {
-            setColor(COLOR_RED);
-            printf("\t\t内存分配失败，无法添加新院系！\n");
-            setColor(COLOR_RESET);
-            return;
+    // 重建时跳过的就是学号重复的后来者：找出来去掉，再按新下标重建一次
+    if (manager->idIndexUsed < manager->count) {
+        for (int i = 0; i < manager->count; i++) {
+            if (findStudentById(manager, getStudent(manager, i)->id) != i) {
+                getStudent(manager, i)->deleted = 1;
+            }
+        }
+        int kept = 0;
+        for (int i = 0; i < manager->count; i++) {
+            Student *student = getStudent(manager, i);
+            if (student->deleted) {
+                releaseStudentScores(&manager->scorePool, student);
+                continue;
+            }
+            *getStudent(manager, kept++) = *student;
+        }
+        manager->count = kept;
+        if (!idIndexRebuild(manager, slotCapacity)) {
+            for (int i = 0; i < manager->idIndexCapacity; i++) {
+                manager->idIndex[i].index = ID_INDEX_EMPTY;
+            }
+            manager->idIndexUsed = 0;
+            return 0;
         }
-        manager->departmentNames = newDepartmentNames;
-        manager->departmentCapacity = newCapacity;
     }
     
-    // 添加新院系
-    manager->departmentNames[manager->departmentCount] = (char *)malloc(sizeof(char) * (strlen(name) + 1));
-    if (manager->departmentNames[manager->departmentCount] == NULL) {
-        setColor(COLOR_RED);
-        printf("\t\t内存分配失败，无法添加新院系！\n");
-        setColor(COLOR_RESET);
-        return;
+    order->deltaCount = 0;
+    order->deltaSorted = 1;
+    for (int i = 0; i < manager->count; i++) {
+        if (i > 0 && strcmp(getStudent(manager, i - 1)->id, getStudent(manager, i)->id) > 0) {
+            order->deltaSorted = 0;
+        }
+        order->delta[order->deltaCount++] = i;
+    }
+    // 与 indexStudent 相同，姓名部分按姓名复用键
+    NameKeyCache cache = {NULL, 0, NULL, 0, 0};
+    for (int i = 0; i < manager->count; i++) {
+        const Student *student = getStudent(manager, i);
+        postingAdd(&manager->majorIndex, student->majorId, i);
+        postingAdd(&manager->departmentIndex, student->departmentId, i);
+        postingAdd(&manager->classIndex, student->classId, i);
+        indexStudentNameCached(manager, i, &cache);
+        indexStudentScores(manager, i);
+    }
+    free(cache.start);
+    free(cache.keys);
+    invalidateColumns(manager);
+    return 1;
+}
+
+// 计算学号哈希值（FNV-1a）
+unsigned int hashId(const char *id) {
+    unsigned int hash = 2166136261u;
+    while (*id != '\0') {
+        hash ^= (unsigned char)*id++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// 按指定槽位数重建学号哈希索引（同时清除删除标记，已标记删除的学生不再加入）
+// 学号重复的学生只登记先出现的一个（只有批量载入的数据可能重复，见 buildStudentIndexes）
+int idIndexRebuild(StudentManager *manager, int slotCapacity) {
+    IdIndexSlot *slots = (IdIndexSlot *)malloc(sizeof(IdIndexSlot) * slotCapacity);
+    if (slots == NULL) {
+        return 0;
+    }
+    for (int i = 0; i < slotCapacity; i++) {
+        slots[i].hash = 0;
+        slots[i].index = ID_INDEX_EMPTY;
     }
     
-    strcpy(manager->departmentNames[manager->departmentCount], name);
-    manager->departmentCount++;
+    unsigned int mask = (unsigned int)slotCapacity - 1;
+    int used = 0;
+    for (int i = 0; i < manager->count; i++) {
+        if (getStudent(manager, i)->deleted) {
+            continue;
+        }
+        const char *id = getStudent(manager, i)->id;
+        unsigned int hash = hashId(id);
+        unsigned int pos = hash & mask;
+        while (slots[pos].index != ID_INDEX_EMPTY &&
+               (slots[pos].hash != hash || strcmp(getStudent(manager, slots[pos].index)->id, id) != 0)) {
+            pos = (pos + 1) & mask;
+        }
+        if (slots[pos].index != ID_INDEX_EMPTY) {
+            continue;
+        }
+        slots[pos].hash = hash;
+        slots[pos].index = i;
+        used++;
+    }
     
-    setColor(COLOR_GREEN);
-    printf("\t\t院系 '%s' 添加成功！\n", name);
-    setColor(COLOR_RESET);
+    if (manager->idIndex != NULL) {
+        free(manager->idIndex);
+    }
+    manager->idIndex = slots;
+    manager->idIndexCapacity = slotCapacity;
+    manager->idIndexUsed = used;
+    return 1;
 }
 
-// 清除所有院系
-void clearDepartments(StudentManager *manager) {
-    for (int i = 0; i < manager->departmentCount; i++) {
-        free(manager->departmentNames[i]);
+// 将下标为 index 的学生加入学号哈希索引
+int idIndexInsert(StudentManager *manager, int index) {
+    // 负载因子超过0.7时扩容
+    if ((manager->idIndexUsed + 1) * 10 > manager->idIndexCapacity * 7) {
+        int newCapacity = manager->idIndexCapacity;
+        if ((manager->count + 1) * 10 > newCapacity * 4) {
+            newCapacity *= 2;
+        }
+        if (!idIndexRebuild(manager, newCapacity)) {
+            return 0;
+        }
     }
-    manager->departmentCount = 0;
     
-    setColor(COLOR_GREEN);
-    printf("\t\t所有院系已清除！\n");
-    setColor(COLOR_RESET);
+    unsigned int mask = (unsigned int)manager->idIndexCapacity - 1;
+    unsigned int hash = hashId(getStudent(manager, index)->id);
+    unsigned int pos = hash & mask;
+    while (manager->idIndex[pos].index >= 0) {
+        pos = (pos + 1) & mask;
+    }
+    if (manager->idIndex[pos].index == ID_INDEX_EMPTY) {
+        manager->idIndexUsed++;
+    }
+    manager->idIndex[pos].hash = hash;
+    manager->idIndex[pos].index = index;
+    return 1;
 }
 
-// 管理院系预设
-void manageDepartments(StudentManager *manager) {
-    char choice;
-    while (1) {
-        clearScreen();
-        setColor(COLOR_CYAN);
-        printf("\n\t\t=============================================\n");
-        printf("\t\t               院系预设管理                  \n");
-        printf("\t\t=============================================\n");
-        setColor(COLOR_RESET);
-        
-        displayDepartments(manager);
-        
-        setColor(COLOR_YELLOW);
-        printf("\t\t1. 添加院系\n");
-        printf("\t\t2. 清除所有院系\n");
-        printf("\t\t0. 返回主菜单\n");
-        printf("\t\t请输入选择: ");
-        setColor(COLOR_RESET);
-        
-        choice = getch();
-        clearInputBuffer();
-        
-        switch (choice) {
-            case '1': {
-                char department[30];
-                printf("\t\t请输入院系名称: ");
-                fgets(department, sizeof(department), stdin);
-                department[strcspn(department, "\n")] = '\0';
-                
-                if (isEmptyString(department)) {
-                    setColor(COLOR_RED);
-                    printf("\t\t院系名称不能为空！\n");
-                    setColor(COLOR_RESET);
-                } else {
-                    addDepartment(manager, department);
-                }
-                break;
-            }
-            case '2': {
-                char confirm;
-                setColor(COLOR_RED);
-                printf("\t\t确定要清除所有院系吗？(y/n): ");
-                setColor(COLOR_RESET);
-                confirm = getch();
-                printf("%c\n", confirm);
-                if (confirm == 'y' || confirm == 'Y') {
-                    clearDepartments(manager);
-                } else {
-                    printf("\t\t已取消操作！\n");
-                }
-                break;
-            }
-            case '0':
-                return;
-            default:
-                setColor(COLOR_RED);
-                printf("\t\t无效的选择！\n");
-                setColor(COLOR_RESET);
+// 查找学号所在的哈希槽位，未找到返回-1
+int idIndexFindSlot(StudentManager *manager, const char *id) {
+    unsigned int mask = (unsigned int)manager->idIndexCapacity - 1;
+    unsigned int hash = hashId(id);
+    unsigned int pos = hash & mask;
+    while (manager->idIndex[pos].index != ID_INDEX_EMPTY) {
+        int index = manager->idIndex[pos].index;
+        if (index >= 0 && manager->idIndex[pos].hash == hash &&
+            strcmp(getStudent(manager, index)->id, id) == 0) {
+            return (int)pos;
         }
-        
-        setColor(COLOR_BLUE);
-        printf("\t\t按任意键继续...");
-        setColor(COLOR_RESET);
-        getch();
+        pos = (pos + 1) & mask;
     }
+    return -1;
 }
 
-// 显示专业列表
-void displayMajors(StudentManager *manager) {
-    setColor(COLOR_YELLOW);
-    if (manager->majorCount == 0) {
-        printf("\t\t当前没有预设的专业！\n");
-    } else {
-        printf("\t\t当前预设的专业列表：\n");
-        for (int i = 0; i < manager->majorCount; i++) {
-            printf("\t\t%d. %s\n", i + 1, manager->majorNames[i]);
-        }
+// 通过学号哈希索引查找学生下标，未找到返回-1
+int idIndexFind(StudentManager *manager, const char *id) {
+    int slot = idIndexFindSlot(manager, id);
+    return slot == -1 ? -1 : manager->idIndex[slot].index;
+}
+
+// 从学号哈希索引中移除学号
+void idIndexRemove(StudentManager *manager, const char *id) {
+    int slot = idIndexFindSlot(manager, id);
+    if (slot != -1) {
+        manager->idIndex[slot].index = ID_INDEX_DELETED;
     }
-    setColor(COLOR_RESET);
 }
 
-// 添加专业
-void addMajor(StudentManager *manager, const char *name) {
-    // 检查专业是否已存在
-    for (int i = 0; i < manager->majorCount; i++) {
-        if (strcmp(manager->majorNames[i], name) == 0) {
-            setColor(COLOR_RED);
-            printf("\t\t专业 '%s' 已存在！\n", name);
-            setColor(COLOR_RESET);
-            return;
-        }
+// 更新学号对应的学生下标（学生在数组中移动后调用）
+void idIndexUpdate(StudentManager *manager, const char *id, int newIndex) {
+    int slot = idIndexFindSlot(manager, id);
+    if (slot != -1) {
+        manager->idIndex[slot].index = newIndex;
     }
-    
-    // 检查是否需要扩容
-    if (manager->majorCount >= manager->majorCapacity) {
-        int newCapacity = manager->majorCapacity * 2;
-        char **newMajorNames = (char **)realloc(manager->majorNames, sizeof(char *) * newCapacity);
-        if (newMajorNames == NULL) {
-            setColor(COLOR_RED);
-            printf("\t\t内存分配失败，无法添加新专业！\n");
-            setColor(COLOR_RESET);
-            return;
+}
+
+// 把新学生记入学号有序索引的增量缓冲区（查询时才排序并入主数组），成功返回1
+int idOrderAdd(StudentManager *manager, int index) {
+    IdOrderIndex *order = &manager->idOrder;
+    if (order->deltaCount >= order->deltaCapacity) {
+        int newCapacity = order->deltaCapacity == 0 ? 256 : order->deltaCapacity * 2;
+        int *newDelta = (int *)realloc(order->delta, sizeof(int) * (size_t)newCapacity);
+        if (newDelta == NULL) {
+            return 0;
         }
-        manager->majorNames = newMajorNames;
-        manager->majorCapacity = newCapacity;
+        order->delta = newDelta;
+        order->deltaCapacity = newCapacity;
     }
-    
-    // 添加新专业
-    manager->majorNames[manager->majorCount] = (char *)malloc(sizeof(char) * (strlen(name) + 1));
-    if (manager->majorNames[manager->majorCount] == NULL) {
-        setColor(COLOR_RED);
-        printf("\t\t内存分配失败，无法添加新专业！\n");
-        setColor(COLOR_RESET);
-        return;
+    if (order->deltaCount > 0 &&
+        strcmp(getStudent(manager, order->delta[order->deltaCount - 1])->id, getStudent(manager, index)->id) > 0) {
+        order->deltaSorted = 0;
     }
-    
-    strcpy(manager->majorNames[manager->majorCount], name);
-    manager->majorCount++;
-    
-    setColor(COLOR_GREEN);
-    printf("\t\t专业 '%s' 添加成功！\n", name);
-    setColor(COLOR_RESET);
+    order->delta[order->deltaCount++] = index;
+    return 1;
 }
 
-// 清除所有专业
-void clearMajors(StudentManager *manager) {
-    for (int i = 0; i < manager->majorCount; i++) {
-        free(manager->majorNames[i]);
+// 在按学号排序的下标数组中查找第一个学号不小于 id 的位置
+int idOrderLowerBound(StudentManager *manager, const int *items, int count, const char *id) {
+    int low = 0, high = count;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (strcmp(getStudent(manager, items[mid])->id, id) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
     }
-    manager->majorCount = 0;
-    
-    setColor(COLOR_GREEN);
-    printf("\t\t所有专业已清除！\n");
-    setColor(COLOR_RESET);
+    return low;
 }
 
-// 管理专业预设
-void manageMajors(StudentManager *manager) {
-    char choice;
-    while (1) {
-        clearScreen();
-        setColor(COLOR_CYAN);
-        printf("\n\t\t=============================================\n");
-        printf("\t\t               专业预设管理                  \n");
-        printf("\t\t=============================================\n");
-        setColor(COLOR_RESET);
-        
-        displayMajors(manager);
-        
-        setColor(COLOR_YELLOW);
-        printf("\t\t1. 添加专业\n");
-        printf("\t\t2. 清除所有专业\n");
-        printf("\t\t0. 返回主菜单\n");
-        printf("\t\t请输入选择: ");
-        setColor(COLOR_RESET);
-        
-        choice = getch();
-        clearInputBuffer();
-        
-        switch (choice) {
-            case '1': {
-                char major[30];
-                printf("\t\t请输入专业名称: ");
-                fgets(major, sizeof(major), stdin);
-                major[strcspn(major, "\n")] = '\0';
-                
-                if (isEmptyString(major)) {
-                    setColor(COLOR_RED);
-                    printf("\t\t专业名称不能为空！\n");
-                    setColor(COLOR_RESET);
-                } else {
-                    addMajor(manager, major);
-                }
-                break;
-            }
-            case '2': {
-                char confirm;
-                setColor(COLOR_RED);
-                printf("\t\t确定要清除所有专业吗？(y/n): ");
-                setColor(COLOR_RESET);
-                confirm = getch();
-                printf("%c\n", confirm);
-                if (confirm == 'y' || confirm == 'Y') {
-                    clearMajors(manager);
-                } else {
-                    printf("\t\t已取消操作！\n");
-                }
-                break;
+// 压缩学生存储时调用：去掉已删除的学生（remap 为-1），其余下标按映射表改写（学号不变，顺序不变）
+void idOrderRemap(StudentManager *manager, const int *remap) {
+    IdOrderIndex *order = &manager->idOrder;
+    int *arrays[2] = {order->sorted, order->delta};
+    int *counts[2] = {&order->sortedCount, &order->deltaCount};
+    for (int a = 0; a < 2; a++) {
+        int *items = arrays[a];
+        int count = *counts[a];
+        int kept = 0;
+        for (int i = 0; i < count; i++) {
+            if (remap[items[i]] != -1) {
+                items[kept++] = remap[items[i]];
             }
-            case '0':
-                return;
-            default:
-                setColor(COLOR_RED);
-                printf("\t\t无效的选择！\n");
-                setColor(COLOR_RESET);
         }
-        
-        setColor(COLOR_BLUE);
-        printf("\t\t按任意键继续...");
-        setColor(COLOR_RESET);
-        getch();
+        *counts[a] = kept;
     }
 }
 
-// 验证院系是否有效
-int isValidDepartment(StudentManager *manager, const char *department) {
-    if (manager->departmentCount == 0) {
-        return 0;  // 没有预设院系
+// 按学号比较排序临时项
+int compareIdOrderItems(const void *a, const void *b) {
+    return strcmp(((const IdOrderItem *)a)->id, ((const IdOrderItem *)b)->id);
+}
+
+// 查询前整理学号有序索引：增量缓冲区按学号排序；缓冲区较大时与主数组归并成一个数组
+// 排序时把学号复制到临时数组中比较，避免反复访问分散的学生记录。内存不足返回0
+int idOrderPrepare(StudentManager *manager) {
+    IdOrderIndex *order = &manager->idOrder;
+    if (!order->deltaSorted && order->deltaCount > 0) {
+        IdOrderItem *items = (IdOrderItem *)malloc(sizeof(IdOrderItem) * (size_t)order->deltaCount);
+        if (items == NULL) {
+            return 0;
+        }
+        for (int i = 0; i < order->deltaCount; i++) {
+            memcpy(items[i].id, getStudent(manager, order->delta[i])->id, sizeof(items[i].id));
+            items[i].index = order->delta[i];
+        }
+        qsort(items, (size_t)order->deltaCount, sizeof(IdOrderItem), compareIdOrderItems);
+        for (int i = 0; i < order->deltaCount; i++) {
+            order->delta[i] = items[i].index;
+        }
+        free(items);
+    }
+    order->deltaSorted = 1;
+    if (order->deltaCount <= ID_ORDER_DELTA_MAX) {
+        return 1;
     }
     
-    for (int i = 0; i < manager->departmentCount; i++) {
-        if (strcmp(manager->departmentNames[i], department) == 0) {
-            return 1;  // 院系有效
+    // 两个有序数组从后往前归并到主数组
+    int total = order->sortedCount + order->deltaCount;
+    if (total > order->sortedCapacity) {
+        int *newSorted = (int *)realloc(order->sorted, sizeof(int) * (size_t)total);
+        if (newSorted == NULL) {
+            return 0;
         }
+        order->sorted = newSorted;
+        order->sortedCapacity = total;
     }
-    
-    return 0;  // 院系无效
+    int i = order->sortedCount - 1, j = order->deltaCount - 1;
+    for (int k = total - 1; j >= 0; k--) {
+        if (i >= 0 && strcmp(getStudent(manager, order->sorted[i])->id, getStudent(manager, order->delta[j])->id) > 0) {
+            order->sorted[k] = order->sorted[i--];
+        } else {
+            order->sorted[k] = order->delta[j--];
+        }
+    }
+    order->sortedCount = total;
+    order->deltaCount = 0;
+    return 1;
 }
 
-// 验证专业是否有效
-int isValidMajor(StudentManager *manager, const char *major) {
-    if (manager->majorCount == 0) {
-        return 0;  // 没有预设专业
+// 按学号顺序列出从 low 开始的学生：high 不为NULL时学号不超过 high，prefixLength 大于0时学号以 low 的前 prefixLength 个字符开头
+// 在主数组和增量缓冲区中各二分定位一次，再顺序归并，耗时 O(log n + k)。返回学生下标数组（需调用者释放），出错时返回NULL且 *count 为-1
+int *idOrderScan(StudentManager *manager, const char *low, const char *high, size_t prefixLength, int *count) {
+    if (!idOrderPrepare(manager)) {
+        *count = -1;
+        return NULL;
     }
-    
-    for (int i = 0; i < manager->majorCount; i++) {
-        if (strcmp(manager->majorNames[i], major) == 0) {
-            return 1;  // 专业有效
+    IdOrderIndex *order = &manager->idOrder;
+    int i = idOrderLowerBound(manager, order->sorted, order->sortedCount, low);
+    int j = idOrderLowerBound(manager, order->delta, order->deltaCount, low);
+    int capacity = 64, matched = 0;
+    int *result = (int *)malloc(sizeof(int) * (size_t)capacity);
+    if (result == NULL) {
+        *count = -1;
+        return NULL;
+    }
+    while (i < order->sortedCount || j < order->deltaCount) {
+        int fromSorted = j >= order->deltaCount ||
+                         (i < order->sortedCount && strcmp(getStudent(manager, order->sorted[i])->id,
+                                                           getStudent(manager, order->delta[j])->id) < 0);
+        int index = fromSorted ? order->sorted[i] : order->delta[j];
+        const char *id = getStudent(manager, index)->id;
+        if ((high != NULL && strcmp(id, high) > 0) || (prefixLength > 0 && strncmp(id, low, prefixLength) != 0)) {
+            break;
+        }
+        if (matched >= capacity) {
+            int *newResult = (int *)realloc(result, sizeof(int) * (size_t)capacity * 2);
+            if (newResult == NULL) {
+                free(result);
+                *count = -1;
+                return NULL;
+            }
+            result = newResult;
+            capacity *= 2;
+        }
+        // 逐个删除的学生留到压缩时才移出有序索引，这里跳过
+        if (!getStudent(manager, index)->deleted) {
+            result[matched++] = index;
+        }
+        if (fromSorted) {
+            i++;
+        } else {
+            j++;
         }
     }
-    
-    return 0;  // 专业无效
+    *count = matched;
+    return result;
 }
 
-// 获取单个按键输入（无需回车）
-char getKey() {
-    return _getch();
+// 查找学号以 prefix 开头的全部学生，按学号排序
+int *findStudentsByIdPrefix(StudentManager *manager, const char *prefix, int *count) {
+    return idOrderScan(manager, prefix, NULL, strlen(prefix), count);
 }
 
-// 清屏
-void clearScreen() {
-    system("cls");
+// 查找学号在 [low, high] 之间（按字典序，含两端）的全部学生，按学号排序
+int *findStudentsByIdRange(StudentManager *manager, const char *low, const char *high, int *count) {
+    return idOrderScan(manager, low, high, 0, count);
 }
 
-// 设置颜色
-void setColor(const char *color) {
-    printf("%s", color);
+// 释放学号有序索引
+void idOrderFree(IdOrderIndex *order) {
+    free(order->sorted);
+    free(order->delta);
+    memset(order, 0, sizeof(IdOrderIndex));
 }
 
-// 显示菜单
-void showMenu() {
-    clearScreen();
-    setColor(COLOR_YELLOW);
-    printf("\n\n");
-    printf("                ==============================================================\n");
-    printf("                *                                                            *\n");
-    printf("                *                      学生信息管理系统                      *\n");
-    printf("                *                                                            *\n");
-    printf("                ==============================================================\n");
-    printf("                *                       系统功能菜单                         *\n");
-    printf("                --------------------------------------------------------------\n");
-    setColor(COLOR_RESET);
-    
-    setColor(COLOR_CYAN);
-    printf("                *  1. %-15s          ** 2. %-15s                *\n", "使用说明", "录入学生信息");
-    printf("                ==============================================================\n");         
-    printf("                *  3. %-15s         ** 4. %-15s                *\n", "显示学生信息", "查找学生信息");
-    printf("                ==============================================================\n");         
-    printf("                *  5. %-15s         ** 6. %-15s                *\n", "修改学生信息", "删除学生信息");
-    printf("                ==============================================================\n");         
-    printf("                *  7. %-15s         ** 8. %-15s                *\n", "院系预设设置", "专业预设设置");
-    printf("                ==============================================================\n");         
-    printf("                *  9. %-15s           ** a. %-15s                 *\n", "成绩名预设", "软件信息");
-    printf("                ==============================================================\n");
-    printf("                *  b. %-15s           ** 0. %-15s                 *\n", "开发者的话", "退出系统");
-    printf("                ==============================================================\n");
-    setColor(COLOR_RESET);
-    
-    setColor(COLOR_BLUE);
-    printf("\n\t\tStudents' Information Management System developed by MccoyFreyr\n");
-    setColor(COLOR_RESET);
-    
-    setColor(COLOR_MAGENTA);
-    printf("\n\t\t请输入选择 (0-9, a, b): ");
-    setColor(COLOR_RESET);
+// 排行树结点的堆优先级：由结点位置打散得到，与总分无关，树高期望为 O(log n)
+unsigned int rankPriority(int node) {
+    unsigned int x = (unsigned int)node + 0x9e3779b9u;
+    x ^= x >> 16;
+    x *= 0x85ebca6bu;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35u;
+    x ^= x >> 16;
+    return x;
 }
 
-// 验证字符串是否为空或只包含空格
-int isEmptyString(const char *str) {
-    if (str == NULL || *str == '\0') return 1;
-    while (*str != '\0') {
-        if (*str != ' ' && *str != '\t') {
-            return 0;
-        }
-        str++;
-    }
-    return 1;
+// 结点是否排在 (key, index) 之前：总分高的在前，总分相同时下标小的在前
+int rankBefore(const RankNode *node, int key, int index) {
+    return node->key > key || (node->key == key && node->index < index);
 }
 
-// 清理输入缓冲区
+// 子树结点数
+int rankSize(const RankTree *tree, int node) {
+    return node == RANK_NIL ? 0 : tree->nodes[node].size;
+}
+
+// 重新计算结点的子树大小
+void rankUpdate(RankTree *tree, int node) {
+    RankNode *current = &tree->nodes[node];
+    current->size = 1 + rankSize(tree, current->left) + rankSize(tree, current->right);
+}
+
+// 把子树 node 拆成排在 (key, index) 之前的部分 *left 和其余部分 *right
+void rankSplit(RankTree *tree, int node, int key, int index, int *left, int *right) {
+    if (node == RANK_NIL) {
+        *left = RANK_NIL;
+        *right = RANK_NIL;
+        return;
+    }
+    if (rankBefore(&tree->nodes[node], key, index)) {
+        rankSplit(tree, tree->nodes[node].right, key, index, &tree->nodes[node].right, right);
+        *left = node;
+    } else {
+        rankSplit(tree, tree->nodes[node].left, key, index, left, &tree->nodes[node].left);
+        *right = node;
+    }
+    rankUpdate(tree, node);
+}
+
+// 合并两棵子树（left 中的结点全部排在 right 之前），返回新的根
+int rankMerge(RankTree *tree, int left, int right) {
+    if (left == RANK_NIL) {
+        return right;
+    }
+    if (right == RANK_NIL) {
+        return left;
+    }
+    if (rankPriority(left) > rankPriority(right)) {
+        tree->nodes[left].right = rankMerge(tree, tree->nodes[left].right, right);
+        rankUpdate(tree, left);
+        return left;
+    }
+    tree->nodes[right].left = rankMerge(tree, left, tree->nodes[right].left);
+    rankUpdate(tree, right);
+    return right;
+}
+
+// 把学生 (key, index) 插入排行树，内存不足返回0
+int rankInsert(RankTree *tree, int key, int index) {
+    int node;
+    if (tree->freeHead != RANK_NIL) {
+        node = tree->freeHead;
+        tree->freeHead = tree->nodes[node].left;
+    } else {
+        if (tree->nodeCount >= tree->nodeCapacity) {
+            int newCapacity = tree->nodeCapacity == 0 ? 64 : tree->nodeCapacity * 2;
+            RankNode *newNodes = (RankNode *)realloc(tree->nodes, sizeof(RankNode) * (size_t)newCapacity);
+            if (newNodes == NULL) {
+                return 0;
+            }
+            tree->nodes = newNodes;
+            tree->nodeCapacity = newCapacity;
+        }
+        node = tree->nodeCount++;
+    }
+    tree->nodes[node].key = key;
+    tree->nodes[node].index = index;
+    tree->nodes[node].left = RANK_NIL;
+    tree->nodes[node].right = RANK_NIL;
+    tree->nodes[node].size = 1;
+    
+    int left, right;
+    rankSplit(tree, tree->root, key, index, &left, &right);
+    tree->root = rankMerge(tree, rankMerge(tree, left, node), right);
+    return 1;
+}
+
+// 从排行树中删除学生 (key, index)，结点放回空闲链表
+void rankErase(RankTree *tree, int key, int index) {
+    int left, middle, right;
+    rankSplit(tree, tree->root, key, index, &left, &middle);
+    rankSplit(tree, middle, key, index + 1, &middle, &right);
+    if (middle != RANK_NIL) {
+        tree->nodes[middle].left = tree->freeHead;
+        tree->nodes[middle].size = 0;
+        tree->freeHead = middle;
+    }
+    tree->root = rankMerge(tree, left, right);
+}
+
+// 统计排在 (key, index) 之前的学生数：index 取-1 时为总分高于 key 的人数，取 INT_MAX 时为总分不低于 key 的人数
+int rankCountBefore(const RankTree *tree, int key, int index) {
+    int count = 0;
+    int node = tree->root;
+    while (node != RANK_NIL) {
+        const RankNode *current = &tree->nodes[node];
+        if (rankBefore(current, key, index)) {
+            count += rankSize(tree, current->left) + 1;
+            node = current->right;
+        } else {
+            node = current->left;
+        }
+    }
+    return count;
+}
+
+// 按名次顺序取出子树中的学生下标，取满 limit 个为止
+void rankCollect(const RankTree *tree, int node, int *result, int *count, int limit) {
+    if (node == RANK_NIL || *count >= limit) {
+        return;
+    }
+    rankCollect(tree, tree->nodes[node].left, result, count, limit);
+    if (*count < limit) {
+        result[(*count)++] = tree->nodes[node].index;
+        rankCollect(tree, tree->nodes[node].right, result, count, limit);
+    }
+}
+
+// 压缩学生存储时调用：按映射表改写结点中的下标（映射保持先后顺序，树形无需调整）
+// 已删除的学生此前已移出排行；空闲结点的下标没有意义，改写为-1
+void rankRemap(RankTree *tree, const int *remap) {
+    for (int i = 0; i < tree->nodeCount; i++) {
+        if (tree->nodes[i].index >= 0) {
+            tree->nodes[i].index = remap[tree->nodes[i].index];
+        }
+    }
+}
+
+// 释放排行树，之后需要时重新建立
+void rankFree(RankTree *tree) {
+    free(tree->nodes);
+    memset(tree, 0, sizeof(RankTree));
+}
+
+// 学生在排行中的键：总分换算为百分之一分（定点模式下本就是精确整数）
+int rankKey(const Student *student) {
+    return fixedScoreMode ? student->total.totalHundredths : scoreToHundredths(student->total.totalScore);
+}
+
+// 取某个范围的排行树槽位：全体学生，或按专业/班级编号。编号超出已有范围时，create 为0返回NULL，否则扩容
+RankTree *rankScopeTree(StudentManager *manager, int scope, int id, int create) {
+    if (scope == RANK_SCOPE_ALL) {
+        return &manager->rankAll;
+    }
+    RankTree **trees = scope == RANK_SCOPE_MAJOR ? &manager->majorRanks : &manager->classRanks;
+    int *capacity = scope == RANK_SCOPE_MAJOR ? &manager->majorRankCapacity : &manager->classRankCapacity;
+    if (id < 0) {
+        return NULL;
+    }
+    if (id >= *capacity) {
+        if (!create) {
+            return NULL;
+        }
+        int newCapacity = *capacity == 0 ? 16 : *capacity;
+        while (newCapacity <= id) {
+            newCapacity *= 2;
+        }
+        RankTree *newTrees = (RankTree *)realloc(*trees, sizeof(RankTree) * (size_t)newCapacity);
+        if (newTrees == NULL) {
+            return NULL;
+        }
+        memset(newTrees + *capacity, 0, sizeof(RankTree) * (size_t)(newCapacity - *capacity));
+        *trees = newTrees;
+        *capacity = newCapacity;
+    }
+    return &(*trees)[id];
+}
+
+// 按名次顺序比较排行树结点
+int compareRankNodes(const void *a, const void *b) {
+    const RankNode *x = (const RankNode *)a, *y = (const RankNode *)b;
+    if (x->key != y->key) {
+        return x->key > y->key ? -1 : 1;
+    }
+    return x->index < y->index ? -1 : x->index > y->index;
+}
+
+// 计算子树大小（建立排行树后调用一次）
+int rankFixSizes(RankTree *tree, int node) {
+    if (node == RANK_NIL) {
+        return 0;
+    }
+    RankNode *current = &tree->nodes[node];
+    current->size = 1 + rankFixSizes(tree, current->left) + rankFixSizes(tree, current->right);
+    return current->size;
+}
+
+// 取某个范围的排行树，首次使用时由全部学生或专业/班级倒排列表建立。内存不足返回NULL
+// 建立时先把结点按名次排好序，再用单调栈一次建成树堆，耗时 O(n log n)，比逐个插入少了大量随机访问
+RankTree *rankTreeFor(StudentManager *manager, int scope, int id) {
+    RankTree *tree = rankScopeTree(manager, scope, id, 1);
+    if (tree == NULL || tree->built) {
+        return tree;
+    }
+    PostingList *list = NULL;
+    int count = manager->count;
+    if (scope != RANK_SCOPE_ALL) {
+        list = postingFind(scope == RANK_SCOPE_MAJOR ? &manager->majorIndex : &manager->classIndex, id);
+        count = list != NULL ? list->count : 0;
+    }
+    int capacity = count > 64 ? count : 64;
+    tree->nodes = (RankNode *)malloc(sizeof(RankNode) * (size_t)capacity);
+    int *stack = (int *)malloc(sizeof(int) * (size_t)capacity);
+    if (tree->nodes == NULL || stack == NULL) {
+        free(stack);
+        rankFree(tree);
+        return NULL;
+    }
+    tree->nodeCapacity = capacity;
+    int filled = 0;
+    for (int i = 0; i < count; i++) {
+        int index = list != NULL ? list->items[i] : i;
+        if (getStudent(manager, index)->deleted) {
+            continue;
+        }
+        tree->nodes[filled].key = rankKey(getStudent(manager, index));
+        tree->nodes[filled].index = index;
+        filled++;
+    }
+    count = filled;
+    tree->nodeCount = count;
+    qsort(tree->nodes, (size_t)count, sizeof(RankNode), compareRankNodes);
+    
+    // 按名次顺序依次加入：栈中保存最右链，优先级更高的结点把栈顶弹出的链挂为左子树
+    int top = 0;
+    for (int i = 0; i < count; i++) {
+        int last = RANK_NIL;
+        while (top > 0 && rankPriority(stack[top - 1]) < rankPriority(i)) {
+            last = stack[--top];
+        }
+        tree->nodes[i].left = last;
+        tree->nodes[i].right = RANK_NIL;
+        if (top > 0) {
+            tree->nodes[stack[top - 1]].right = i;
+        }
+        stack[top++] = i;
+    }
+    tree->root = top > 0 ? stack[0] : RANK_NIL;
+    tree->freeHead = RANK_NIL;
+    rankFixSizes(tree, tree->root);
+    free(stack);
+    tree->built = 1;
+    return tree;
+}
+
+// 把学生加入已建立的排行（全体、所在专业、所在班级）；插入失败的排行整个丢弃，下次查询时重建
+void rankIndexStudent(StudentManager *manager, int index) {
+    const Student *student = getStudent(manager, index);
+    RankTree *trees[3] = {&manager->rankAll,
+                          rankScopeTree(manager, RANK_SCOPE_MAJOR, student->majorId, 0),
+                          rankScopeTree(manager, RANK_SCOPE_CLASS, student->classId, 0)};
+    int key = rankKey(student);
+    for (int i = 0; i < 3; i++) {
+        if (trees[i] != NULL && trees[i]->built && !rankInsert(trees[i], key, index)) {
+            rankFree(trees[i]);
+        }
+    }
+}
+
+// 把学生从已建立的排行中移除（修改成绩、专业、班级或删除前调用）
+void rankUnindexStudent(StudentManager *manager, int index) {
+    const Student *student = getStudent(manager, index);
+    RankTree *trees[3] = {&manager->rankAll,
+                          rankScopeTree(manager, RANK_SCOPE_MAJOR, student->majorId, 0),
+                          rankScopeTree(manager, RANK_SCOPE_CLASS, student->classId, 0)};
+    int key = rankKey(student);
+    for (int i = 0; i < 3; i++) {
+        if (trees[i] != NULL && trees[i]->built) {
+            rankErase(trees[i], key, index);
+        }
+    }
+}
+
+// 压缩学生存储时，改写全部已建立排行中的下标
+void rankRemapAll(StudentManager *manager, const int *remap) {
+    if (manager->rankAll.built) {
+        rankRemap(&manager->rankAll, remap);
+    }
+    for (int i = 0; i < manager->majorRankCapacity; i++) {
+        if (manager->majorRanks[i].built) {
+            rankRemap(&manager->majorRanks[i], remap);
+        }
+    }
+    for (int i = 0; i < manager->classRankCapacity; i++) {
+        if (manager->classRanks[i].built) {
+            rankRemap(&manager->classRanks[i], remap);
+        }
+    }
+}
+
+// 取排行前 limit 名学生的下标（按名次顺序，需调用者释放），出错时返回NULL且 *count 为-1
+int *rankTopStudents(StudentManager *manager, int scope, int id, int limit, int *count) {
+    RankTree *tree = rankTreeFor(manager, scope, id);
+    int size = tree == NULL ? 0 : rankSize(tree, tree->root);
+    if (limit < size) {
+        size = limit;
+    }
+    int *result = (int *)malloc(sizeof(int) * (size_t)(size > 0 ? size : 1));
+    if (tree == NULL || result == NULL) {
+        free(result);
+        *count = -1;
+        return NULL;
+    }
+    *count = 0;
+    rankCollect(tree, tree->root, result, count, limit);
+    return result;
+}
+
+// 查询学生在某个范围排行中的名次（同分同名次）、范围人数和百分位（低于该生的人数加同分人数的一半，占总人数的百分比）
+// 学生不在该范围内或内存不足返回0
+int rankOfStudent(StudentManager *manager, int scope, int id, int index, int *rank, int *total, double *percentile) {
+    const Student *student = getStudent(manager, index);
+    if ((scope == RANK_SCOPE_MAJOR && student->majorId != id) || (scope == RANK_SCOPE_CLASS && student->classId != id)) {
+        return 0;
+    }
+    RankTree *tree = rankTreeFor(manager, scope, id);
+    if (tree == NULL) {
+        return 0;
+    }
+    int key = rankKey(student);
+    int above = rankCountBefore(tree, key, -1);
+    int atLeast = rankCountBefore(tree, key, INT_MAX);
+    *total = rankSize(tree, tree->root);
+    *rank = above + 1;
+    *percentile = *total > 0 ? ((*total - atLeast) + (atLeast - above) * 0.5) * 100.0 / *total : 0.0;
+    return 1;
+}
+
+// 释放全部排行
+void rankFreeAll(StudentManager *manager) {
+    rankFree(&manager->rankAll);
+    for (int i = 0; i < manager->majorRankCapacity; i++) {
+        rankFree(&manager->majorRanks[i]);
+    }
+    for (int i = 0; i < manager->classRankCapacity; i++) {
+        rankFree(&manager->classRanks[i]);
+    }
+    free(manager->majorRanks);
+    free(manager->classRanks);
+    manager->majorRanks = NULL;
+    manager->classRanks = NULL;
+    manager->majorRankCapacity = 0;
+    manager->classRankCapacity = 0;
+}
+
+// 释放成绩分布，之后需要时重新建立
+void histogramFree(ScoreHistogram *histogram) {
+    for (int j = 0; j < histogram->courseCount; j++) {
+        free(histogram->counts[j]);
+    }
+    free(histogram->counts);
+    free(histogram->totals);
+    memset(histogram, 0, sizeof(ScoreHistogram));
+}
+
+// 把一名学生的各门成绩计入（delta 为1）或移出（delta 为-1）成绩分布，内存不足返回0
+int histogramAddStudent(ScoreHistogram *histogram, const Student *student, int delta) {
+    if (student->scoreCount > histogram->courseCount) {
+        int newCount = student->scoreCount;
+        int **newCounts = (int **)realloc(histogram->counts, sizeof(int *) * (size_t)newCount);
+        if (newCounts == NULL) {
+            return 0;
+        }
+        histogram->counts = newCounts;
+        int *newTotals = (int *)realloc(histogram->totals, sizeof(int) * (size_t)newCount);
+        if (newTotals == NULL) {
+            return 0;
+        }
+        histogram->totals = newTotals;
+        for (int j = histogram->courseCount; j < newCount; j++) {
+            histogram->counts[j] = NULL;
+            histogram->totals[j] = 0;
+        }
+        histogram->courseCount = newCount;
+    }
+    for (int j = 0; j < student->scoreCount; j++) {
+        if (histogram->counts[j] == NULL) {
+            histogram->counts[j] = (int *)calloc(HISTOGRAM_BINS + HISTOGRAM_BLOCKS, sizeof(int));
+            if (histogram->counts[j] == NULL) {
+                return 0;
+            }
+        }
+        int bin = scoreToHundredths(studentScore(student, j));
+        bin = bin < 0 ? 0 : (bin >= HISTOGRAM_BINS ? HISTOGRAM_BINS - 1 : bin);
+        histogram->counts[j][bin] += delta;
+        histogram->counts[j][HISTOGRAM_BINS + bin / HISTOGRAM_BLOCK] += delta;
+        histogram->totals[j] += delta;
+    }
+    return 1;
+}
+
+// 取全体学生（id 为-1）或某专业的成绩分布，首次使用时建立。内存不足返回NULL
+ScoreHistogram *histogramFor(StudentManager *manager, int majorId) {
+    ScoreHistogram *histogram;
+    if (majorId < 0) {
+        histogram = &manager->histogramAll;
+    } else {
+        if (majorId >= manager->majorHistogramCapacity) {
+            int newCapacity = manager->majorHistogramCapacity == 0 ? 16 : manager->majorHistogramCapacity;
+            while (newCapacity <= majorId) {
+                newCapacity *= 2;
+            }
+            ScoreHistogram *newHistograms = (ScoreHistogram *)realloc(manager->majorHistograms,
+                                                                      sizeof(ScoreHistogram) * (size_t)newCapacity);
+            if (newHistograms == NULL) {
+                return NULL;
+            }
+            memset(newHistograms + manager->majorHistogramCapacity, 0,
+                   sizeof(ScoreHistogram) * (size_t)(newCapacity - manager->majorHistogramCapacity));
+            manager->majorHistograms = newHistograms;
+            manager->majorHistogramCapacity = newCapacity;
+        }
+        histogram = &manager->majorHistograms[majorId];
+    }
+    if (histogram->built) {
+        return histogram;
+    }
+    
+    PostingList *list = majorId < 0 ? NULL : postingFind(&manager->majorIndex, majorId);
+    int count = majorId < 0 ? manager->count : (list != NULL ? list->count : 0);
+    for (int i = 0; i < count; i++) {
+        const Student *student = getStudent(manager, list != NULL ? list->items[i] : i);
+        if (student->deleted) {
+            continue;
+        }
+        if (!histogramAddStudent(histogram, student, 1)) {
+            histogramFree(histogram);
+            return NULL;
+        }
+    }
+    histogram->built = 1;
+    return histogram;
+}
+
+// 把学生的成绩计入已建立的成绩分布（全体、所在专业）；失败的分布整个丢弃，下次查询时重建
+void histogramIndexStudent(StudentManager *manager, int index, int delta) {
+    const Student *student = getStudent(manager, index);
+    ScoreHistogram *histograms[2] = {&manager->histogramAll,
+                                     student->majorId >= 0 && student->majorId < manager->majorHistogramCapacity
+                                         ? &manager->majorHistograms[student->majorId] : NULL};
+    for (int i = 0; i < 2; i++) {
+        if (histograms[i] != NULL && histograms[i]->built && !histogramAddStudent(histograms[i], student, delta)) {
+            histogramFree(histograms[i]);
+        }
+    }
+}
+
+// 第 j 门成绩的 q 分位数（0 < q <= 1，按最近秩法取实际出现过的分数），单位为百分之一分；没有成绩时返回-1
+int histogramQuantile(const ScoreHistogram *histogram, int j, double q) {
+    if (j >= histogram->courseCount || histogram->counts[j] == NULL || histogram->totals[j] <= 0) {
+        return -1;
+    }
+    const int *counts = histogram->counts[j];
+    long long target = (long long)(q * histogram->totals[j] + 0.999999);
+    target = target < 1 ? 1 : target;
+    long long seen = 0;
+    int block = 0;
+    while (block < HISTOGRAM_BLOCKS - 1 && seen + counts[HISTOGRAM_BINS + block] < target) {
+        seen += counts[HISTOGRAM_BINS + block];
+        block++;
+    }
+    for (int bin = block * HISTOGRAM_BLOCK; bin < HISTOGRAM_BINS; bin++) {
+        seen += counts[bin];
+        if (seen >= target) {
+            return bin;
+        }
+    }
+    return HISTOGRAM_BINS - 1;
+}
+
+// 把第 j 门成绩按每10分一段汇总到 buckets[10]（最后一段含100分）
+void histogramBuckets(const ScoreHistogram *histogram, int j, int buckets[10]) {
+    memset(buckets, 0, sizeof(int) * 10);
+    if (j >= histogram->courseCount || histogram->counts[j] == NULL) {
+        return;
+    }
+    for (int block = 0; block < HISTOGRAM_BLOCKS; block++) {
+        int bucket = block * HISTOGRAM_BLOCK / 1000;
+        buckets[bucket < 10 ? bucket : 9] += histogram->counts[j][HISTOGRAM_BINS + block];
+    }
+}
+
+// 释放全部成绩分布
+void histogramFreeAll(StudentManager *manager) {
+    histogramFree(&manager->histogramAll);
+    for (int i = 0; i < manager->majorHistogramCapacity; i++) {
+        histogramFree(&manager->majorHistograms[i]);
+    }
+    free(manager->majorHistograms);
+    manager->majorHistograms = NULL;
+    manager->majorHistogramCapacity = 0;
+}
+
+// 把学生的总分和各门成绩计入排行与成绩分布
+void indexStudentScores(StudentManager *manager, int index) {
+    rankIndexStudent(manager, index);
+    histogramIndexStudent(manager, index, 1);
+}
+
+// 把学生的总分和各门成绩移出排行与成绩分布（修改成绩、专业、班级或删除前调用）
+void unindexStudentScores(StudentManager *manager, int index) {
+    rankUnindexStudent(manager, index);
+    histogramIndexStudent(manager, index, -1);
+}
+
+// 在字典中查找字符串，返回编号，不存在返回-1
+int dictLookup(const StringDict *dict, const char *text) {
+    if (dict->slotCapacity == 0) {
+        return -1;
+    }
+    unsigned int mask = (unsigned int)dict->slotCapacity - 1;
+    unsigned int hash = hashId(text);
+    unsigned int pos = hash & mask;
+    while (dict->slots[pos] != -1) {
+        int id = dict->slots[pos];
+        if (dict->hashes[id] == hash && strcmp(dict->strings[id], text) == 0) {
+            return id;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return -1;
+}
+
+// 把字符串登记进字典（已存在时直接返回原编号），内存不足返回-1
+int dictIntern(StringDict *dict, const char *text) {
+    int id = dictLookup(dict, text);
+    if (id != -1) {
+        return id;
+    }
+    
+    if (dict->count >= dict->capacity) {
+        int newCapacity = dict->capacity == 0 ? 16 : dict->capacity * 2;
+        char **newStrings = (char **)realloc(dict->strings, sizeof(char *) * newCapacity);
+        if (newStrings == NULL) {
+            return -1;
+        }
+        dict->strings = newStrings;
+        unsigned int *newHashes = (unsigned int *)realloc(dict->hashes, sizeof(unsigned int) * newCapacity);
+        if (newHashes == NULL) {
+            return -1;
+        }
+        dict->hashes = newHashes;
+        dict->capacity = newCapacity;
+    }
+    
+    // 字符串数量超过槽位一半时重建哈希表
+    if ((dict->count + 1) * 2 > dict->slotCapacity) {
+        int newSlotCapacity = dict->slotCapacity == 0 ? 32 : dict->slotCapacity * 2;
+        int *newSlots = (int *)malloc(sizeof(int) * newSlotCapacity);
+        if (newSlots == NULL) {
+            return -1;
+        }
+        memset(newSlots, 0xFF, sizeof(int) * newSlotCapacity);
+        unsigned int mask = (unsigned int)newSlotCapacity - 1;
+        for (int i = 0; i < dict->count; i++) {
+            unsigned int pos = dict->hashes[i] & mask;
+            while (newSlots[pos] != -1) {
+                pos = (pos + 1) & mask;
+            }
+            newSlots[pos] = i;
+        }
+        free(dict->slots);
+        dict->slots = newSlots;
+        dict->slotCapacity = newSlotCapacity;
+    }
+    
+    size_t length = strlen(text) + 1;
+    char *copy = (char *)malloc(length);
+    if (copy == NULL) {
+        return -1;
+    }
+    memcpy(copy, text, length);
+    id = dict->count;
+    dict->strings[id] = copy;
+    dict->hashes[id] = hashId(text);
+    unsigned int mask = (unsigned int)dict->slotCapacity - 1;
+    unsigned int pos = dict->hashes[id] & mask;
+    while (dict->slots[pos] != -1) {
+        pos = (pos + 1) & mask;
+    }
+    dict->slots[pos] = id;
+    dict->count++;
+    dict->textBytes += length;
+    return id;
+}
+
+// 由编号取回字符串（编号无效时返回空串）
+const char *dictString(const StringDict *dict, int id) {
+    return id >= 0 && id < dict->count ? dict->strings[id] : "";
+}
+
+// 字典占用的堆内存字节数（字符串、编号表与哈希表）
+size_t dictMemoryBytes(const StringDict *dict) {
+    return dict->textBytes + (sizeof(char *) + sizeof(unsigned int)) * (size_t)dict->capacity +
+           sizeof(int) * (size_t)dict->slotCapacity;
+}
+
+// 释放字典
+void dictFree(StringDict *dict) {
+    for (int i = 0; i < dict->count; i++) {
+        free(dict->strings[i]);
+    }
+    free(dict->strings);
+    free(dict->hashes);
+    free(dict->slots);
+    memset(dict, 0, sizeof(StringDict));
+}
+
+// 查找字段值编号对应的倒排列表，不存在返回NULL
+PostingList *postingFind(PostingIndex *postings, int key) {
+    if (key < 0 || key >= postings->capacity) {
+        return NULL;
+    }
+    return &postings->lists[key];
+}
+
+// 获取字段值编号对应的倒排列表，不存在时扩充列表表，失败返回NULL
+PostingList *postingGet(PostingIndex *postings, int key) {
+    if (key < 0) {
+        return NULL;
+    }
+    if (key >= postings->capacity) {
+        int newCapacity = postings->capacity == 0 ? 16 : postings->capacity;
+        while (newCapacity <= key) {
+            newCapacity *= 2;
+        }
+        PostingList *newLists = (PostingList *)realloc(postings->lists, sizeof(PostingList) * newCapacity);
+        if (newLists == NULL) {
+            return NULL;
+        }
+        memset(newLists + postings->capacity, 0, sizeof(PostingList) * (size_t)(newCapacity - postings->capacity));
+        postings->lists = newLists;
+        postings->capacity = newCapacity;
+    }
+    return &postings->lists[key];
+}
+
+// 在倒排列表中二分查找学生下标应处的位置
+int postingLowerBound(const PostingList *list, int studentIndex) {
+    int low = 0, high = list->count;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (list->items[mid] < studentIndex) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// 把学生下标加入字段值的倒排列表（保持升序，新学生直接追加在末尾），成功返回1
+int postingAdd(PostingIndex *postings, int key, int studentIndex) {
+    PostingList *list = postingGet(postings, key);
+    if (list == NULL) {
+        return 0;
+    }
+    if (list->count >= list->capacity) {
+        int newCapacity = list->capacity == 0 ? 8 : list->capacity * 2;
+        int *newItems = (int *)realloc(list->items, sizeof(int) * newCapacity);
+        if (newItems == NULL) {
+            return 0;
+        }
+        list->items = newItems;
+        list->capacity = newCapacity;
+    }
+    int pos = list->count == 0 || list->items[list->count - 1] < studentIndex
+                  ? list->count : postingLowerBound(list, studentIndex);
+    memmove(list->items + pos + 1, list->items + pos, sizeof(int) * (size_t)(list->count - pos));
+    list->items[pos] = studentIndex;
+    list->count++;
+    return 1;
+}
+
+// 从字段值的倒排列表中移除学生下标
+void postingRemove(PostingIndex *postings, int key, int studentIndex) {
+    PostingList *list = postingFind(postings, key);
+    if (list == NULL) {
+        return;
+    }
+    int pos = postingLowerBound(list, studentIndex);
+    if (pos < list->count && list->items[pos] == studentIndex) {
+        memmove(list->items + pos, list->items + pos + 1, sizeof(int) * (size_t)(list->count - pos - 1));
+        list->count--;
+    }
+}
+
+// 压缩学生存储时，去掉所有列表中已删除的学生（remap 为-1），其余下标按映射表改写
+// 映射保持先后顺序，列表仍然升序；小于 first（第一个删除的下标）的部分不变，直接跳过
+void postingRemap(PostingIndex *postings, const int *remap, int first) {
+    for (int i = 0; i < postings->capacity; i++) {
+        PostingList *list = &postings->lists[i];
+        int kept = postingLowerBound(list, first);
+        for (int j = kept; j < list->count; j++) {
+            int to = remap[list->items[j]];
+            if (to != -1) {
+                list->items[kept++] = to;
+            }
+        }
+        list->count = kept;
+    }
+}
+
+// 释放倒排索引
+void postingFree(PostingIndex *postings) {
+    for (int i = 0; i < postings->capacity; i++) {
+        free(postings->lists[i].items);
+    }
+    free(postings->lists);
+    postings->lists = NULL;
+    postings->capacity = 0;
+}
+
+// 把学生加入专业、院系、班级倒排索引、姓名字元索引、总分排行和成绩分布
+void indexStudent(StudentManager *manager, int index) {
+    const Student *student = getStudent(manager, index);
+    postingAdd(&manager->majorIndex, student->majorId, index);
+    postingAdd(&manager->departmentIndex, student->departmentId, index);
+    postingAdd(&manager->classIndex, student->classId, index);
+    indexStudentName(manager, index);
+    indexStudentScores(manager, index);
+}
+
+// 把学生从专业、院系、班级倒排索引、姓名字元索引、总分排行和成绩分布中移除（修改这些字段前调用）
+void unindexStudent(StudentManager *manager, int index) {
+    const Student *student = getStudent(manager, index);
+    postingRemove(&manager->majorIndex, student->majorId, index);
+    postingRemove(&manager->departmentIndex, student->departmentId, index);
+    postingRemove(&manager->classIndex, student->classId, index);
+    unindexStudentName(manager, index);
+    unindexStudentScores(manager, index);
+}
+
+// 在升序列表 items[from..count) 中倍增查找第一个不小于 value 的位置
+int gallopLowerBound(const int *items, int from, int count, int value) {
+    int step = 1;
+    int high = from;
+    while (high < count && items[high] < value) {
+        from = high + 1;
+        high += step;
+        step *= 2;
+    }
+    if (high > count) {
+        high = count;
+    }
+    while (from < high) {
+        int mid = from + (high - from) / 2;
+        if (items[mid] < value) {
+            from = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return from;
+}
+
+// 求多个倒排列表的交集（结果升序写入 result，容量不小于最短列表长度），返回交集大小
+// 以最短列表为基准，在其余列表中倍增查找，耗时与最短列表长度成正比
+int intersectPostings(const PostingList **lists, int listCount, int *result) {
+    if (listCount == 0) {
+        return 0;
+    }
+    int shortest = 0;
+    for (int i = 1; i < listCount; i++) {
+        if (lists[i]->count < lists[shortest]->count) {
+            shortest = i;
+        }
+    }
+    
+    int cursors[8] = {0};
+    int matched = 0;
+    const PostingList *base = lists[shortest];
+    for (int j = 0; j < base->count; j++) {
+        int value = base->items[j];
+        int inAll = 1;
+        for (int i = 0; i < listCount && i < 8; i++) {
+            if (i == shortest) {
+                continue;
+            }
+            cursors[i] = gallopLowerBound(lists[i]->items, cursors[i], lists[i]->count, value);
+            if (cursors[i] >= lists[i]->count) {
+                return matched;
+            }
+            if (lists[i]->items[cursors[i]] != value) {
+                inAll = 0;
+                break;
+            }
+        }
+        if (inAll) {
+            result[matched++] = value;
+        }
+    }
+    return matched;
+}
+
+// 按专业、院系、班级组合筛选（参数为NULL表示不限），返回匹配的学生下标数组（升序，需调用者释放）
+// 全部不限时返回NULL且 *count 为学生总数；出错时返回NULL且 *count 为-1
+int *filterStudents(StudentManager *manager, const char *major, const char *department, const char *className, int *count) {
+    const PostingList *lists[3];
+    int listCount = 0;
+    const char *keys[3] = {major, department, className};
+    PostingIndex *indexes[3] = {&manager->majorIndex, &manager->departmentIndex, &manager->classIndex};
+    for (int i = 0; i < 3; i++) {
+        if (keys[i] == NULL) {
+            continue;
+        }
+        const PostingList *list = postingFind(indexes[i], dictLookup(&manager->strings, keys[i]));
+        if (list == NULL || list->count == 0) {
+            *count = 0;
+            return (int *)malloc(sizeof(int));
+        }
+        lists[listCount++] = list;
+    }
+    if (listCount == 0 && manager->deletedCount == 0) {
+        *count = manager->count;
+        return NULL;
+    }
+    // 有尚未压缩的空位时列出其余学生
+    if (listCount == 0) {
+        int *result = (int *)malloc(sizeof(int) * (size_t)(manager->count > 0 ? manager->count : 1));
+        if (result == NULL) {
+            *count = -1;
+            return NULL;
+        }
+        *count = 0;
+        for (int i = 0; i < manager->count; i++) {
+            if (!getStudent(manager, i)->deleted) {
+                result[(*count)++] = i;
+            }
+        }
+        return result;
+    }
+    
+    int capacity = lists[0]->count;
+    for (int i = 1; i < listCount; i++) {
+        if (lists[i]->count < capacity) {
+            capacity = lists[i]->count;
+        }
+    }
+    int *result = (int *)malloc(sizeof(int) * (size_t)capacity);
+    if (result == NULL) {
+        *count = -1;
+        return NULL;
+    }
+    *count = listCount == 1 ? lists[0]->count : intersectPostings(lists, listCount, result);
+    if (listCount == 1) {
+        memcpy(result, lists[0]->items, sizeof(int) * (size_t)lists[0]->count);
+    }
+    return result;
+}
+
+// 取 UTF-8 字符的字节数（按首字节判断，字符不完整或首字节非法时按1字节处理）
+int utf8CharLength(const char *text) {
+    const unsigned char *p = (const unsigned char *)text;
+    int length = *p < 0x80 ? 1 : (*p & 0xE0) == 0xC0 ? 2 : (*p & 0xF0) == 0xE0 ? 3 : (*p & 0xF8) == 0xF0 ? 4 : 1;
+    for (int i = 1; i < length; i++) {
+        if ((p[i] & 0xC0) != 0x80) {
+            return 1;
+        }
+    }
+    return length;
+}
+
+// 把姓名拆成字元编号：单字与相邻两字组成的二元组各一个，去重后写入 keys，返回个数
+// intern 为1时把新的字元登记进字典（建索引用）；为0时只查找，遇到字典中没有的字元返回-1（必然无匹配）
+// 查询时 onlyLongest 为1：两字及以上的查询只需二元组，单字查询用单字
+int nameGramKeys(StringDict *grams, const char *name, int *keys, int intern, int onlyLongest) {
+    int starts[NAME_GRAM_MAX + 1];
+    int charCount = 0;
+    int pos = 0;
+    while (name[pos] != '\0' && charCount < NAME_GRAM_MAX) {
+        starts[charCount++] = pos;
+        pos += utf8CharLength(name + pos);
+    }
+    starts[charCount] = pos;
+    
+    int keyCount = 0;
+    for (int width = 1; width <= 2; width++) {
+        if (onlyLongest && width == 1 && charCount >= 2) {
+            continue;
+        }
+        for (int i = 0; i + width <= charCount; i++) {
+            char gram[9];
+            int length = starts[i + width] - starts[i];
+            memcpy(gram, name + starts[i], (size_t)length);
+            gram[length] = '\0';
+            int key = intern ? dictIntern(grams, gram) : dictLookup(grams, gram);
+            if (key == -1) {
+                return -1;
+            }
+            int seen = 0;
+            for (int k = 0; k < keyCount && !seen; k++) {
+                seen = keys[k] == key;
+            }
+            if (!seen) {
+                keys[keyCount++] = key;
+            }
+        }
+    }
+    return keyCount;
+}
+
+// 整个姓名也作为一个键（加不可输入的前缀与字元区分），直接取出姓名完全相同的学生
+// intern 含义同 nameGramKeys，字典中没有时返回-1
+int nameExactKey(StringDict *grams, const char *name, int intern) {
+    char key[NAME_GRAM_MAX * 4 + 2];
+    size_t length = strlen(name);
+    if (length > sizeof(key) - 2) {
+        return -1;
+    }
+    key[0] = '\x01';
+    memcpy(key + 1, name, length + 1);
+    return intern ? dictIntern(grams, key) : dictLookup(grams, key);
+}
+
+// 把学生加入姓名字元索引和拼音索引
+void indexStudentName(StudentManager *manager, int index) {
+    const char *name = getStudent(manager, index)->name;
+    int keys[NAME_GRAM_MAX * 2 + 1];
+    int keyCount = nameGramKeys(&manager->nameGrams, name, keys, 1, 0);
+    int exactKey = nameExactKey(&manager->nameGrams, name, 1);
+    if (keyCount > 0 && exactKey != -1) {
+        keys[keyCount++] = exactKey;
+    }
+    for (int i = 0; i < keyCount; i++) {
+        postingAdd(&manager->nameIndex, keys[i], index);
+    }
+    indexStudentPinyin(manager, index);
+}
+
+// 与 indexStudentName 相同，但同一姓名的字元键和拼音键只计算一次，记在 cache 中供同名学生直接使用
+void indexStudentNameCached(StudentManager *manager, int index, NameKeyCache *cache) {
+    const char *name = getStudent(manager, index)->name;
+    int exactKey = nameExactKey(&manager->nameGrams, name, 1);
+    if (exactKey == -1) {
+        indexStudentName(manager, index);
+        return;
+    }
+    if (exactKey < cache->startCapacity && cache->start[exactKey] != -1) {
+        const int *keys = cache->keys + cache->start[exactKey];
+        for (int i = 1; i <= keys[0]; i++) {
+            postingAdd(&manager->nameIndex, keys[i], index);
+        }
+        const int *pinyin = keys + keys[0] + 1;
+        for (int i = 1; i <= pinyin[0]; i++) {
+            postingAdd(&manager->pinyinIndex, pinyin[i], index);
+        }
+        return;
+    }
+    
+    // 第一次遇到这个姓名：与 indexStudentName 一样登记各键，同时记下键编号
+    int keys[NAME_GRAM_MAX * 2 + 5];
+    int keyCount = nameGramKeys(&manager->nameGrams, name, keys + 1, 1, 0);
+    if (keyCount > 0) {
+        keys[1 + keyCount++] = exactKey;
+    } else {
+        keyCount = 0;
+    }
+    keys[0] = keyCount;
+    for (int i = 1; i <= keyCount; i++) {
+        postingAdd(&manager->nameIndex, keys[i], index);
+    }
+    int *pinyin = keys + keyCount + 1;
+    pinyin[0] = 0;
+    char full[PINYIN_KEY_SIZE], initials[PINYIN_KEY_SIZE];
+    namePinyinKeys(name, full, sizeof(full), initials, sizeof(initials));
+    const char *pinyinTexts[2] = {full, initials};
+    for (int k = 0; k < (strcmp(full, initials) != 0 ? 2 : 1); k++) {
+        pinyinIndexAdd(manager, pinyinTexts[k], index);
+        int id = pinyinTexts[k][0] != '\0' ? dictLookup(&manager->pinyinKeys, pinyinTexts[k]) : -1;
+        if (id != -1) {
+            pinyin[++pinyin[0]] = id;
+        }
+    }
+    
+    // 记入缓存；内存不足时不记，同名学生再遇到时重新计算
+    int length = keyCount + pinyin[0] + 2;
+    if (exactKey >= cache->startCapacity) {
+        int newCapacity = cache->startCapacity == 0 ? 1024 : cache->startCapacity;
+        while (newCapacity <= exactKey) {
+            newCapacity *= 2;
+        }
+        int *newStart = (int *)realloc(cache->start, sizeof(int) * (size_t)newCapacity);
+        if (newStart == NULL) {
+            return;
+        }
+        for (int i = cache->startCapacity; i < newCapacity; i++) {
+            newStart[i] = -1;
+        }
+        cache->start = newStart;
+        cache->startCapacity = newCapacity;
+    }
+    if (cache->keyCount + length > cache->keyCapacity) {
+        int newCapacity = cache->keyCapacity == 0 ? 4096 : cache->keyCapacity * 2;
+        while (newCapacity < cache->keyCount + length) {
+            newCapacity *= 2;
+        }
+        int *newKeys = (int *)realloc(cache->keys, sizeof(int) * (size_t)newCapacity);
+        if (newKeys == NULL) {
+            return;
+        }
+        cache->keys = newKeys;
+        cache->keyCapacity = newCapacity;
+    }
+    memcpy(cache->keys + cache->keyCount, keys, sizeof(int) * (size_t)length);
+    cache->start[exactKey] = cache->keyCount;
+    cache->keyCount += length;
+}
+
+// 把学生从姓名字元索引和拼音索引中移除（修改姓名前调用）
+void unindexStudentName(StudentManager *manager, int index) {
+    const char *name = getStudent(manager, index)->name;
+    int keys[NAME_GRAM_MAX * 2 + 1];
+    int keyCount = nameGramKeys(&manager->nameGrams, name, keys, 0, 0);
+    int exactKey = nameExactKey(&manager->nameGrams, name, 0);
+    if (keyCount > 0 && exactKey != -1) {
+        keys[keyCount++] = exactKey;
+    }
+    for (int i = 0; i < keyCount; i++) {
+        postingRemove(&manager->nameIndex, keys[i], index);
+    }
+    unindexStudentPinyin(manager, index);
+}
+
+// 按姓名查找全部匹配的学生：姓名完全相同的排在前面，其后是包含该文本的，两组内各按下标升序
+// 返回学生下标数组（需调用者释放），*count 为匹配数；出错时返回NULL且 *count 为-1
+// 先求查询文本各字元倒排列表的交集得到候选；查询不超过两个字时候选即为结果，
+// 更长的查询再逐个核对（二元组都出现不代表连续出现）
+int *findStudentsByName(StudentManager *manager, const char *name, int *count) {
+    int keys[NAME_GRAM_MAX * 2];
+    int keyCount = nameGramKeys(&manager->nameGrams, name, keys, 0, 1);
+    const PostingList *lists[8];
+    int listCount = 0;
+    for (int i = 0; i < keyCount; i++) {
+        const PostingList *list = postingFind(&manager->nameIndex, keys[i]);
+        if (list == NULL || list->count == 0) {
+            keyCount = -1;
+            break;
+        }
+        // 交集最多取8个列表，保留最短的几个（其余字元由逐个核对保证）
+        if (listCount < 8) {
+            lists[listCount++] = list;
+        } else {
+            int longest = 0;
+            for (int j = 1; j < listCount; j++) {
+                if (lists[j]->count > lists[longest]->count) {
+                    longest = j;
+                }
+            }
+            if (list->count < lists[longest]->count) {
+                lists[longest] = list;
+            }
+        }
+    }
+    if (keyCount <= 0) {
+        *count = 0;
+        return (int *)malloc(sizeof(int));
+    }
+    
+    int capacity = lists[0]->count;
+    for (int i = 1; i < listCount; i++) {
+        if (lists[i]->count < capacity) {
+            capacity = lists[i]->count;
+        }
+    }
+    int *candidates = (int *)malloc(sizeof(int) * (size_t)capacity);
+    int *result = (int *)malloc(sizeof(int) * (size_t)capacity);
+    if (candidates == NULL || result == NULL) {
+        free(candidates);
+        free(result);
+        *count = -1;
+        return NULL;
+    }
+    int candidateCount = listCount == 1 ? lists[0]->count : intersectPostings(lists, listCount, candidates);
+    const int *source = listCount == 1 ? lists[0]->items : candidates;
+    
+    // 姓名完全相同的学生直接取自整名键的列表，放在最前面
+    const PostingList *exact = postingFind(&manager->nameIndex, nameExactKey(&manager->nameGrams, name, 0));
+    int exactCount = exact != NULL ? exact->count : 0;
+    if (exactCount > 0) {
+        memcpy(result, exact->items, sizeof(int) * (size_t)exactCount);
+    }
+    
+    // 其余候选：跳过已列出的完全相同者；仅包含的先暂存在 candidates 中（写入位置不会超过读取位置）
+    int firstLength = utf8CharLength(name);
+    int shortQuery = name[firstLength] == '\0' || name[firstLength + utf8CharLength(name + firstLength)] == '\0';
+    int partialCount = 0;
+    int exactCursor = 0;
+    for (int i = 0; i < candidateCount; i++) {
+        int index = source[i];
+        while (exactCursor < exactCount && exact->items[exactCursor] < index) {
+            exactCursor++;
+        }
+        if (exactCursor < exactCount && exact->items[exactCursor] == index) {
+            continue;
+        }
+        if (shortQuery || strstr(getStudent(manager, index)->name, name) != NULL) {
+            candidates[partialCount++] = index;
+        }
+    }
+    memcpy(result + exactCount, candidates, sizeof(int) * (size_t)partialCount);
+    free(candidates);
+    *count = exactCount + partialCount;
+    return result;
+}
+
+// 拼音表：GB2312 一级汉字（按拼音排列）及常见的姓名用字。多音字取一级汉字表中的读音
+static const PinyinSyllable pinyinSyllables[] = {
+    {"a", "啊阿"},
+    {"ai", "埃挨哎唉哀皑癌蔼矮艾碍爱隘嫒"},
+    {"an", "鞍氨安俺按暗岸胺案"},
+    {"ang", "肮昂盎"},
+    {"ao", "凹敖熬翱袄傲奥懊澳"},
+    {"ba", "芭捌扒叭吧笆八疤巴拔跋靶把耙坝霸罢爸"},
+    {"bai", "白柏百摆佰败拜稗"},
+    {"ban", "斑班搬扳般颁板版扮拌伴瓣半办绊"},
+    {"bang", "邦帮梆榜膀绑棒磅蚌镑傍谤"},
+    {"bao", "苞胞包褒剥薄雹保堡饱宝抱报暴豹鲍爆"},
+    {"bei", "杯碑悲卑北辈背贝钡倍狈备惫焙被蓓"},
+    {"ben", "奔苯本笨贲"},
+    {"beng", "崩绷甭泵蹦迸"},
+    {"bi", "逼鼻比鄙笔彼碧蓖蔽毕毙毖币庇痹闭敝弊必辟壁臂避陛璧"},
+    {"bian", "鞭边编贬扁便变卞辨辩辫遍"},
+    {"biao", "标彪膘表"},
+    {"bie", "鳖憋别瘪"},
+    {"bin", "彬斌濒滨宾摈"},
+    {"bing", "兵冰柄丙秉饼炳病并邴"},
+    {"bo", "玻菠播拨钵波博勃搏铂箔伯帛舶脖膊渤泊驳"},
+    {"bu", "捕卜哺补埠不布步簿部怖"},
+    {"ca", "擦"},
+    {"cai", "猜裁材才财睬踩采彩菜蔡"},
+    {"can", "餐参蚕残惭惨灿璨"},
+    {"cang", "苍舱仓沧藏"},
+    {"cao", "操糙槽曹草"},
+    {"ce", "厕策侧册测"},
+    {"cen", "岑"},
+    {"ceng", "层蹭"},
+    {"cha", "插叉茬茶查碴搽察岔差诧"},
+    {"chai", "拆柴豺"},
+    {"chan", "搀掺蝉馋谗缠铲产阐颤婵"},
+    {"chang", "昌猖场尝常长偿肠厂敞畅唱倡嫦"},
+    {"chao", "超抄钞朝嘲潮巢吵炒"},
+    {"che", "车扯撤掣彻澈"},
+    {"chen", "郴臣辰尘晨忱沉陈趁衬琛宸谌"},
+    {"cheng", "撑称城橙成呈乘程惩澄诚承逞骋秤铖"},
+    {"chi", "吃痴持匙池迟弛驰耻齿侈尺赤翅斥炽"},
+    {"chong", "充冲虫崇宠"},
+    {"chou", "抽酬畴踌稠愁筹仇绸瞅丑臭"},
+    {"chu", "初出橱厨躇锄雏滁除楚础储矗搐触处褚"},
+    {"chuai", "揣"},
+    {"chuan", "川穿椽传船喘串"},
+    {"chuang", "疮窗幢床闯创"},
+    {"chui", "吹炊捶锤垂"},
+    {"chun", "春椿醇唇淳纯蠢"},
+    {"chuo", "戳绰"},
+    {"ci", "疵茨磁雌辞慈瓷词此刺赐次"},
+    {"cong", "聪葱囱匆从丛琮"},
+    {"cou", "凑"},
+    {"cu", "粗醋簇促"},
+    {"cuan", "蹿篡窜"},
+    {"cui", "摧崔催脆瘁粹淬翠"},
+    {"cun", "村存寸"},
+    {"cuo", "磋撮搓措挫错"},
+    {"da", "搭达答瘩打大"},
+    {"dai", "呆歹傣戴带殆代贷袋待逮怠黛"},
+    {"dan", "耽担丹单郸掸胆旦氮但惮淡诞弹蛋"},
+    {"dang", "当挡党荡档"},
+    {"dao", "刀捣蹈倒岛祷导到稻悼道盗"},
+    {"de", "德得的"},
+    {"deng", "蹬灯登等瞪凳邓"},
+    {"di", "堤低滴迪敌笛狄涤翟嫡抵底地蒂第帝弟递缔邸"},
+    {"dian", "颠掂滇碘点典靛垫电佃甸店惦奠淀殿"},
+    {"diao", "碉叼雕凋刁掉吊钓调"},
+    {"die", "跌爹碟蝶迭谍叠"},
+    {"ding", "丁盯叮钉顶鼎锭定订"},
+    {"diu", "丢"},
+    {"dong", "东冬董懂动栋侗恫冻洞"},
+    {"dou", "兜抖斗陡豆逗痘"},
+    {"du", "都督毒犊独读堵睹赌杜镀肚度渡妒"},
+    {"duan", "端短锻段断缎"},
+    {"dui", "堆兑队对"},
+    {"dun", "墩吨蹲敦顿囤钝盾遁"},
+    {"duo", "掇哆多夺垛躲朵跺舵剁惰堕铎"},
+    {"e", "蛾峨鹅俄额讹娥恶厄扼遏鄂饿"},
+    {"en", "恩嗯"},
+    {"er", "而儿耳尔饵洱二贰"},
+    {"fa", "发罚筏伐乏阀法珐"},
+    {"fan", "藩帆番翻樊矾钒繁凡烦反返范贩犯饭泛梵"},
+    {"fang", "坊芳方肪房防妨仿访纺放"},
+    {"fei", "菲非啡飞肥匪诽吠肺废沸费斐霏"},
+    {"fen", "芬酚吩氛分纷坟焚汾粉奋份忿愤粪"},
+    {"feng", "丰封枫蜂峰锋风疯烽逢冯缝讽奉凤酆"},
+    {"fo", "佛"},
+    {"fou", "否"},
+    {"fu", "夫敷肤孵扶拂辐幅氟符伏俘服浮涪福袱弗甫抚辅俯釜斧脯腑府腐赴副"
+            "覆赋复傅付阜父腹负富讣附妇缚咐馥苻"},
+    {"ga", "噶嘎"},
+    {"gai", "该改概钙盖溉"},
+    {"gan", "干甘杆柑竿肝赶感秆敢赣"},
+    {"gang", "冈刚钢缸肛纲岗港杠"},
+    {"gao", "篙皋高膏羔糕搞镐稿告郜"},
+    {"ge", "哥歌搁戈鸽胳疙割革葛格蛤阁隔铬个各"},
+    {"gei", "给"},
+    {"gen", "根跟"},
+    {"geng", "耕更庚羹埂耿梗"},
+    {"gong", "工攻功恭龚供躬公宫弓巩汞拱贡共"},
+    {"gou", "钩勾沟苟狗垢构购够缑"},
+    {"gu", "辜菇咕箍估沽孤姑鼓古蛊骨谷股故顾固雇"},
+    {"gua", "刮瓜剐寡挂褂"},
+    {"guai", "乖拐怪"},
+    {"guan", "棺关官冠观管馆罐惯灌贯"},
+    {"guang", "光广逛"},
+    {"gui", "瑰规圭硅归龟闺轨鬼诡癸桂柜跪贵刽妫"},
+    {"gun", "辊滚棍"},
+    {"guo", "锅郭国果裹过"},
+    {"ha", "哈"},
+    {"hai", "骸孩海氦亥害骇"},
+    {"han", "酣憨邯韩含涵寒函喊罕翰撼捍旱憾悍焊汗汉晗菡瀚"},
+    {"hang", "夯杭航"},
+    {"hao", "壕嚎豪毫郝好耗号浩昊灏皓颢濠"},
+    {"he", "呵喝荷菏核禾和何合盒貉阂河涸赫褐鹤贺"},
+    {"hei", "嘿黑"},
+    {"hen", "痕很狠恨"},
+    {"heng", "哼亨横衡恒珩蘅"},
+    {"hong", "轰哄烘虹鸿洪宏弘红泓"},
+    {"hou", "喉侯猴吼厚候后"},
+    {"hu", "呼乎忽瑚壶葫胡蝴狐糊湖弧虎唬护互沪户扈"},
+    {"hua", "花哗华猾滑画划化话桦"},
+    {"huai", "槐徊怀淮坏"},
+    {"huan", "欢环桓还缓换患唤痪豢焕涣宦幻寰"},
+    {"huang", "荒慌黄磺蝗簧皇凰惶煌晃幌恍谎"},
+    {"hui", "灰挥辉徽恢蛔回毁悔慧卉惠晦贿秽会烩汇讳诲绘荟晖"},
+    {"hun", "荤昏婚魂浑混"},
+    {"huo", "豁活伙火获或惑霍货祸"},
+    {"ji", "击圾基机畸稽积箕肌饥迹激讥鸡姬绩缉吉极棘辑籍集及急疾汲即嫉级"
+            "挤几脊己蓟技冀季伎祭剂悸济寄寂计记既忌际妓继纪暨"},
+    {"jia", "嘉枷夹佳家加荚颊贾甲钾假稼价架驾嫁珈郏"},
+    {"jian", "歼监坚尖笺间煎兼肩艰奸缄茧检柬碱硷拣捡简俭剪减荐槛鉴践贱见键"
+            "箭件健舰剑饯渐溅涧建"},
+    {"jiang", "僵姜将浆江疆蒋桨奖讲匠酱降"},
+    {"jiao", "蕉椒礁焦胶交郊浇骄娇嚼搅铰矫侥脚狡角饺缴绞剿教酵轿较叫窖姣"},
+    {"jie", "揭接皆秸街阶截劫节桔杰捷睫竭洁结解姐戒藉芥界借介疥诫届婕"},
+    {"jin", "巾筋斤金今津襟紧锦仅谨进靳晋禁近烬浸尽劲瑾槿"},
+    {"jing", "荆兢茎睛晶鲸京惊精粳经井警景颈静境敬镜径痉靖竟竞净婧菁璟"},
+    {"jiong", "炯窘炅"},
+    {"jiu", "揪究纠玖韭久灸九酒厩救旧臼舅咎就疚"},
+    {"ju", "鞠拘狙疽居驹菊局咀矩举沮聚拒据巨具距踞锯俱句惧炬剧琚"},
+    {"juan", "捐鹃娟倦眷卷绢"},
+    {"jue", "撅攫抉掘倔爵觉决诀绝珏"},
+    {"jun", "均菌钧军君峻俊竣浚郡骏珺隽"},
+    {"ka", "喀咖卡咯"},
+    {"kai", "开揩楷凯慨锴"},
+    {"kan", "刊堪勘坎砍看阚"},
+    {"kang", "康慷糠扛抗亢炕"},
+    {"kao", "考拷烤靠"},
+    {"ke", "坷苛柯棵磕颗科壳咳可渴克刻客课珂"},
+    {"ken", "肯啃垦恳"},
+    {"keng", "坑吭"},
+    {"kong", "空恐孔控"},
+    {"kou", "抠口扣寇"},
+    {"ku", "枯哭窟苦酷库裤"},
+    {"kua", "夸垮挎跨胯"},
+    {"kuai", "块筷侩快蒯"},
+    {"kuan", "宽款"},
+    {"kuang", "匡筐狂框矿眶旷况邝"},
+    {"kui", "亏盔岿窥葵奎魁傀馈愧溃"},
+    {"kun", "坤昆捆困琨"},
+    {"kuo", "括扩廓阔"},
+    {"la", "垃拉喇蜡腊辣啦"},
+    {"lai", "莱来赖"},
+    {"lan", "蓝婪栏拦篮阑兰澜谰揽览懒缆烂滥岚"},
+    {"lang", "琅榔狼廊郎朗浪"},
+    {"lao", "捞劳牢老佬姥酪烙涝"},
+    {"le", "勒乐"},
+    {"lei", "雷镭蕾磊累儡垒擂肋类泪"},
+    {"leng", "棱楞冷"},
+    {"li", "厘梨犁黎篱狸离漓理李里鲤礼莉荔吏栗丽厉励砾历利傈例俐痢立粒沥"
+            "隶力璃哩俪藜郦"},
+    {"lia", "俩"},
+    {"lian", "联莲连镰廉怜涟帘敛脸链恋炼练"},
+    {"liang", "粮凉梁粱良两辆量晾亮谅"},
+    {"liao", "撩聊僚疗燎寥辽潦了撂镣廖料"},
+    {"lie", "列裂烈劣猎"},
+    {"lin", "琳林磷霖临邻鳞淋凛赁吝拎麟蔺"},
+    {"ling", "玲菱零龄铃伶羚凌灵陵岭领另令苓"},
+    {"liu", "溜琉榴硫馏留刘瘤流柳六"},
+    {"long", "龙聋咙笼窿隆垄拢陇"},
+    {"lou", "楼娄搂篓漏陋"},
+    {"lu", "芦卢颅庐炉掳卤虏鲁麓碌露路赂鹿潞禄录陆戮璐"},
+    {"luan", "峦挛孪滦卵乱"},
+    {"lun", "抡轮伦仑沦纶论"},
+    {"luo", "萝螺罗逻锣箩骡裸落洛骆络"},
+    {"lv", "驴吕铝侣旅履屡缕虑氯律率滤绿闾"},
+    {"lve", "掠略"},
+    {"ma", "妈麻玛码蚂马骂嘛吗"},
+    {"mai", "埋买麦卖迈脉"},
+    {"man", "瞒馒蛮满蔓曼慢漫谩"},
+    {"mang", "芒茫盲氓忙莽"},
+    {"mao", "猫茅锚毛矛铆卯茂冒帽貌贸"},
+    {"me", "么"},
+    {"mei", "玫枚梅酶霉煤没眉媒镁每美昧寐妹媚"},
+    {"men", "门闷们"},
+    {"meng", "萌蒙檬盟锰猛梦孟"},
+    {"mi", "眯醚靡糜迷谜弥米秘觅泌蜜密幂宓"},
+    {"mian", "棉眠绵冕免勉娩缅面"},
+    {"miao", "苗描瞄藐秒渺庙妙淼缪"},
+    {"mie", "蔑灭"},
+    {"min", "民抿皿敏悯闽珉旻闵"},
+    {"ming", "明螟鸣铭名命茗"},
+    {"miu", "谬"},
+    {"mo", "摸摹蘑模膜磨摩魔抹末莫墨默沫漠寞陌"},
+    {"mou", "谋牟某拇"},
+    {"mu", "牡亩姆母墓暮幕募慕木目睦牧穆沐"},
+    {"na", "拿哪呐钠那娜纳"},
+    {"nai", "氖乃奶耐奈"},
+    {"nan", "南男难楠囡"},
+    {"nang", "囊"},
+    {"nao", "挠脑恼闹淖"},
+    {"ne", "呢"},
+    {"nei", "馁内"},
+    {"nen", "嫩"},
+    {"neng", "能"},
+    {"ni", "妮霓倪泥尼拟你匿腻逆溺"},
+    {"nian", "蔫拈年碾撵捻念"},
+    {"niang", "娘酿"},
+    {"niao", "鸟尿"},
+    {"nie", "捏聂孽啮镊镍涅"},
+    {"nin", "您"},
+    {"ning", "柠狞凝宁拧泞"},
+    {"niu", "牛扭钮纽"},
+    {"nong", "脓浓农弄"},
+    {"nu", "奴努怒"},
+    {"nuan", "暖"},
+    {"nuo", "挪懦糯诺"},
+    {"nv", "女"},
+    {"nve", "虐疟"},
+    {"o", "哦"},
+    {"ou", "欧鸥殴藕呕偶沤"},
+    {"pa", "啪趴爬帕怕琶"},
+    {"pai", "拍排牌徘湃派"},
+    {"pan", "攀潘盘磐盼畔判叛"},
+    {"pang", "乓庞旁耪胖逄"},
+    {"pao", "抛咆刨炮袍跑泡"},
+    {"pei", "呸胚培裴赔陪配佩沛"},
+    {"pen", "喷盆"},
+    {"peng", "砰抨烹澎彭蓬棚硼篷膨朋鹏捧碰芃"},
+    {"pi", "坯砒霹批披劈琵毗啤脾疲皮匹痞僻屁譬"},
+    {"pian", "篇偏片骗"},
+    {"piao", "飘漂瓢票"},
+    {"pie", "撇瞥"},
+    {"pin", "拼频贫品聘"},
+    {"ping", "乒坪苹萍平凭瓶评屏娉"},
+    {"po", "坡泼颇婆破魄迫粕"},
+    {"pou", "剖"},
+    {"pu", "扑铺仆莆葡菩蒲埔朴圃普浦谱曝瀑濮"},
+    {"qi", "期欺栖戚妻七凄漆柒沏其棋奇歧畦崎脐齐旗祈祁骑起岂乞企启契砌器"
+            "气迄弃汽泣讫琦琪淇祺麒绮骐亓"},
+    {"qia", "掐恰洽"},
+    {"qian", "牵扦钎铅千迁签仟谦乾黔钱钳前潜遣浅谴堑嵌欠歉倩骞茜芊"},
+    {"qiang", "枪呛腔羌墙蔷强抢"},
+    {"qiao", "橇锹敲悄桥瞧乔侨巧鞘撬翘峭俏窍"},
+    {"qie", "切茄且怯窃"},
+    {"qin", "钦侵亲秦琴勤芹擒禽寝沁"},
+    {"qing", "青轻氢倾卿清擎晴氰情顷请庆"},
+    {"qiong", "琼穷"},
+    {"qiu", "秋丘邱球求囚酋泅裘"},
+    {"qu", "趋区蛆曲躯屈驱渠取娶龋趣去瞿璩"},
+    {"quan", "圈颧权醛泉全痊拳犬券劝"},
+    {"que", "缺炔瘸却鹊榷确雀"},
+    {"qun", "裙群"},
+    {"ran", "然燃冉染苒"},
+    {"rang", "瓤壤攘嚷让"},
+    {"rao", "饶扰绕"},
+    {"re", "惹热"},
+    {"ren", "壬仁人忍韧任认刃妊纫"},
+    {"reng", "扔仍"},
+    {"ri", "日"},
+    {"rong", "戎茸蓉荣融熔溶容绒冗嵘榕"},
+    {"rou", "揉柔肉"},
+    {"ru", "茹蠕儒孺如辱乳汝入褥"},
+    {"ruan", "软阮"},
+    {"rui", "蕊瑞锐睿芮"},
+    {"run", "闰润"},
+    {"ruo", "若弱"},
+    {"sa", "撒洒萨飒"},
+    {"sai", "腮鳃塞赛"},
+    {"san", "三叁伞散"},
+    {"sang", "桑嗓丧"},
+    {"sao", "搔骚扫嫂"},
+    {"se", "瑟色涩"},
+    {"sen", "森"},
+    {"seng", "僧"},
+    {"sha", "莎砂杀刹沙纱傻啥煞"},
+    {"shai", "筛晒"},
+    {"shan", "珊苫杉山删煽衫闪陕擅赡膳善汕扇缮姗"},
+    {"shang", "墒伤商赏晌上尚裳"},
+    {"shao", "梢捎稍烧芍勺韶少哨邵绍"},
+    {"she", "奢赊蛇舌舍赦摄射慑涉社设"},
+    {"shen", "砷申呻伸身深娠绅神沈审婶甚肾慎渗珅燊莘"},
+    {"sheng", "声生甥牲升绳省盛剩胜圣晟"},
+    {"shi", "师失狮施湿诗尸虱十石拾时什食蚀实识史矢使屎驶始式示士世柿事拭"
+            "誓逝势是嗜噬适仕侍释饰氏市恃室视试"},
+    {"shou", "收手首守寿授售受瘦兽"},
+    {"shu", "蔬枢梳殊抒输叔舒淑疏书赎孰熟薯暑曙署蜀黍鼠属术述树束戍竖墅庶"
+            "数漱恕姝澍"},
+    {"shua", "刷耍"},
+    {"shuai", "摔衰甩帅"},
+    {"shuan", "栓拴"},
+    {"shuang", "霜双爽"},
+    {"shui", "谁水睡税"},
+    {"shun", "吮瞬顺舜"},
+    {"shuo", "说硕朔烁"},
+    {"si", "斯撕嘶思私司丝死肆寺嗣四伺似饲巳"},
+    {"song", "松耸怂颂送宋讼诵崧淞"},
+    {"sou", "搜艘擞嗽"},
+    {"su", "苏酥俗素速粟僳塑溯宿诉肃"},
+    {"suan", "酸蒜算"},
+    {"sui", "虽隋随绥髓碎岁穗遂隧祟"},
+    {"sun", "孙损笋"},
+    {"suo", "蓑梭唆缩琐索锁所"},
+    {"ta", "塌他它她塔獭挞蹋踏"},
+    {"tai", "胎苔抬台泰酞太态汰邰"},
+    {"tan", "坍摊贪瘫滩坛檀痰潭谭谈坦毯袒碳探叹炭"},
+    {"tang", "汤塘搪堂棠膛唐糖倘躺淌趟烫瑭"},
+    {"tao", "掏涛滔绦萄桃逃淘陶讨套韬"},
+    {"te", "特"},
+    {"teng", "藤腾疼誊滕"},
+    {"ti", "梯剔踢锑提题蹄啼体替嚏惕涕剃屉"},
+    {"tian", "天添填田甜恬舔腆"},
+    {"tiao", "挑条迢眺跳"},
+    {"tie", "贴铁帖"},
+    {"ting", "厅听烃汀廷停亭庭挺艇婷"},
+    {"tong", "通桐酮瞳同铜彤童桶捅筒统痛潼佟"},
+    {"tou", "偷投头透"},
+    {"tu", "凸秃突图徒途涂屠土吐兔"},
+    {"tuan", "湍团"},
+    {"tui", "推颓腿蜕褪退"},
+    {"tun", "吞屯臀"},
+    {"tuo", "拖托脱鸵陀驮驼椭妥拓唾"},
+    {"wa", "挖哇蛙洼娃瓦袜"},
+    {"wai", "歪外"},
+    {"wan", "豌弯湾玩顽丸烷完碗挽晚皖惋宛婉万腕琬"},
+    {"wang", "汪王亡枉网往旺望忘妄"},
+    {"wei", "威巍微危韦违桅围唯惟为潍维苇萎委伟伪尾纬未蔚味畏胃喂魏位渭谓"
+            "尉慰卫炜薇玮葳隗"},
+    {"wen", "瘟温蚊文闻纹吻稳紊问雯"},
+    {"weng", "嗡翁瓮"},
+    {"wo", "挝蜗涡窝我斡卧握沃"},
+    {"wu", "巫呜钨乌污诬屋无芜梧吾吴毋武五捂午舞伍侮坞戊雾晤物勿务悟误邬"},
+    {"xi", "昔熙析西硒矽晰嘻吸锡牺稀息希悉膝夕惜熄烯溪汐犀檄袭席习媳喜铣"
+            "洗系隙戏细曦禧羲熹玺郗"},
+    {"xia", "瞎虾匣霞辖暇峡侠狭下厦夏吓瑕"},
+    {"xian", "掀锨先仙鲜纤咸贤衔舷闲涎弦嫌显险现献县腺馅羡宪陷限线娴冼"},
+    {"xiang", "相厢镶香箱襄湘乡翔祥详想响享项巷橡像向象"},
+    {"xiao", "萧硝霄削哮嚣销消宵淆晓小孝校肖啸笑效潇骁箫筱"},
+    {"xie", "楔些歇蝎鞋协挟携邪斜胁谐写械卸蟹懈泄泻谢屑"},
+    {"xin", "薪芯锌欣辛新忻心信衅昕馨鑫歆"},
+    {"xing", "星腥猩惺兴刑型形邢行醒幸杏性姓"},
+    {"xiong", "兄凶胸匈汹雄熊"},
+    {"xiu", "休修羞朽嗅锈秀袖绣"},
+    {"xu", "墟戌需虚嘘须徐许蓄酗叙旭序畜恤絮婿绪续栩诩"},
+    {"xuan", "轩喧宣悬旋玄选癣眩绚萱璇瑄暄泫炫煊"},
+    {"xue", "靴薛学穴雪血"},
+    {"xun", "勋熏循旬询寻驯巡殉汛训讯逊迅洵荀"},
+    {"ya", "压押鸦鸭呀丫芽牙蚜崖衙涯雅哑亚讶娅"},
+    {"yan", "焉咽阉烟淹盐严研蜒岩延言颜阎炎沿奄掩眼衍演艳堰燕厌砚雁唁彦焰"
+            "宴谚验琰嫣妍焱鄢晏闫"},
+    {"yang", "殃央鸯秧杨扬佯疡羊洋阳氧仰痒养样漾炀"},
+    {"yao", "邀腰妖瑶摇尧遥窑谣姚咬舀药要耀曜"},
+    {"ye", "椰噎耶爷野冶也页掖业叶曳腋夜液烨晔"},
+    {"yi", "一壹医揖铱依伊衣颐夷遗移仪胰疑沂宜姨彝椅蚁倚已乙矣以艺抑易邑"
+            "屹亿役臆逸肄疫亦裔意毅忆义益溢诣议谊译异翼翌绎祎弈奕熠漪翊羿"
+            "苡薏怡懿"},
+    {"yin", "茵荫因殷音阴姻吟银淫寅饮尹引隐印"},
+    {"ying", "英樱婴鹰应缨莹萤营荧蝇迎赢盈影颖硬映滢瑛萦"},
+    {"yo", "哟"},
+    {"yong", "拥佣臃痈庸雍踊蛹咏泳涌永恿勇用"},
+    {"you", "幽优悠忧尤由邮铀犹油游酉有友右佑釉诱又幼"},
+    {"yu", "迂淤于盂榆虞愚舆余俞逾鱼愉渝渔隅予娱雨与屿禹宇语羽玉域芋郁吁"
+            "遇喻峪御愈欲狱育誉浴寓裕预豫驭钰瑜昱煜彧毓聿瑀於"},
+    {"yuan", "鸳渊冤元垣袁原援辕园员圆猿源缘远苑愿怨院媛瑗"},
+    {"yue", "曰约越跃钥岳粤月悦阅玥樾"},
+    {"yun", "耘云郧匀陨允运蕴酝晕韵孕筠芸昀"},
+    {"za", "匝砸杂"},
+    {"zai", "栽哉灾宰载再在"},
+    {"zan", "咱攒暂赞瓒昝"},
+    {"zang", "赃脏葬"},
+    {"zao", "遭糟凿藻枣早澡蚤躁噪造皂灶燥"},
+    {"ze", "责择则泽"},
+    {"zei", "贼"},
+    {"zen", "怎"},
+    {"zeng", "增憎曾赠"},
+    {"zha", "扎喳渣札轧铡闸眨栅榨咋乍炸诈"},
+    {"zhai", "摘斋宅窄债寨"},
+    {"zhan", "瞻毡詹粘沾盏斩辗崭展蘸栈占战站湛绽"},
+    {"zhang", "樟章彰漳张掌涨杖丈帐账仗胀瘴障璋"},
+    {"zhao", "招昭找沼赵照罩兆肇召钊"},
+    {"zhe", "遮折哲蛰辙者锗蔗这浙"},
+    {"zhen", "珍斟真甄砧臻贞针侦枕疹诊震振镇阵祯蓁"},
+    {"zheng", "蒸挣睁征狰争怔整拯正政帧症郑证峥"},
+    {"zhi", "芝枝支吱蜘知肢脂汁之织职直植殖执值侄址指止趾只旨纸志挚掷至致"
+            "置帜峙制智秩稚质炙痔滞治窒芷"},
+    {"zhong", "中盅忠钟衷终种肿重仲众"},
+    {"zhou", "舟周州洲诌粥轴肘帚咒皱宙昼骤"},
+    {"zhu", "珠株蛛朱猪诸诛逐竹烛煮拄瞩嘱主著柱助蛀贮铸筑住注祝驻"},
+    {"zhua", "抓爪"},
+    {"zhuai", "拽"},
+    {"zhuan", "专砖转撰赚篆"},
+    {"zhuang", "桩庄装妆撞壮状"},
+    {"zhui", "椎锥追赘坠缀"},
+    {"zhun", "谆准"},
+    {"zhuo", "捉拙卓桌琢茁酌啄着灼浊"},
+    {"zi", "兹咨资姿滋淄孜紫仔籽滓子自渍字梓"},
+    {"zong", "鬃棕踪宗综总纵"},
+    {"zou", "邹走奏揍"},
+    {"zu", "租足卒族祖诅阻组"},
+    {"zuan", "钻纂"},
+    {"zui", "嘴醉最罪"},
+    {"zun", "尊遵"},
+    {"zuo", "昨左佐柞做作坐座"},
+};
+
+// 作姓氏时读音不同的多音字（只用于姓名的第一个字）
+static const PinyinSyllable pinyinSurnameReadings[] = {
+    {"shan", "单"}, {"xie", "解"}, {"ou", "区"}, {"zha", "查"}, {"qiu", "仇"}, {"piao", "朴"},
+    {"zhai", "翟"}, {"ge", "盖"}, {"yue", "乐"}, {"bi", "秘"}, {"chong", "种"}, {"shao", "召"}
+};
+
+// 按码位排序的汉字拼音查找表（首次使用时由 pinyinSyllables 生成）
+PinyinEntry *pinyinTable = NULL;
+int pinyinTableCount = 0;
+
+// 解码一个 UTF-8 字符，*length 返回其字节数
+unsigned int utf8Decode(const char *text, int *length) {
+    const unsigned char *p = (const unsigned char *)text;
+    *length = utf8CharLength(text);
+    switch (*length) {
+        case 2: return ((p[0] & 0x1Fu) << 6) | (p[1] & 0x3Fu);
+        case 3: return ((p[0] & 0x0Fu) << 12) | ((p[1] & 0x3Fu) << 6) | (p[2] & 0x3Fu);
+        case 4: return ((p[0] & 0x07u) << 18) | ((p[1] & 0x3Fu) << 12) | ((p[2] & 0x3Fu) << 6) | (p[3] & 0x3Fu);
+        default: return p[0];
+    }
+}
+
+// 按码位比较拼音表项
+int comparePinyinEntries(const void *a, const void *b) {
+    unsigned int x = ((const PinyinEntry *)a)->codepoint;
+    unsigned int y = ((const PinyinEntry *)b)->codepoint;
+    return x < y ? -1 : x > y;
+}
+
+// 生成拼音查找表（只生成一次），成功返回1
+int initPinyinTable() {
+    if (pinyinTable != NULL) {
+        return 1;
+    }
+    int syllableCount = (int)(sizeof(pinyinSyllables) / sizeof(pinyinSyllables[0]));
+    int total = 0;
+    for (int s = 0; s < syllableCount; s++) {
+        total += (int)strlen(pinyinSyllables[s].chars); // 字节数，不少于字数
+    }
+    PinyinEntry *table = (PinyinEntry *)malloc(sizeof(PinyinEntry) * (size_t)total);
+    if (table == NULL) {
+        return 0;
+    }
+    int count = 0;
+    for (int s = 0; s < syllableCount; s++) {
+        const char *p = pinyinSyllables[s].chars;
+        while (*p != '\0' && count < total) {
+            int length;
+            table[count].codepoint = utf8Decode(p, &length);
+            table[count].syllable = (unsigned short)s;
+            count++;
+            p += length;
+        }
+    }
+    qsort(table, (size_t)count, sizeof(PinyinEntry), comparePinyinEntries);
+    pinyinTable = table;
+    pinyinTableCount = count;
+    return 1;
+}
+
+// 查找汉字的拼音，表中没有时返回NULL
+const char *pinyinOf(unsigned int codepoint) {
+    int low = 0, high = pinyinTableCount - 1;
+    while (low <= high) {
+        int mid = low + (high - low) / 2;
+        if (pinyinTable[mid].codepoint == codepoint) {
+            return pinyinSyllables[pinyinTable[mid].syllable].syllable;
+        }
+        if (pinyinTable[mid].codepoint < codepoint) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return NULL;
+}
+
+// 生成姓名的全拼（如 zhangsan）和首字母（如 zs）检索键，字母一律小写
+// 汉字按拼音表转换，表中没有的字跳过；连续的英文字母和数字原样计入全拼，首字母只取第一个
+void namePinyinKeys(const char *name, char *full, size_t fullSize, char *initials, size_t initialsSize) {
+    size_t fullLength = 0, initialsLength = 0;
+    int inWord = 0;
+    for (const char *p = name; *p != '\0';) {
+        int length;
+        unsigned int codepoint = utf8Decode(p, &length);
+        const char *syllable = NULL;
+        if (p == name) {
+            for (int i = 0; i < (int)(sizeof(pinyinSurnameReadings) / sizeof(pinyinSurnameReadings[0])); i++) {
+                if (strncmp(p, pinyinSurnameReadings[i].chars, (size_t)length) == 0 &&
+                    pinyinSurnameReadings[i].chars[length] == '\0') {
+                    syllable = pinyinSurnameReadings[i].syllable;
+                    break;
+                }
+            }
+        }
+        p += length;
+        
+        if (codepoint < 0x80) {
+            char c = (char)codepoint;
+            int isWordChar = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+            if (!isWordChar) {
+                inWord = 0;
+                continue;
+            }
+            c = (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+            if (fullLength + 1 < fullSize) {
+                full[fullLength++] = c;
+            }
+            if (!inWord && initialsLength + 1 < initialsSize) {
+                initials[initialsLength++] = c;
+            }
+            inWord = 1;
+            continue;
+        }
+        
+        inWord = 0;
+        if (syllable == NULL) {
+            syllable = pinyinOf(codepoint);
+        }
+        if (syllable == NULL) {
+            continue;
+        }
+        size_t syllableLength = strlen(syllable);
+        if (fullLength + syllableLength < fullSize) {
+            memcpy(full + fullLength, syllable, syllableLength);
+            fullLength += syllableLength;
+        }
+        if (initialsLength + 1 < initialsSize) {
+            initials[initialsLength++] = syllable[0];
+        }
+    }
+    full[fullLength] = '\0';
+    initials[initialsLength] = '\0';
+}
+
+// 在按文本排序的拼音键编号数组中查找第一个不小于 text 的位置
+int pinyinLowerBound(StudentManager *manager, const char *text) {
+    int low = 0, high = manager->pinyinOrderCount;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (strcmp(dictString(&manager->pinyinKeys, manager->pinyinOrder[mid]), text) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// 按键文本比较排序临时项
+int comparePinyinOrderItems(const void *a, const void *b) {
+    return strcmp(((const PinyinOrderItem *)a)->key, ((const PinyinOrderItem *)b)->key);
+}
+
+// 查找前把追加在末尾的新键并入有序部分：只排序新键（与 idOrderPrepare 相同，复制键指针到临时数组比较），
+// 再与前面已排序的部分从后往前归并，耗时 O(n + m log m)（m 为新键数）。内存不足返回0
+int pinyinOrderPrepare(StudentManager *manager) {
+    int sortedCount = manager->pinyinOrderSortedCount;
+    int deltaCount = manager->pinyinOrderCount - sortedCount;
+    if (deltaCount == 0) {
+        return 1;
+    }
+    PinyinOrderItem *items = (PinyinOrderItem *)malloc(sizeof(PinyinOrderItem) * (size_t)deltaCount);
+    if (items == NULL) {
+        return 0;
+    }
+    for (int i = 0; i < deltaCount; i++) {
+        items[i].id = manager->pinyinOrder[sortedCount + i];
+        items[i].key = dictString(&manager->pinyinKeys, items[i].id);
+    }
+    qsort(items, (size_t)deltaCount, sizeof(PinyinOrderItem), comparePinyinOrderItems);
+    
+    // 新键已在临时数组中，从后往前归并不会覆盖尚未取用的有序部分
+    int i = sortedCount - 1, j = deltaCount - 1;
+    for (int k = manager->pinyinOrderCount - 1; j >= 0; k--) {
+        if (i >= 0 && strcmp(dictString(&manager->pinyinKeys, manager->pinyinOrder[i]), items[j].key) > 0) {
+            manager->pinyinOrder[k] = manager->pinyinOrder[i--];
+        } else {
+            manager->pinyinOrder[k] = items[j--].id;
+        }
+    }
+    free(items);
+    manager->pinyinOrderSortedCount = manager->pinyinOrderCount;
+    return 1;
+}
+
+// 登记拼音键并把学生加入其倒排列表；新出现的键追加到键数组末尾（乱序时留待查找前排序），成功返回1
+int pinyinIndexAdd(StudentManager *manager, const char *key, int index) {
+    if (key[0] == '\0') {
+        return 1;
+    }
+    int previousCount = manager->pinyinKeys.count;
+    int id = dictIntern(&manager->pinyinKeys, key);
+    if (id == -1) {
+        return 0;
+    }
+    if (manager->pinyinKeys.count > previousCount) {
+        if (manager->pinyinOrderCount >= manager->pinyinOrderCapacity) {
+            int newCapacity = manager->pinyinOrderCapacity == 0 ? 256 : manager->pinyinOrderCapacity * 2;
+            int *newOrder = (int *)realloc(manager->pinyinOrder, sizeof(int) * (size_t)newCapacity);
+            if (newOrder == NULL) {
+                return 0;
+            }
+            manager->pinyinOrder = newOrder;
+            manager->pinyinOrderCapacity = newCapacity;
+        }
+        // 逐个插入有序位置在键很多（如姓名带编号）时是平方级，这里只追加；
+        // 全部有序且新键不小于末尾的键时仍然有序，不必留待归并
+        if (manager->pinyinOrderSortedCount == manager->pinyinOrderCount &&
+            (manager->pinyinOrderCount == 0 ||
+             strcmp(dictString(&manager->pinyinKeys, manager->pinyinOrder[manager->pinyinOrderCount - 1]), key) < 0)) {
+            manager->pinyinOrderSortedCount++;
+        }
+        manager->pinyinOrder[manager->pinyinOrderCount++] = id;
+    }
+    return postingAdd(&manager->pinyinIndex, id, index);
+}
+
+// 把学生加入拼音索引（全拼与首字母相同时只登记一次）
+void indexStudentPinyin(StudentManager *manager, int index) {
+    char full[PINYIN_KEY_SIZE], initials[PINYIN_KEY_SIZE];
+    namePinyinKeys(getStudent(manager, index)->name, full, sizeof(full), initials, sizeof(initials));
+    pinyinIndexAdd(manager, full, index);
+    if (strcmp(full, initials) != 0) {
+        pinyinIndexAdd(manager, initials, index);
+    }
+}
+
+// 把学生从拼音索引中移除（修改姓名前调用），键本身保留在有序数组中
+void unindexStudentPinyin(StudentManager *manager, int index) {
+    char full[PINYIN_KEY_SIZE], initials[PINYIN_KEY_SIZE];
+    namePinyinKeys(getStudent(manager, index)->name, full, sizeof(full), initials, sizeof(initials));
+    postingRemove(&manager->pinyinIndex, dictLookup(&manager->pinyinKeys, full), index);
+    postingRemove(&manager->pinyinIndex, dictLookup(&manager->pinyinKeys, initials), index);
+}
+
+// 升序比较学生下标
+int compareIndexes(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return x < y ? -1 : x > y;
+}
+
+// 按拼音前缀查找学生（全拼或首字母，不区分大小写），返回按下标升序、去重后的学生下标数组（需调用者释放）
+// 二分定位以该前缀开头的第一个键，顺序取出相邻的各键的倒排列表；出错时返回NULL且 *count 为-1
+int *findStudentsByPinyin(StudentManager *manager, const char *prefix, int *count) {
+    char key[PINYIN_KEY_SIZE];
+    size_t length = 0;
+    for (const char *p = prefix; *p != '\0' && length + 1 < sizeof(key); p++) {
+        if (*p != ' ' && *p != '\'') {
+            key[length++] = (*p >= 'A' && *p <= 'Z') ? (char)(*p - 'A' + 'a') : *p;
+        }
+    }
+    key[length] = '\0';
+    
+    if (!pinyinOrderPrepare(manager)) {
+        *count = -1;
+        return NULL;
+    }
+    int first = pinyinLowerBound(manager, key);
+    int last = first;
+    int total = 0;
+    while (length > 0 && last < manager->pinyinOrderCount &&
+           strncmp(dictString(&manager->pinyinKeys, manager->pinyinOrder[last]), key, length) == 0) {
+        const PostingList *list = postingFind(&manager->pinyinIndex, manager->pinyinOrder[last]);
+        total += list != NULL ? list->count : 0;
+        last++;
+    }
+    
+    int *result = (int *)malloc(sizeof(int) * (size_t)(total > 0 ? total : 1));
+    if (result == NULL) {
+        *count = -1;
+        return NULL;
+    }
+    int matched = 0;
+    for (int k = first; k < last; k++) {
+        const PostingList *list = postingFind(&manager->pinyinIndex, manager->pinyinOrder[k]);
+        if (list != NULL && list->count > 0) {
+            memcpy(result + matched, list->items, sizeof(int) * (size_t)list->count);
+            matched += list->count;
+        }
+    }
+    // 只命中一个键时本身有序且不重复；否则排序并去掉同时命中全拼和首字母的重复学生
+    // 命中学生很多时改用按下标的标记数组，一次顺序扫描即可有序输出
+    unsigned char *marks = NULL;
+    if (last - first > 1 && matched > manager->count / 16) {
+        marks = (unsigned char *)calloc((size_t)manager->count, 1);
+    }
+    if (marks != NULL) {
+        for (int i = 0; i < matched; i++) {
+            marks[result[i]] = 1;
+        }
+        matched = 0;
+        for (int i = 0; i < manager->count; i++) {
+            if (marks[i]) {
+                result[matched++] = i;
+            }
+        }
+        free(marks);
+    } else if (last - first > 1) {
+        qsort(result, (size_t)matched, sizeof(int), compareIndexes);
+        int unique = 0;
+        for (int i = 0; i < matched; i++) {
+            if (unique == 0 || result[unique - 1] != result[i]) {
+                result[unique++] = result[i];
+            }
+        }
+        matched = unique;
+    }
+    *count = matched;
+    return result;
+}
+
+// 标记列式镜像需要重建（学生增删改后调用）
+void invalidateColumns(StudentManager *manager) {
+    manager->columns.valid = 0;
+}
+
+// 按需重建列式镜像，返回镜像，内存不足返回NULL
+// 重建沿用已分配的列数组，只在行数或成绩列数增长时扩容
+StudentColumns *getColumns(StudentManager *manager) {
+    StudentColumns *columns = &manager->columns;
+    if (columns->valid) {
+        return columns;
+    }
+    
+    int scoreColumnCount = 0;
+    for (int i = 0; i < manager->count; i++) {
+        if (getStudent(manager, i)->scoreCount > scoreColumnCount) {
+            scoreColumnCount = getStudent(manager, i)->scoreCount;
+        }
+    }
+    
+    if (manager->count > columns->capacity) {
+        int newCapacity = columns->capacity == 0 ? 1024 : columns->capacity;
+        while (newCapacity < manager->count) {
+            newCapacity *= 2;
+        }
+        // 先释放旧数组再整体分配，失败时镜像保持为空
+        free(columns->ids);
+        free(columns->totals);
+        free(columns->classIds);
+        free(columns->departmentIds);
+        free(columns->majorIds);
+        for (int j = 0; j < columns->scoreColumnCapacity; j++) {
+            free(columns->scoreColumns[j]);
+            columns->scoreColumns[j] = NULL;
+        }
+        columns->ids = (char (*)[20])malloc(sizeof(*columns->ids) * (size_t)newCapacity);
+        columns->totals = (float *)malloc(sizeof(float) * (size_t)newCapacity);
+        columns->classIds = (int *)malloc(sizeof(int) * (size_t)newCapacity);
+        columns->departmentIds = (int *)malloc(sizeof(int) * (size_t)newCapacity);
+        columns->majorIds = (int *)malloc(sizeof(int) * (size_t)newCapacity);
+        columns->capacity = newCapacity;
+        if (columns->ids == NULL || columns->totals == NULL || columns->classIds == NULL ||
+            columns->departmentIds == NULL || columns->majorIds == NULL) {
+            freeColumns(columns);
+            return NULL;
+        }
+    }
+    if (scoreColumnCount > columns->scoreColumnCapacity) {
+        float **newScoreColumns = (float **)realloc(columns->scoreColumns, sizeof(float *) * scoreColumnCount);
+        if (newScoreColumns == NULL) {
+            return NULL;
+        }
+        for (int j = columns->scoreColumnCapacity; j < scoreColumnCount; j++) {
+            newScoreColumns[j] = NULL;
+        }
+        columns->scoreColumns = newScoreColumns;
+        columns->scoreColumnCapacity = scoreColumnCount;
+    }
+    for (int j = 0; j < scoreColumnCount; j++) {
+        if (columns->scoreColumns[j] == NULL) {
+            columns->scoreColumns[j] = (float *)malloc(sizeof(float) * (size_t)columns->capacity);
+            if (columns->scoreColumns[j] == NULL) {
+                return NULL;
+            }
+        }
+    }
+    
+    // 按块逐行拆分到各列
+    // 已删除、尚未压缩的空位各列记为缺失，行号仍与学生下标一致
+    for (int i = 0; i < manager->count; i++) {
+        const Student *student = getStudent(manager, i);
+        int deleted = student->deleted;
+        memcpy(columns->ids[i], deleted ? "" : student->id, deleted ? 1 : sizeof(columns->ids[i]));
+        columns->totals[i] = deleted ? COLUMN_SCORE_MISSING : (float)studentTotal(student);
+        columns->classIds[i] = deleted ? -1 : student->classId;
+        columns->departmentIds[i] = deleted ? -1 : student->departmentId;
+        columns->majorIds[i] = deleted ? -1 : student->majorId;
+        for (int j = 0; j < scoreColumnCount; j++) {
+            columns->scoreColumns[j][i] = j < student->scoreCount ? studentScore(student, j) : COLUMN_SCORE_MISSING;
+        }
+    }
+    columns->count = manager->count;
+    columns->scoreColumnCount = scoreColumnCount;
+    columns->valid = 1;
+    return columns;
+}
+
+// 释放列式镜像
+void freeColumns(StudentColumns *columns) {
+    free(columns->ids);
+    free(columns->totals);
+    free(columns->classIds);
+    free(columns->departmentIds);
+    free(columns->majorIds);
+    for (int j = 0; j < columns->scoreColumnCapacity; j++) {
+        free(columns->scoreColumns[j]);
+    }
+    free(columns->scoreColumns);
+    memset(columns, 0, sizeof(StudentColumns));
+}
+
+// 统计一列成绩（逐个计算的版本，也用于处理向量版本剩下的尾部）
+// 缺考（COLUMN_SCORE_MISSING）不计入
+void courseStatsScalar(const float *scores, int n, CourseStats *stats) {
+    memset(stats, 0, sizeof(CourseStats));
+    float min = 1e30f, max = -1e30f;
+    for (int i = 0; i < n; i++) {
+        float score = scores[i];
+        if (score < 0) {
+            continue;
+        }
+        stats->count++;
+        stats->passCount += score >= PASS_SCORE;
+        stats->sum += score;
+        stats->sumSquares += (double)score * score;
+        min = score < min ? score : min;
+        max = score > max ? score : max;
+    }
+    stats->min = stats->count > 0 ? min : 0;
+    stats->max = stats->count > 0 ? max : 0;
+}
+
+// 把向量版本处理完的部分与尾部合并
+void courseStatsMerge(CourseStats *stats, const CourseStats *tail) {
+    if (tail->count == 0) {
+        return;
+    }
+    stats->min = stats->count == 0 || tail->min < stats->min ? tail->min : stats->min;
+    stats->max = stats->count == 0 || tail->max > stats->max ? tail->max : stats->max;
+    stats->count += tail->count;
+    stats->passCount += tail->passCount;
+    stats->sum += tail->sum;
+    stats->sumSquares += tail->sumSquares;
+}
+
+#ifdef HAVE_SSE2
+// SSE2 版本：每次处理4个成绩。缺考的成绩用比较得到的掩码清零（求和）或换成极大值（求最小值），
+// 人数和及格人数用掩码（-1）逐道相减累计；总和与平方和转成 double 累加，千万级数据也不丢精度
+void courseStatsSse2(const float *scores, int n, CourseStats *stats) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 pass = _mm_set1_ps(PASS_SCORE);
+    const __m128 huge = _mm_set1_ps(1e30f);
+    __m128 minValues = huge, maxValues = _mm_set1_ps(-1e30f);
+    __m128d sumLow = _mm_setzero_pd(), sumHigh = _mm_setzero_pd();
+    __m128d squareLow = _mm_setzero_pd(), squareHigh = _mm_setzero_pd();
+    __m128i counts = _mm_setzero_si128(), passCounts = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 values = _mm_loadu_ps(scores + i);
+        __m128 valid = _mm_cmpge_ps(values, zero);
+        __m128 kept = _mm_and_ps(values, valid);
+        counts = _mm_sub_epi32(counts, _mm_castps_si128(valid));
+        passCounts = _mm_sub_epi32(passCounts, _mm_castps_si128(_mm_cmpge_ps(values, pass)));
+        minValues = _mm_min_ps(minValues, _mm_or_ps(kept, _mm_andnot_ps(valid, huge)));
+        maxValues = _mm_max_ps(maxValues, values);
+        __m128d low = _mm_cvtps_pd(kept);
+        __m128d high = _mm_cvtps_pd(_mm_movehl_ps(kept, kept));
+        sumLow = _mm_add_pd(sumLow, low);
+        sumHigh = _mm_add_pd(sumHigh, high);
+        squareLow = _mm_add_pd(squareLow, _mm_mul_pd(low, low));
+        squareHigh = _mm_add_pd(squareHigh, _mm_mul_pd(high, high));
+    }
+    
+    float minLanes[4], maxLanes[4];
+    double sumLanes[2], squareLanes[2];
+    int countLanes[4], passLanes[4];
+    _mm_storeu_ps(minLanes, minValues);
+    _mm_storeu_ps(maxLanes, maxValues);
+    _mm_storeu_si128((__m128i *)countLanes, counts);
+    _mm_storeu_si128((__m128i *)passLanes, passCounts);
+    _mm_storeu_pd(sumLanes, _mm_add_pd(sumLow, sumHigh));
+    _mm_storeu_pd(squareLanes, _mm_add_pd(squareLow, squareHigh));
+    memset(stats, 0, sizeof(CourseStats));
+    stats->min = 1e30f;
+    stats->max = -1e30f;
+    for (int lane = 0; lane < 4; lane++) {
+        stats->count += countLanes[lane];
+        stats->passCount += passLanes[lane];
+        stats->min = minLanes[lane] < stats->min ? minLanes[lane] : stats->min;
+        stats->max = maxLanes[lane] > stats->max ? maxLanes[lane] : stats->max;
+    }
+    stats->sum = sumLanes[0] + sumLanes[1];
+    stats->sumSquares = squareLanes[0] + squareLanes[1];
+    if (stats->count == 0) {
+        stats->min = 0;
+        stats->max = 0;
+    }
+    
+    CourseStats tail;
+    courseStatsScalar(scores + i, n - i, &tail);
+    courseStatsMerge(stats, &tail);
+}
+#endif
+
+#ifdef HAVE_AVX2_TARGET
+// AVX2 版本：做法与 SSE2 版本相同，每次处理8个成绩
+__attribute__((target("avx2")))
+void courseStatsAvx2(const float *scores, int n, CourseStats *stats) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 pass = _mm256_set1_ps(PASS_SCORE);
+    const __m256 huge = _mm256_set1_ps(1e30f);
+    __m256 minValues = huge, maxValues = _mm256_set1_ps(-1e30f);
+    __m256d sumLow = _mm256_setzero_pd(), sumHigh = _mm256_setzero_pd();
+    __m256d squareLow = _mm256_setzero_pd(), squareHigh = _mm256_setzero_pd();
+    __m256i counts = _mm256_setzero_si256(), passCounts = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 values = _mm256_loadu_ps(scores + i);
+        __m256 valid = _mm256_cmp_ps(values, zero, _CMP_GE_OQ);
+        __m256 kept = _mm256_and_ps(values, valid);
+        counts = _mm256_sub_epi32(counts, _mm256_castps_si256(valid));
+        passCounts = _mm256_sub_epi32(passCounts, _mm256_castps_si256(_mm256_cmp_ps(values, pass, _CMP_GE_OQ)));
+        minValues = _mm256_min_ps(minValues, _mm256_blendv_ps(huge, kept, valid));
+        maxValues = _mm256_max_ps(maxValues, values);
+        __m256d low = _mm256_cvtps_pd(_mm256_castps256_ps128(kept));
+        __m256d high = _mm256_cvtps_pd(_mm256_extractf128_ps(kept, 1));
+        sumLow = _mm256_add_pd(sumLow, low);
+        sumHigh = _mm256_add_pd(sumHigh, high);
+        squareLow = _mm256_add_pd(squareLow, _mm256_mul_pd(low, low));
+        squareHigh = _mm256_add_pd(squareHigh, _mm256_mul_pd(high, high));
+    }
+    
+    float minLanes[8], maxLanes[8];
+    double sumLanes[4], squareLanes[4];
+    int countLanes[8], passLanes[8];
+    _mm256_storeu_ps(minLanes, minValues);
+    _mm256_storeu_ps(maxLanes, maxValues);
+    _mm256_storeu_si256((__m256i *)countLanes, counts);
+    _mm256_storeu_si256((__m256i *)passLanes, passCounts);
+    _mm256_storeu_pd(sumLanes, _mm256_add_pd(sumLow, sumHigh));
+    _mm256_storeu_pd(squareLanes, _mm256_add_pd(squareLow, squareHigh));
+    memset(stats, 0, sizeof(CourseStats));
+    stats->min = 1e30f;
+    stats->max = -1e30f;
+    for (int lane = 0; lane < 8; lane++) {
+        stats->count += countLanes[lane];
+        stats->passCount += passLanes[lane];
+        stats->min = minLanes[lane] < stats->min ? minLanes[lane] : stats->min;
+        stats->max = maxLanes[lane] > stats->max ? maxLanes[lane] : stats->max;
+    }
+    for (int lane = 0; lane < 4; lane++) {
+        stats->sum += sumLanes[lane];
+        stats->sumSquares += squareLanes[lane];
+    }
+    if (stats->count == 0) {
+        stats->min = 0;
+        stats->max = 0;
+    }
+    
+    CourseStats tail;
+    courseStatsScalar(scores + i, n - i, &tail);
+    courseStatsMerge(stats, &tail);
+}
+#endif
+
+// 当前 CPU 可用的向量指令：2 为 AVX2，1 为 SSE2，0 为无（逐个计算）
+int courseStatsSimdLevel() {
+#ifdef HAVE_AVX2_TARGET
+    static int avx2 = -1;
+    if (avx2 == -1) {
+        __builtin_cpu_init();
+        avx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    if (avx2) {
+        return 2;
+    }
+#endif
+#ifdef HAVE_SSE2
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+// 统计一列成绩，按 CPU 选用最快的版本
+void courseStatsCompute(const float *scores, int n, CourseStats *stats) {
+    switch (courseStatsSimdLevel()) {
+#ifdef HAVE_AVX2_TARGET
+        case 2:
+            courseStatsAvx2(scores, n, stats);
+            return;
+#endif
+#ifdef HAVE_SSE2
+        case 1:
+            courseStatsSse2(scores, n, stats);
+            return;
+#endif
+        default:
+            courseStatsScalar(scores, n, stats);
+    }
+}
+
+// 平均分
+double courseMean(const CourseStats *stats) {
+    return stats->count > 0 ? stats->sum / stats->count : 0.0;
+}
+
+// 方差（总体方差）
+double courseVariance(const CourseStats *stats) {
+    if (stats->count == 0) {
+        return 0.0;
+    }
+    double mean = stats->sum / stats->count;
+    double variance = stats->sumSquares / stats->count - mean * mean;
+    return variance > 0 ? variance : 0.0;
+}
+
+// 统计各门课程：indexes 为NULL时统计全部学生，否则只统计其中的 count 名（先收集到连续数组再统计）
+// 返回按成绩位置排列的统计结果数组（需调用者释放），*courses 为课程数；内存不足返回NULL且 *courses 为-1
+CourseStats *computeCourseStats(StudentManager *manager, const int *indexes, int count, int *courses) {
+    StudentColumns *columns = getColumns(manager);
+    int columnCount = columns != NULL ? columns->scoreColumnCount : 0;
+    CourseStats *stats = (CourseStats *)malloc(sizeof(CourseStats) * (size_t)(columnCount > 0 ? columnCount : 1));
+    float *gathered = indexes != NULL ? (float *)malloc(sizeof(float) * (size_t)(count > 0 ? count : 1)) : NULL;
+    if (columns == NULL || stats == NULL || (indexes != NULL && gathered == NULL)) {
+        free(stats);
+        free(gathered);
+        *courses = -1;
+        return NULL;
+    }
+    for (int j = 0; j < columnCount; j++) {
+        const float *column = columns->scoreColumns[j];
+        if (indexes == NULL) {
+            courseStatsCompute(column, columns->count, &stats[j]);
+        } else {
+            for (int i = 0; i < count; i++) {
+                gathered[i] = column[indexes[i]];
+            }
+            courseStatsCompute(gathered, count, &stats[j]);
+        }
+    }
+    free(gathered);
+    *courses = columnCount;
+    return stats;
+}
+
+// 第 j 门课程的名称：有成绩名预设时用预设，否则为“成绩 j+1”
+const char *courseName(StudentManager *manager, int j, char *buffer, size_t size) {
+    if (j < manager->scoreNameCount) {
+        return manager->scoreNames[j];
+    }
+    snprintf(buffer, size, "成绩 %d", j + 1);
+    return buffer;
+}
+
+// 各规格的块可容纳的 float 槽位数。成绩放不下学生记录（SCORE_INLINE_COUNT 个槽位）时才使用成绩池，
+// 请求至少为 SCORE_INLINE_COUNT + 1 个槽位，所以规格从其上开始：刚超出的几种逐一设规格，之后按1.5倍递增
+static const int scoreClassSizes[SCORE_POOL_CLASSES] = {9, 10, 11, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256};
+
+// 成绩数量对应的块规格，超过最大规格返回-1
+int scoreSizeClass(int count) {
+    for (int sizeClass = 0; sizeClass < SCORE_POOL_CLASSES; sizeClass++) {
+        if (scoreClassSizes[sizeClass] >= count) {
+            return sizeClass;
+        }
+    }
+    return -1;
+}
+
+// 从成绩池分配可容纳 count 个成绩的数组，count 为0时返回NULL，内存不足返回NULL
+float *scorePoolAlloc(ScorePool *pool, int count) {
+    if (count <= 0) {
+        return NULL;
+    }
+    pool->allocCalls++;
+    int sizeClass = scoreSizeClass(count);
+    
+    // 超过最大规格的数组单独向系统申请，挂在大块链表上以便整体释放
+    if (sizeClass == -1) {
+        ScoreLargeBlock *block = (ScoreLargeBlock *)malloc(sizeof(ScoreLargeBlock) + sizeof(float) * (size_t)count);
+        if (block == NULL) {
+            return NULL;
+        }
+        block->prev = NULL;
+        block->next = pool->largeBlocks;
+        if (pool->largeBlocks != NULL) {
+            pool->largeBlocks->prev = block;
+        }
+        pool->largeBlocks = block;
+        pool->systemAllocs++;
+        pool->largeBytes += sizeof(float) * (size_t)count;
+        pool->requestedBytes += sizeof(float) * (size_t)count;
+        return (float *)(block + 1);
+    }
+    
+    size_t blockBytes = sizeof(float) * (size_t)scoreClassSizes[sizeClass];
+    void *block = pool->freeLists[sizeClass];
+    if (block != NULL) {
+        // 复用同规格的空闲块
+        memcpy(&pool->freeLists[sizeClass], block, sizeof(void *));
+        pool->freeBytes -= blockBytes;
+    } else {
+        if (pool->currentSlab == NULL || pool->currentUsed + blockBytes > SCORE_POOL_SLAB_BYTES) {
+            ScoreSlab *slab = (ScoreSlab *)malloc(sizeof(ScoreSlab) + SCORE_POOL_SLAB_BYTES);
+            if (slab == NULL) {
+                return NULL;
+            }
+            if (pool->currentSlab != NULL) {
+                pool->tailWasteBytes += SCORE_POOL_SLAB_BYTES - pool->currentUsed;
+            }
+            slab->next = pool->slabs;
+            pool->slabs = slab;
+            pool->currentSlab = slab;
+            pool->currentUsed = 0;
+            pool->slabCount++;
+            pool->systemAllocs++;
+        }
+        block = (unsigned char *)(pool->currentSlab + 1) + pool->currentUsed;
+        pool->currentUsed += blockBytes;
+    }
+    pool->liveBytes += blockBytes;
+    pool->requestedBytes += sizeof(float) * (size_t)count;
+    return (float *)block;
+}
+
+// 把成绩数组归还成绩池（count 须与分配时一致）
+void scorePoolFree(ScorePool *pool, float *scores, int count) {
+    if (scores == NULL || count <= 0) {
+        return;
+    }
+    pool->freeCalls++;
+    pool->requestedBytes -= sizeof(float) * (size_t)count;
+    int sizeClass = scoreSizeClass(count);
+    if (sizeClass == -1) {
+        ScoreLargeBlock *block = (ScoreLargeBlock *)scores - 1;
+        if (block->prev != NULL) {
+            block->prev->next = block->next;
+        } else {
+            pool->largeBlocks = block->next;
+        }
+        if (block->next != NULL) {
+            block->next->prev = block->prev;
+        }
+        pool->largeBytes -= sizeof(float) * (size_t)count;
+        free(block);
+        return;
+    }
+    size_t blockBytes = sizeof(float) * (size_t)scoreClassSizes[sizeClass];
+    memcpy(scores, &pool->freeLists[sizeClass], sizeof(void *));
+    pool->freeLists[sizeClass] = scores;
+    pool->liveBytes -= blockBytes;
+    pool->freeBytes += blockBytes;
+}
+
+// 调整成绩数组大小：新旧数量属于同一规格时原地返回，否则换块并复制，内存不足返回NULL（原数组不变）
+float *scorePoolRealloc(ScorePool *pool, float *scores, int oldCount, int newCount) {
+    if (scores != NULL && oldCount > 0 && newCount > 0) {
+        int oldClass = scoreSizeClass(oldCount);
+        if (oldClass != -1 && oldClass == scoreSizeClass(newCount)) {
+            pool->requestedBytes += sizeof(float) * (size_t)newCount;
+            pool->requestedBytes -= sizeof(float) * (size_t)oldCount;
+            return scores;
+        }
+    }
+    float *newScores = scorePoolAlloc(pool, newCount);
+    if (newScores == NULL && newCount > 0) {
+        return NULL;
+    }
+    if (scores != NULL && newScores != NULL) {
+        memcpy(newScores, scores, sizeof(float) * (size_t)(oldCount < newCount ? oldCount : newCount));
+    }
+    scorePoolFree(pool, scores, oldCount);
+    return newScores;
+}
+
+// 整体释放成绩池（所有从池中分配的成绩数组随之失效）
+void scorePoolRelease(ScorePool *pool) {
+    while (pool->slabs != NULL) {
+        ScoreSlab *next = pool->slabs->next;
+        free(pool->slabs);
+        pool->slabs = next;
+    }
+    while (pool->largeBlocks != NULL) {
+        ScoreLargeBlock *next = pool->largeBlocks->next;
+        free(pool->largeBlocks);
+        pool->largeBlocks = next;
+    }
+    memset(pool, 0, sizeof(ScorePool));
+}
+
+// 学生记录内可直接存放的成绩数量（定点模式每门只占2字节，可多放一倍）
+int inlineScoreCapacity() {
+    return fixedScoreMode ? SCORE_INLINE_COUNT * 2 : SCORE_INLINE_COUNT;
+}
+
+// count 门成绩在成绩池中占用的 float 槽位数
+int scorePoolSlots(int count) {
+    return fixedScoreMode ? (count + 1) / 2 : count;
+}
+
+// 把成绩换算为百分之一分（成绩范围0-100，四舍五入）
+int scoreToHundredths(float score) {
+    return (int)(score * 100.0f + 0.5f);
+}
+
+// 取学生的第 i 门成绩
+float studentScore(const Student *student, int i) {
+    int spilled = student->scoreCount > inlineScoreCapacity();
+    if (fixedScoreMode) {
+        unsigned short value = spilled ? student->scoreData.heapFixed[i] : student->scoreData.inlineFixed[i];
+        return value / 100.0f;
+    }
+    return spilled ? student->scoreData.heapScores[i] : student->scoreData.inlineScores[i];
+}
+
+// 取学生的成绩总和（定点模式下由精确的整数总和换算）
+double studentTotal(const Student *student) {
+    return fixedScoreMode ? student->total.totalHundredths / 100.0 : student->total.totalScore;
+}
+
+// 设置学生的成绩并重新计算总和：放得下时存放在记录内，否则从成绩池分配，原有的池中成绩随之归还。
+// 定点模式在这里把成绩换算为百分之一分。内存不足返回0，此时学生原有成绩不变
+int setStudentScores(ScorePool *pool, Student *student, const float *scores, int count) {
+    void *target;
+    float *heapScores = NULL;
+    if (count > inlineScoreCapacity()) {
+        heapScores = scorePoolAlloc(pool, scorePoolSlots(count));
+        if (heapScores == NULL) {
+            return 0;
+        }
+        releaseStudentScores(pool, student);
+        student->scoreData.heapScores = heapScores;
+        target = heapScores;
+    } else {
+        releaseStudentScores(pool, student);
+        target = student->scoreData.inlineScores;
+    }
+    
+    if (fixedScoreMode) {
+        unsigned short *fixed = (unsigned short *)target;
+        int total = 0;
+        for (int i = 0; i < count; i++) {
+            fixed[i] = (unsigned short)scoreToHundredths(scores[i]);
+            total += fixed[i];
+        }
+        student->total.totalHundredths = total;
+    } else {
+        float total = 0;
+        if (count > 0) {
+            memcpy(target, scores, sizeof(float) * count);
+        }
+        for (int i = 0; i < count; i++) {
+            total += scores[i];
+        }
+        student->total.totalScore = total;
+    }
+    student->scoreCount = count;
+    return 1;
+}
+
+// 把学生的全部成绩按 float 取出到 scores（容量不小于 scoreCount）
+void copyStudentScores(const Student *student, float *scores) {
+    for (int i = 0; i < student->scoreCount; i++) {
+        scores[i] = studentScore(student, i);
+    }
+}
+
+// 修改学生的第 j 门成绩，总和按差值增量更新；j 等于成绩数量时追加一门（放不下时整体搬进成绩池）
+// 成功返回1；j 超过成绩数量（前面的成绩缺失）返回0；内存不足返回-1，此时学生原有成绩不变
+int setStudentScoreAt(ScorePool *pool, Student *student, int j, float score) {
+    int count = student->scoreCount;
+    if (j > count) {
+        return 0;
+    }
+    if (j == count) {
+        float local[IMPORT_MAX_FIELDS];
+        float *scores = count < IMPORT_MAX_FIELDS ? local : (float *)malloc(sizeof(float) * (size_t)(count + 1));
+        if (scores == NULL) {
+            return -1;
+        }
+        copyStudentScores(student, scores);
+        scores[count] = score;
+        int ok = setStudentScores(pool, student, scores, count + 1);
+        if (scores != local) {
+            free(scores);
+        }
+        return ok ? 1 : -1;
+    }
+    
+    int spilled = count > inlineScoreCapacity();
+    if (fixedScoreMode) {
+        unsigned short *fixed = spilled ? student->scoreData.heapFixed : student->scoreData.inlineFixed;
+        int value = scoreToHundredths(score);
+        student->total.totalHundredths += value - fixed[j];
+        fixed[j] = (unsigned short)value;
+    } else {
+        float *scores = spilled ? student->scoreData.heapScores : student->scoreData.inlineScores;
+        student->total.totalScore += score - scores[j];
+        scores[j] = score;
+    }
+    return 1;
+}
+
+// 归还学生在成绩池中的成绩并清空成绩数量
+void releaseStudentScores(ScorePool *pool, Student *student) {
+    if (student->scoreCount > inlineScoreCapacity()) {
+        scorePoolFree(pool, student->scoreData.heapScores, scorePoolSlots(student->scoreCount));
+    }
+    student->scoreCount = 0;
+}
+
+// 输出成绩池的分配次数与碎片情况
+void reportScorePool(const ScorePool *pool) {
+    size_t slabBytes = (size_t)pool->slabCount * SCORE_POOL_SLAB_BYTES;
+    size_t reserved = slabBytes + pool->largeBytes;
+    size_t blockBytes = pool->liveBytes + pool->largeBytes;
+    printf("成绩分配请求\t%lld\n", pool->allocCalls);
+    printf("成绩释放请求\t%lld\n", pool->freeCalls);
+    printf("系统分配次数\t%lld（板块 %lld）\n", pool->systemAllocs, pool->slabCount);
+    printf("成绩池规格\t%d 种，%d~%d 个槽位（记录内最多 %d 个槽位，超出时才使用）\n", SCORE_POOL_CLASSES,
+           scoreClassSizes[0], scoreClassSizes[SCORE_POOL_CLASSES - 1], SCORE_INLINE_COUNT);
+    printf("成绩池占用字节\t%llu\n", (unsigned long long)reserved);
+    printf("成绩数据字节\t%llu\n", (unsigned long long)pool->requestedBytes);
+    printf("规格取整浪费\t%.2f%%\n", blockBytes > 0 ? 100.0 * (blockBytes - pool->requestedBytes) / blockBytes : 0.0);
+    printf("空闲块占比\t%.2f%%\n", reserved > 0 ? 100.0 * pool->freeBytes / reserved : 0.0);
+    printf("板块尾部浪费\t%.2f%%\n", reserved > 0 ? 100.0 * pool->tailWasteBytes / reserved : 0.0);
+    printf("成绩池利用率\t%.2f%%\n", reserved > 0 ? 100.0 * pool->requestedBytes / reserved : 0.0);
+}
+
+// 显示院系列表
+void displayDepartments(StudentManager *manager) {
+    setColor(COLOR_YELLOW);
+    if (manager->departmentCount == 0) {
+        printf("\t\t当前没有预设的院系！\n");
+    } else {
+        printf("\t\t当前预设的院系列表：\n");
+        for (int i = 0; i < manager->departmentCount; i++) {
+            printf("\t\t%d. %s\n", i + 1, manager->departmentNames[i]);
+        }
+    }
+    setColor(COLOR_RESET);
+}
+
+// 添加院系
+void addDepartment(StudentManager *manager, const char *name) {
+    // 检查院系是否已存在
+    for (int i = 0; i < manager->departmentCount; i++) {
+        if (strcmp(manager->departmentNames[i], name) == 0) {
+            setColor(COLOR_RED);
+            printf("\t\t院系 '%s' 已存在！\n", name);
+            setColor(COLOR_RESET);
+            return;
+        }
+    }
+    
+    // 检查是否需要扩容
+    if (manager->departmentCount >= manager->departmentCapacity) {
+        int newCapacity = manager->departmentCapacity * 2;
+        char **newDepartmentNames = (char **)realloc(manager->departmentNames, sizeof(char *) * newCapacity);
+        if (newDepartmentNames == NULL) {
+            setColor(COLOR_RED);
+            printf("\t\t内存分配失败，无法添加新院系！\n");
+            setColor(COLOR_RESET);
+            return;
+        }
+        manager->departmentNames = newDepartmentNames;
+        manager->departmentCapacity = newCapacity;
+    }
+    
+    // 添加新院系
+    manager->departmentNames[manager->departmentCount] = (char *)malloc(sizeof(char) * (strlen(name) + 1));
+    if (manager->departmentNames[manager->departmentCount] == NULL) {
+        setColor(COLOR_RED);
+        printf("\t\t内存分配失败，无法添加新院系！\n");
+        setColor(COLOR_RESET);
+        return;
+    }
+    
+    strcpy(manager->departmentNames[manager->departmentCount], name);
+    manager->departmentCount++;
+    
+    journalRecordPreset(manager, PRESET_DEPARTMENT, name);
+    
+    setColor(COLOR_GREEN);
+    printf("\t\t院系 '%s' 添加成功！\n", name);
+    setColor(COLOR_RESET);
+}
+
+// 清除所有院系
+void clearDepartments(StudentManager *manager) {
+    for (int i = 0; i < manager->departmentCount; i++) {
+        free(manager->departmentNames[i]);
+    }
+    manager->departmentCount = 0;
+    
+    journalRecordPreset(manager, PRESET_DEPARTMENT, NULL);
+    
+    setColor(COLOR_GREEN);
+    printf("\t\t所有院系已清除！\n");
+    setColor(COLOR_RESET);
+}
+
+// 管理院系预设
+void manageDepartments(StudentManager *manager) {
+    char choice;
+    while (1) {
+        clearScreen();
+        setColor(COLOR_CYAN);
+        printf("\n\t\t=============================================\n");
+        printf("\t\t               院系预设管理                  \n");
+        printf("\t\t=============================================\n");
+        setColor(COLOR_RESET);
+        
+        displayDepartments(manager);
+        
+        setColor(COLOR_YELLOW);
+        printf("\t\t1. 添加院系\n");
+        printf("\t\t2. 清除所有院系\n");
+        printf("\t\t0. 返回主菜单\n");
+        printf("\t\t请输入选择: ");
+        setColor(COLOR_RESET);
+        
+        choice = getKey();
+        clearInputBuffer();
+        
+        switch (choice) {
+            case '1': {
+                char department[30];
+                printf("\t\t请输入院系名称: ");
+                fgets(department, sizeof(department), stdin);
+                department[strcspn(department, "\n")] = '\0';
+                
+                if (isEmptyString(department)) {
+                    setColor(COLOR_RED);
+                    printf("\t\t院系名称不能为空！\n");
+                    setColor(COLOR_RESET);
+                } else {
+                    addDepartment(manager, department);
+                }
+                break;
+            }
+            case '2': {
+                char confirm;
+                setColor(COLOR_RED);
+                printf("\t\t确定要清除所有院系吗？(y/n): ");
+                setColor(COLOR_RESET);
+                confirm = getKey();
+                printf("%c\n", confirm);
+                if (confirm == 'y' || confirm == 'Y') {
+                    clearDepartments(manager);
+                } else {
+                    printf("\t\t已取消操作！\n");
+                }
+                break;
+            }
+            case '0':
+                return;
+            default:
+                setColor(COLOR_RED);
+                printf("\t\t无效的选择！\n");
+                setColor(COLOR_RESET);
+        }
+        
+        setColor(COLOR_BLUE);
+        printf("\t\t按任意键继续...");
+        setColor(COLOR_RESET);
+        getKey();
+    }
+}
+
+// 显示专业列表
+void displayMajors(StudentManager *manager) {
+    setColor(COLOR_YELLOW);
+    if (manager->majorCount == 0) {
+        printf("\t\t当前没有预设的专业！\n");
+    } else {
+        printf("\t\t当前预设的专业列表：\n");
+        for (int i = 0; i < manager->majorCount; i++) {
+            printf("\t\t%d. %s\n", i + 1, manager->majorNames[i]);
+        }
+    }
+    setColor(COLOR_RESET);
+}
+
+// 添加专业
+void addMajor(StudentManager *manager, const char *name) {
+    // 检查专业是否已存在
+    for (int i = 0; i < manager->majorCount; i++) {
+        if (strcmp(manager->majorNames[i], name) == 0) {
+            setColor(COLOR_RED);
+            printf("\t\t专业 '%s' 已存在！\n", name);
+            setColor(COLOR_RESET);
+            return;
+        }
+    }
+    
+    // 检查是否需要扩容
+    if (manager->majorCount >= manager->majorCapacity) {
+        int newCapacity = manager->majorCapacity * 2;
+        char **newMajorNames = (char **)realloc(manager->majorNames, sizeof(char *) * newCapacity);
+        if (newMajorNames == NULL) {
+            setColor(COLOR_RED);
+            printf("\t\t内存分配失败，无法添加新专业！\n");
+            setColor(COLOR_RESET);
+            return;
+        }
+        manager->majorNames = newMajorNames;
+        manager->majorCapacity = newCapacity;
+    }
+    
+    // 添加新专业
+    manager->majorNames[manager->majorCount] = (char *)malloc(sizeof(char) * (strlen(name) + 1));
+    if (manager->majorNames[manager->majorCount] == NULL) {
+        setColor(COLOR_RED);
+        printf("\t\t内存分配失败，无法添加新专业！\n");
+        setColor(COLOR_RESET);
+        return;
+    }
+    
+    strcpy(manager->majorNames[manager->majorCount], name);
+    manager->majorCount++;
+    
+    journalRecordPreset(manager, PRESET_MAJOR, name);
+    
+    setColor(COLOR_GREEN);
+    printf("\t\t专业 '%s' 添加成功！\n", name);
+    setColor(COLOR_RESET);
+}
+
+// 清除所有专业
+void clearMajors(StudentManager *manager) {
+    for (int i = 0; i < manager->majorCount; i++) {
+        free(manager->majorNames[i]);
+    }
+    manager->majorCount = 0;
+    
+    journalRecordPreset(manager, PRESET_MAJOR, NULL);
+    
+    setColor(COLOR_GREEN);
+    printf("\t\t所有专业已清除！\n");
+    setColor(COLOR_RESET);
+}
+
+// 管理专业预设
+void manageMajors(StudentManager *manager) {
+    char choice;
+    while (1) {
+        clearScreen();
+        setColor(COLOR_CYAN);
+        printf("\n\t\t=============================================\n");
+        printf("\t\t               专业预设管理                  \n");
+        printf("\t\t=============================================\n");
+        setColor(COLOR_RESET);
+        
+        displayMajors(manager);
+        
+        setColor(COLOR_YELLOW);
+        printf("\t\t1. 添加专业\n");
+        printf("\t\t2. 清除所有专业\n");
+        printf("\t\t0. 返回主菜单\n");
+        printf("\t\t请输入选择: ");
+        setColor(COLOR_RESET);
+        
+        choice = getKey();
+        clearInputBuffer();
+        
+        switch (choice) {
+            case '1': {
+                char major[30];
+                printf("\t\t请输入专业名称: ");
+                fgets(major, sizeof(major), stdin);
+                major[strcspn(major, "\n")] = '\0';
+                
+                if (isEmptyString(major)) {
+                    setColor(COLOR_RED);
+                    printf("\t\t专业名称不能为空！\n");
+                    setColor(COLOR_RESET);
+                } else {
+                    addMajor(manager, major);
+                }
+                break;
+            }
+            case '2': {
+                char confirm;
+                setColor(COLOR_RED);
+                printf("\t\t确定要清除所有专业吗？(y/n): ");
+                setColor(COLOR_RESET);
+                confirm = getKey();
+                printf("%c\n", confirm);
+                if (confirm == 'y' || confirm == 'Y') {
+                    clearMajors(manager);
+                } else {
+                    printf("\t\t已取消操作！\n");
+                }
+                break;
+            }
+            case '0':
+                return;
+            default:
+                setColor(COLOR_RED);
+                printf("\t\t无效的选择！\n");
+                setColor(COLOR_RESET);
+        }
+        
+        setColor(COLOR_BLUE);
+        printf("\t\t按任意键继续...");
+        setColor(COLOR_RESET);
+        getKey();
+    }
+}
+
+// 验证院系是否有效
+int isValidDepartment(StudentManager *manager, const char *department) {
+    if (manager->departmentCount == 0) {
+        return 0;  // 没有预设院系
+    }
+    
+    for (int i = 0; i < manager->departmentCount; i++) {
+        if (strcmp(manager->departmentNames[i], department) == 0) {
+            return 1;  // 院系有效
+        }
+    }
+    
+    return 0;  // 院系无效
+}
+
+// 验证专业是否有效
+int isValidMajor(StudentManager *manager, const char *major) {
+    if (manager->majorCount == 0) {
+        return 0;  // 没有预设专业
+    }
+    
+    for (int i = 0; i < manager->majorCount; i++) {
+        if (strcmp(manager->majorNames[i], major) == 0) {
+            return 1;  // 专业有效
+        }
+    }
+    
+    return 0;  // 专业无效
+}
+
+// 获取单个按键输入（无需回车）
+char getKey() {
+#ifdef _WIN32
+    return _getch();
+#else
+    // 临时关闭行缓冲和回显，读取一个字节
+    struct termios oldAttr, newAttr;
+    if (tcgetattr(STDIN_FILENO, &oldAttr) != 0) {
+        return (char)getchar();
+    }
+    newAttr = oldAttr;
+    newAttr.c_lflag &= ~(ICANON | ECHO);
+    tcsetattr(STDIN_FILENO, TCSANOW, &newAttr);
+    fflush(stdout);
+    int c = getchar();
+    tcsetattr(STDIN_FILENO, TCSANOW, &oldAttr);
+    return (char)c;
+#endif
+}
+
+// 清屏
+void clearScreen() {
+#ifdef _WIN32
+    system("cls");
+#else
+    printf("\033[2J\033[H");
+    fflush(stdout);
+#endif
+}
+
+// 设置颜色
+void setColor(const char *color) {
+    if (useColor) {
+        printf("%s", color);
+    }
+}
+
+// 显示菜单
+void showMenu() {
+    clearScreen();
+    setColor(COLOR_YELLOW);
+    printf("\n\n");
+    printf("                ==============================================================\n");
+    printf("                *                                                            *\n");
+    printf("                *                      学生信息管理系统                      *\n");
+    printf("                *                                                            *\n");
+    printf("                ==============================================================\n");
+    printf("                *                       系统功能菜单                         *\n");
+    printf("                --------------------------------------------------------------\n");
+    setColor(COLOR_RESET);
+    
+    setColor(COLOR_CYAN);
+    printf("                *  1. %-15s          ** 2. %-15s                *\n", "使用说明", "录入学生信息");
+    printf("                ==============================================================\n");         
+    printf("                *  3. %-15s         ** 4. %-15s                *\n", "显示学生信息", "查找学生信息");
+    printf("                ==============================================================\n");         
+    printf("                *  5. %-15s         ** 6. %-15s                *\n", "修改学生信息", "删除学生信息");
+    printf("                ==============================================================\n");         
+    printf("                *  7. %-15s         ** 8. %-15s                *\n", "院系预设设置", "专业预设设置");
+    printf("                ==============================================================\n");         
+    printf("                *  9. %-15s           ** a. %-15s                 *\n", "成绩名预设", "软件信息");
+    printf("                ==============================================================\n");
+    printf("                *  b. %-15s           ** c. %-15s                  *\n", "开发者的话", "成绩排行榜");
+    printf("                ==============================================================\n");
+    printf("                *  d. %-15s         ** e. %-15s                *\n", "课程成绩统计", "成绩分布报告");
+    printf("                ==============================================================\n");
+    printf("                *  f. %-15s          ** 0. %-15s                 *\n", "批量操作", "退出系统");
+    printf("                ==============================================================\n");
+    setColor(COLOR_RESET);
+    
+    setColor(COLOR_BLUE);
+    printf("\n\t\tStudents' Information Management System developed by MccoyFreyr\n");
+    setColor(COLOR_RESET);
+    
+    setColor(COLOR_MAGENTA);
+    printf("\n\t\t请输入选择 (0-9, a-f): ");
+    setColor(COLOR_RESET);
+}
+
+// 验证字符串是否为空或只包含空格
+int isEmptyString(const char *str) {
+    if (str == NULL || *str == '\0') return 1;
+    while (*str != '\0') {
+        if (*str != ' ' && *str != '\t') {
+            return 0;
+        }
+        str++;
+    }
+    return 1;
+}
+
+// 清理输入缓冲区
 void clearInputBuffer() {
     int c;
     while ((c = getchar()) != '\n' && c != EOF);
 }
 
-// 验证成绩有效性
-int isValidScore(float score) {
-    return score >= 0 && score <= 100;
+// 验证成绩有效性
+int isValidScore(float score) {
+    return score >= 0 && score <= 100;
+}
+
+// 验证性别有效性
+int isValidGender(const char *gender) {
+    // 支持多种输入方式避免编码问题
+    return (strcmp(gender, "男") == 0 || 
+            strcmp(gender, "女") == 0 || 
+            strcmp(gender, "1") == 0 || 
+            strcmp(gender, "0") == 0 || 
+            strcmp(gender, "male") == 0 || 
+            strcmp(gender, "female") == 0 || 
+            strcmp(gender, "M") == 0 || 
+            strcmp(gender, "F") == 0);
+}
+
+// 验证学号有效性
+int isValidId(const char *id) {
+    if (isEmptyString(id)) return 0;
+    
+    // 验证长度（学号长度应在合理范围内）
+    int len = strlen(id);
+    if (len < 4 || len > 20) {
+        return 0;
+    }
+    
+    // 验证字符：只允许数字和字母
+    for (int i = 0; id[i] != '\0'; i++) {
+        if (!((id[i] >= '0' && id[i] <= '9') || 
+              (id[i] >= 'a' && id[i] <= 'z') || 
+              (id[i] >= 'A' && id[i] <= 'Z'))) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// 验证姓名有效性
+int isValidName(const char *name) {
+    if (isEmptyString(name)) return 0;
+    
+    // 验证长度
+    int len = strlen(name);
+    if (len < 1 || len > 20) {
+        return 0;
+    }
+    
+    
+    return 1;
+}
+
+// 计算快照校验和（按32位字累加的 Fletcher 变体，结尾不足4字节的部分补零）
+unsigned int snapshotChecksum(const unsigned char *data, size_t size) {
+    unsigned long long sum1 = 0, sum2 = 0;
+    size_t words = size / 4;
+    for (size_t i = 0; i < words; i++) {
+        unsigned int word;
+        memcpy(&word, data + i * 4, 4);
+        sum1 += word;
+        sum2 += sum1;
+    }
+    if (size % 4 != 0) {
+        unsigned int word = 0;
+        memcpy(&word, data + words * 4, size % 4);
+        sum1 += word;
+        sum2 += sum1;
+    }
+    return (unsigned int)(sum1 ^ (sum1 >> 32) ^ (sum2 << 7) ^ (sum2 >> 25));
+}
+
+// 以只读方式映射整个文件，成功返回1
+int mapFile(const char *path, MappedFile *mapped) {
+    memset(mapped, 0, sizeof(MappedFile));
+#ifdef _WIN32
+    mapped->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                               FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (mapped->file == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(mapped->file, &size) || size.QuadPart == 0) {
+        CloseHandle(mapped->file);
+        return 0;
+    }
+    mapped->size = (size_t)size.QuadPart;
+    mapped->mapping = CreateFileMappingA(mapped->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapped->mapping == NULL) {
+        CloseHandle(mapped->file);
+        return 0;
+    }
+    mapped->data = (const unsigned char *)MapViewOfFile(mapped->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (mapped->data == NULL) {
+        CloseHandle(mapped->mapping);
+        CloseHandle(mapped->file);
+        return 0;
+    }
+#else
+    mapped->fd = open(path, O_RDONLY);
+    if (mapped->fd < 0) {
+        return 0;
+    }
+    struct stat st;
+    if (fstat(mapped->fd, &st) != 0 || st.st_size == 0) {
+        close(mapped->fd);
+        return 0;
+    }
+    mapped->size = (size_t)st.st_size;
+    void *data = mmap(NULL, mapped->size, PROT_READ, MAP_PRIVATE, mapped->fd, 0);
+    if (data == MAP_FAILED) {
+        close(mapped->fd);
+        return 0;
+    }
+    madvise(data, mapped->size, MADV_SEQUENTIAL);
+    mapped->data = (const unsigned char *)data;
+#endif
+    return 1;
+}
+
+// 解除文件映射
+void unmapFile(MappedFile *mapped) {
+    if (mapped->data == NULL) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mapped->data);
+    CloseHandle(mapped->mapping);
+    CloseHandle(mapped->file);
+#else
+    munmap((void *)mapped->data, mapped->size);
+    close(mapped->fd);
+#endif
+    mapped->data = NULL;
+}
+
+// 向预设数组追加名称（不输出提示，用于从文件恢复预设），成功返回1
+int pushPresetName(char ***names, int *count, int *capacity, const char *name) {
+    if (*count >= *capacity) {
+        int newCapacity = *capacity * 2;
+        char **newNames = (char **)realloc(*names, sizeof(char *) * newCapacity);
+        if (newNames == NULL) {
+            return 0;
+        }
+        *names = newNames;
+        *capacity = newCapacity;
+    }
+    
+    (*names)[*count] = (char *)malloc(strlen(name) + 1);
+    if ((*names)[*count] == NULL) {
+        return 0;
+    }
+    strcpy((*names)[*count], name);
+    (*count)++;
+    return 1;
+}
+
+// 将学生转换为定长记录（成绩另行存放）
+void studentToRecord(StudentManager *manager, const Student *student, SnapshotStudent *record) {
+    memset(record, 0, sizeof(SnapshotStudent));
+    memcpy(record->name, student->name, sizeof(record->name));
+    memcpy(record->gender, student->gender, sizeof(record->gender));
+    memcpy(record->id, student->id, sizeof(record->id));
+    // 字典中的名称在录入时已限制长度，这里仍按定长字段截断
+    strncpy(record->className, dictString(&manager->strings, student->classId), sizeof(record->className) - 1);
+    strncpy(record->department, dictString(&manager->strings, student->departmentId), sizeof(record->department) - 1);
+    strncpy(record->major, dictString(&manager->strings, student->majorId), sizeof(record->major) - 1);
+    record->scoreCount = (unsigned int)student->scoreCount;
+    record->totalScore = (float)studentTotal(student);
+}
+
+// 由定长记录和成绩数组还原学生（成绩存入记录内或成绩池），成功返回1
+// nameIds 为快照索引区中该学生的班级、院系、专业编号（名称字典已从索引区恢复）；为NULL时把名称登记进字典
+int recordToStudent(StudentManager *manager, const SnapshotStudent *record, const float *scores,
+                    const int *nameIds, Student *student) {
+    char className[CLASS_NAME_SIZE];
+    char department[DEPARTMENT_NAME_SIZE];
+    char major[MAJOR_NAME_SIZE];
+    memcpy(student->name, record->name, sizeof(student->name));
+    memcpy(student->gender, record->gender, sizeof(student->gender));
+    memcpy(student->id, record->id, sizeof(student->id));
+    memcpy(className, record->className, sizeof(className));
+    memcpy(department, record->department, sizeof(department));
+    memcpy(major, record->major, sizeof(major));
+    student->name[sizeof(student->name) - 1] = '\0';
+    student->gender[sizeof(student->gender) - 1] = '\0';
+    student->id[sizeof(student->id) - 1] = '\0';
+    student->scoreCount = 0;
+    if (nameIds != NULL) {
+        for (int k = 0; k < 3; k++) {
+            if (nameIds[k] < 0 || nameIds[k] >= manager->strings.count) {
+                return 0;
+            }
+        }
+        student->classId = nameIds[0];
+        student->departmentId = nameIds[1];
+        student->majorId = nameIds[2];
+    } else {
+        className[sizeof(className) - 1] = '\0';
+        department[sizeof(department) - 1] = '\0';
+        major[sizeof(major) - 1] = '\0';
+        student->classId = dictIntern(&manager->strings, className);
+        student->departmentId = dictIntern(&manager->strings, department);
+        student->majorId = dictIntern(&manager->strings, major);
+    }
+    if (student->classId == -1 || student->departmentId == -1 || student->majorId == -1) {
+        return 0;
+    }
+    // 总和由 setStudentScores 按当前存储模式重新计算
+    return setStudentScores(&manager->scorePool, student, scores, (int)record->scoreCount);
+}
+
+// 向快照内容追加 size 字节（out 为NULL时只累计长度，用于先算出总大小），返回追加后的长度
+size_t snapshotPut(unsigned char *out, size_t used, const void *data, size_t size) {
+    if (out != NULL && size > 0) {
+        memcpy(out + used, data, size);
+    }
+    return used + size;
+}
+
+// 向快照内容追加一个无符号整数
+size_t snapshotPutUint(unsigned char *out, size_t used, unsigned int value) {
+    return snapshotPut(out, used, &value, sizeof(value));
+}
+
+// 向快照内容追加字典：数量、字节数、按编号依次以'\0'结尾的字符串
+size_t snapshotPutDict(unsigned char *out, size_t used, const StringDict *dict) {
+    used = snapshotPutUint(out, used, (unsigned int)dict->count);
+    used = snapshotPutUint(out, used, (unsigned int)dict->textBytes);
+    for (int i = 0; i < dict->count; i++) {
+        used = snapshotPut(out, used, dict->strings[i], strlen(dict->strings[i]) + 1);
+    }
+    return used;
+}
+
+// 向快照内容追加倒排索引：列表数、各列表长度、依次排列的学生下标
+size_t snapshotPutPostings(unsigned char *out, size_t used, const PostingIndex *postings) {
+    used = snapshotPutUint(out, used, (unsigned int)postings->capacity);
+    for (int i = 0; i < postings->capacity; i++) {
+        used = snapshotPutUint(out, used, (unsigned int)postings->lists[i].count);
+    }
+    for (int i = 0; i < postings->capacity; i++) {
+        used = snapshotPut(out, used, postings->lists[i].items, sizeof(int) * (size_t)postings->lists[i].count);
+    }
+    return used;
+}
+
+// 写出快照索引区（格式见 SnapshotReader），out 为NULL时只计算大小，返回索引区字节数
+// 只在学生存储没有待压缩的空位时调用：此时快照中的学生顺序就是内存中的下标，索引可以原样写出
+size_t serializeSnapshotIndexes(StudentManager *manager, unsigned char *out) {
+    size_t used = snapshotPutDict(out, 0, &manager->strings);
+    for (int i = 0; i < manager->count; i++) {
+        const Student *student = getStudent(manager, i);
+        int nameIds[3] = {student->classId, student->departmentId, student->majorId};
+        used = snapshotPut(out, used, nameIds, sizeof(nameIds));
+    }
+    used = snapshotPutDict(out, used, &manager->nameGrams);
+    used = snapshotPutDict(out, used, &manager->pinyinKeys);
+    
+    used = snapshotPutUint(out, used, (unsigned int)manager->idIndexCapacity);
+    used = snapshotPut(out, used, manager->idIndex, sizeof(IdIndexSlot) * (size_t)manager->idIndexCapacity);
+    const IdOrderIndex *order = &manager->idOrder;
+    used = snapshotPutUint(out, used, (unsigned int)order->sortedCount);
+    used = snapshotPut(out, used, order->sorted, sizeof(int) * (size_t)order->sortedCount);
+    used = snapshotPutUint(out, used, (unsigned int)order->deltaCount);
+    used = snapshotPutUint(out, used, (unsigned int)order->deltaSorted);
+    used = snapshotPut(out, used, order->delta, sizeof(int) * (size_t)order->deltaCount);
+    
+    const PostingIndex *postings[5] = {&manager->majorIndex, &manager->departmentIndex, &manager->classIndex,
+                                       &manager->nameIndex, &manager->pinyinIndex};
+    for (int k = 0; k < 5; k++) {
+        used = snapshotPutPostings(out, used, postings[k]);
+    }
+    used = snapshotPutUint(out, used, (unsigned int)manager->pinyinOrderCount);
+    used = snapshotPutUint(out, used, (unsigned int)manager->pinyinOrderSortedCount);
+    used = snapshotPut(out, used, manager->pinyinOrder, sizeof(int) * (size_t)manager->pinyinOrderCount);
+    return used;
+}
+
+// 从快照索引区取出 size 字节，剩余不足时返回NULL
+const unsigned char *snapshotTake(SnapshotReader *reader, size_t size) {
+    if (size > reader->left) {
+        return NULL;
+    }
+    const unsigned char *data = reader->data;
+    reader->data += size;
+    reader->left -= size;
+    return data;
+}
+
+// 从快照索引区取出一个无符号整数，成功返回1
+int snapshotTakeUint(SnapshotReader *reader, unsigned int *value) {
+    const unsigned char *data = snapshotTake(reader, sizeof(unsigned int));
+    if (data == NULL) {
+        return 0;
+    }
+    memcpy(value, data, sizeof(unsigned int));
+    return 1;
+}
+
+// 从快照索引区取出 count 个 int 拷入新分配的数组（count 为0时为NULL），每个值都须在 [low, high) 之内，成功返回1
+int snapshotTakeInts(SnapshotReader *reader, unsigned int count, int low, int high, int **items) {
+    *items = NULL;
+    if (count > reader->left / sizeof(int)) {
+        return 0;
+    }
+    const unsigned char *data = snapshotTake(reader, sizeof(int) * (size_t)count);
+    if (count == 0) {
+        return 1;
+    }
+    int *copy = (int *)malloc(sizeof(int) * (size_t)count);
+    if (copy == NULL) {
+        return 0;
+    }
+    memcpy(copy, data, sizeof(int) * (size_t)count);
+    for (unsigned int i = 0; i < count; i++) {
+        if (copy[i] < low || copy[i] >= high) {
+            free(copy);
+            return 0;
+        }
+    }
+    *items = copy;
+    return 1;
+}
+
+// 从快照索引区取出字典，按编号依次登记进空字典（编号与写出时相同），成功返回1
+int snapshotTakeDict(SnapshotReader *reader, StringDict *dict) {
+    unsigned int count, bytes;
+    if (!snapshotTakeUint(reader, &count) || !snapshotTakeUint(reader, &bytes)) {
+        return 0;
+    }
+    const char *text = (const char *)snapshotTake(reader, bytes);
+    if (text == NULL) {
+        return 0;
+    }
+    const char *end = text + bytes;
+    for (unsigned int i = 0; i < count; i++) {
+        size_t length = strnlen(text, (size_t)(end - text));
+        if (text + length >= end || dictIntern(dict, text) != (int)i) {
+            return 0;
+        }
+        text += length + 1;
+    }
+    return text == end;
+}
+
+// 从快照索引区取出倒排索引：有学生的列表编号须小于 keyCount（对应字典的字符串数），学生下标须小于 studentCount
+// 各列表按实际长度分配。成功返回1，失败时已取出的部分留给 postingFree 释放
+int snapshotTakePostings(SnapshotReader *reader, PostingIndex *postings, int keyCount, int studentCount) {
+    unsigned int capacity;
+    if (!snapshotTakeUint(reader, &capacity) || capacity > reader->left / sizeof(unsigned int)) {
+        return 0;
+    }
+    const unsigned char *counts = snapshotTake(reader, sizeof(unsigned int) * (size_t)capacity);
+    if (capacity == 0) {
+        return 1;
+    }
+    postings->lists = (PostingList *)calloc(capacity, sizeof(PostingList));
+    if (postings->lists == NULL) {
+        return 0;
+    }
+    postings->capacity = (int)capacity;
+    for (unsigned int i = 0; i < capacity; i++) {
+        unsigned int count;
+        memcpy(&count, counts + sizeof(unsigned int) * i, sizeof(count));
+        PostingList *list = &postings->lists[i];
+        if ((count > 0 && (int)i >= keyCount) || !snapshotTakeInts(reader, count, 0, studentCount, &list->items)) {
+            return 0;
+        }
+        list->count = (int)count;
+        list->capacity = (int)count;
+    }
+    return 1;
+}
+
+// 从快照索引区恢复学号哈希、学号有序索引、倒排、姓名字元与拼音索引（名称字典与各学生的字典编号
+// 已在载入学生记录前取出）。成功返回1；失败时已恢复的部分由调用者用 clearStudentIndexes 清掉后重建
+int loadSnapshotIndexes(StudentManager *manager, SnapshotReader *reader) {
+    if (!snapshotTakeDict(reader, &manager->nameGrams) || !snapshotTakeDict(reader, &manager->pinyinKeys)) {
+        return 0;
+    }
+    
+    // 学号哈希：槽位数为2的幂并至少留有一个空槽，槽位中是学生下标、空槽或删除标记
+    unsigned int slotCapacity;
+    if (!snapshotTakeUint(reader, &slotCapacity) || slotCapacity == 0 || (slotCapacity & (slotCapacity - 1)) != 0 ||
+        slotCapacity > reader->left / sizeof(IdIndexSlot)) {
+        return 0;
+    }
+    IdIndexSlot *slots = (IdIndexSlot *)malloc(sizeof(IdIndexSlot) * (size_t)slotCapacity);
+    if (slots == NULL) {
+        return 0;
+    }
+    memcpy(slots, snapshotTake(reader, sizeof(IdIndexSlot) * (size_t)slotCapacity), sizeof(IdIndexSlot) * (size_t)slotCapacity);
+    unsigned int used = 0;
+    for (unsigned int i = 0; i < slotCapacity; i++) {
+        if (slots[i].index < ID_INDEX_DELETED || slots[i].index >= manager->count) {
+            free(slots);
+            return 0;
+        }
+        used += slots[i].index != ID_INDEX_EMPTY;
+    }
+    if (used >= slotCapacity) {
+        free(slots);
+        return 0;
+    }
+    free(manager->idIndex);
+    manager->idIndex = slots;
+    manager->idIndexCapacity = (int)slotCapacity;
+    manager->idIndexUsed = (int)used;
+    
+    // 学号有序索引：主数组与增量缓冲区合起来恰好是全部学生
+    IdOrderIndex *order = &manager->idOrder;
+    unsigned int count, flag;
+    idOrderFree(order);
+    if (!snapshotTakeUint(reader, &count) || !snapshotTakeInts(reader, count, 0, manager->count, &order->sorted)) {
+        return 0;
+    }
+    order->sortedCount = (int)count;
+    order->sortedCapacity = (int)count;
+    if (!snapshotTakeUint(reader, &count) || !snapshotTakeUint(reader, &flag) ||
+        !snapshotTakeInts(reader, count, 0, manager->count, &order->delta)) {
+        return 0;
+    }
+    order->deltaCount = (int)count;
+    order->deltaCapacity = (int)count;
+    order->deltaSorted = flag != 0;
+    if (order->sortedCount + order->deltaCount != manager->count) {
+        return 0;
+    }
+    
+    PostingIndex *postings[5] = {&manager->majorIndex, &manager->departmentIndex, &manager->classIndex,
+                                 &manager->nameIndex, &manager->pinyinIndex};
+    int keyCounts[5] = {manager->strings.count, manager->strings.count, manager->strings.count,
+                        manager->nameGrams.count, manager->pinyinKeys.count};
+    for (int k = 0; k < 5; k++) {
+        if (!snapshotTakePostings(reader, postings[k], keyCounts[k], manager->count)) {
+            return 0;
+        }
+    }
+    
+    if (!snapshotTakeUint(reader, &count) || !snapshotTakeUint(reader, &flag) || flag > count ||
+        !snapshotTakeInts(reader, count, 0, manager->pinyinKeys.count, &manager->pinyinOrder)) {
+        return 0;
+    }
+    manager->pinyinOrderCount = (int)count;
+    manager->pinyinOrderCapacity = (int)count;
+    manager->pinyinOrderSortedCount = (int)flag;
+    return reader->left == 0;
+}
+
+// 清空学号有序索引、倒排索引、姓名字元与拼音索引（从快照恢复索引失败、改为重建之前调用；学号哈希由重建整体替换）
+void clearStudentIndexes(StudentManager *manager) {
+    postingFree(&manager->majorIndex);
+    postingFree(&manager->departmentIndex);
+    postingFree(&manager->classIndex);
+    postingFree(&manager->nameIndex);
+    postingFree(&manager->pinyinIndex);
+    dictFree(&manager->nameGrams);
+    dictFree(&manager->pinyinKeys);
+    free(manager->pinyinOrder);
+    manager->pinyinOrder = NULL;
+    manager->pinyinOrderCount = 0;
+    manager->pinyinOrderCapacity = 0;
+    manager->pinyinOrderSortedCount = 0;
+    idOrderFree(&manager->idOrder);
+}
+
+// 将管理器序列化为完整的快照文件内容（含文件头），失败返回NULL
+unsigned char *serializeSnapshot(StudentManager *manager, unsigned int journalGeneration, size_t *size) {
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, 4);
+    header.version = SNAPSHOT_VERSION;
+    header.studentCount = (unsigned int)liveStudentCount(manager);
+    header.scoreNameCount = (unsigned int)manager->scoreNameCount;
+    header.departmentCount = (unsigned int)manager->departmentCount;
+    header.majorCount = (unsigned int)manager->majorCount;
+    header.journalGeneration = journalGeneration;
+    
+    // 计算各区大小并拼出预设字符串区
+    for (int i = 0; i < manager->count; i++) {
+        header.scoreTotal += (unsigned int)getStudent(manager, i)->scoreCount;
+    }
+    char **presetLists[3] = {manager->scoreNames, manager->departmentNames, manager->majorNames};
+    int presetCounts[3] = {manager->scoreNameCount, manager->departmentCount, manager->majorCount};
+    for (int list = 0; list < 3; list++) {
+        for (int i = 0; i < presetCounts[list]; i++) {
+            header.stringBytes += (unsigned int)strlen(presetLists[list][i]) + 1;
+        }
+    }
+    
+    // 学生存储没有待压缩的空位时附上索引区，加载时整块拷入，不必重建索引
+    if (header.studentCount == (unsigned int)manager->count) {
+        size_t indexBytes = serializeSnapshotIndexes(manager, NULL);
+        header.indexBytes = indexBytes <= UINT_MAX ? (unsigned int)indexBytes : 0;
+    }
+    
+    size_t bodySize = sizeof(SnapshotStudent) * header.studentCount +
+                      sizeof(float) * header.scoreTotal + header.stringBytes + header.indexBytes;
+    unsigned char *data = (unsigned char *)malloc(sizeof(SnapshotHeader) + bodySize);
+    if (data == NULL) {
+        return NULL;
+    }
+    
+    unsigned char *body = data + sizeof(SnapshotHeader);
+    SnapshotStudent *records = (SnapshotStudent *)body;
+    float *scores = (float *)(body + sizeof(SnapshotStudent) * header.studentCount);
+    char *strings = (char *)(scores + header.scoreTotal);
+    unsigned int scoreOffset = 0;
+    int written = 0;
+    for (int i = 0; i < manager->count; i++) {
+        const Student *student = getStudent(manager, i);
+        if (student->deleted) {
+            continue;
+        }
+        studentToRecord(manager, student, &records[written]);
+        records[written].scoreOffset = scoreOffset;
+        copyStudentScores(student, scores + scoreOffset);
+        scoreOffset += (unsigned int)student->scoreCount;
+        written++;
+    }
+    for (int list = 0; list < 3; list++) {
+        for (int i = 0; i < presetCounts[list]; i++) {
+            size_t len = strlen(presetLists[list][i]) + 1;
+            memcpy(strings, presetLists[list][i], len);
+            strings += len;
+        }
+    }
+    if (header.indexBytes > 0) {
+        serializeSnapshotIndexes(manager, (unsigned char *)strings);
+    }
+    header.checksum = snapshotChecksum(body, bodySize);
+    memcpy(data, &header, sizeof(SnapshotHeader));
+    
+    *size = sizeof(SnapshotHeader) + bodySize;
+    return data;
+}
+
+// 将数据强制落盘
+int syncFile(FILE *file) {
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// 写入快照文件（先写临时文件并落盘，再替换，避免写到一半时损坏旧快照），成功返回1
+int writeSnapshotFile(const char *path, const unsigned char *data, size_t size) {
+    char tempPath[260];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+    FILE *file = fopen(tempPath, "wb");
+    if (file == NULL) {
+        return 0;
+    }
+    int ok = fwrite(data, size, 1, file) == 1 && fflush(file) == 0 && syncFile(file);
+    ok = fclose(file) == 0 && ok;
+    if (!ok) {
+        remove(tempPath);
+        return 0;
+    }
+    
+#ifdef _WIN32
+    if (!MoveFileExA(tempPath, path, MOVEFILE_REPLACE_EXISTING)) {
+        remove(tempPath);
+        return 0;
+    }
+#else
+    if (rename(tempPath, path) != 0) {
+        remove(tempPath);
+        return 0;
+    }
+#endif
+    return 1;
+}
+
+// 保存数据快照，成功返回1
+int saveSnapshot(StudentManager *manager, const char *path) {
+    // 保存时顺带压缩逐个删除留下的空位（快照本身不含空位）
+    compactStudents(manager);
+    // 快照包含当前日志的全部内容，记录下一代日志编号，之前各代日志在加载时跳过
+    unsigned int journalGeneration = manager->journal != NULL ? manager->journal->generation + 1 : 0;
+    size_t size;
+    unsigned char *data = serializeSnapshot(manager, journalGeneration, &size);
+    if (data == NULL) {
+        return 0;
+    }
+    int ok = writeSnapshotFile(path, data, size);
+    free(data);
+    return ok;
+}
+
+// 通过内存映射加载数据快照，journalGeneration 返回快照已包含的日志代数（可为NULL）
+// 返回学生数量；文件不存在返回-1；格式或校验错误返回-2（损坏的文件会被改名为 .bad 保留）
+// 也接受没有索引区的版本1快照，加载后重建索引
+int loadSnapshot(StudentManager *manager, const char *path, unsigned int *journalGeneration) {
+    MappedFile mapped;
+    if (!mapFile(path, &mapped)) {
+        return -1;
+    }
+    
+    // 文件头拷出来读：版本1的文件头较短，没有的字段为0
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    size_t headerSize = 0;
+    if (mapped.size >= SNAPSHOT_V1_HEADER_SIZE) {
+        memcpy(&header, mapped.data, SNAPSHOT_V1_HEADER_SIZE);
+        headerSize = header.version == 1 ? SNAPSHOT_V1_HEADER_SIZE : sizeof(SnapshotHeader);
+    }
+    size_t bodySize = 0;
+    int valid = headerSize > 0 && mapped.size >= headerSize &&
+                memcmp(header.magic, SNAPSHOT_MAGIC, 4) == 0 &&
+                (header.version == 1 || header.version == SNAPSHOT_VERSION);
+    if (valid) {
+        memcpy(&header, mapped.data, headerSize);
+        bodySize = sizeof(SnapshotStudent) * (size_t)header.studentCount +
+                   sizeof(float) * (size_t)header.scoreTotal + header.stringBytes + header.indexBytes;
+        valid = mapped.size - headerSize == bodySize &&
+                snapshotChecksum(mapped.data + headerSize, bodySize) == header.checksum;
+    }
+    if (!valid) {
+        unmapFile(&mapped);
+        char badPath[260];
+        snprintf(badPath, sizeof(badPath), "%s.bad", path);
+        remove(badPath);
+        rename(path, badPath);
+        return -2;
+    }
+    if (journalGeneration != NULL) {
+        *journalGeneration = header.journalGeneration;
+    }
+    
+    // 恢复预设（字符串区在成绩数组之后，逐个以'\0'结尾）
+    const unsigned char *body = mapped.data + headerSize;
+    const SnapshotStudent *records = (const SnapshotStudent *)body;
+    const float *scores = (const float *)(body + sizeof(SnapshotStudent) * header.studentCount);
+    const char *strings = (const char *)(scores + header.scoreTotal);
+    const char *stringsEnd = strings + header.stringBytes;
+    char ***presetLists[3] = {&manager->scoreNames, &manager->departmentNames, &manager->majorNames};
+    int *presetCounts[3] = {&manager->scoreNameCount, &manager->departmentCount, &manager->majorCount};
+    int *presetCapacities[3] = {&manager->scoreNameCapacity, &manager->departmentCapacity, &manager->majorCapacity};
+    unsigned int presetTotals[3] = {header.scoreNameCount, header.departmentCount, header.majorCount};
+    for (int list = 0; list < 3; list++) {
+        for (unsigned int i = 0; i < presetTotals[list] && strings < stringsEnd; i++) {
+            size_t len = strnlen(strings, (size_t)(stringsEnd - strings));
+            if (strings + len >= stringsEnd) {
+                break;
+            }
+            pushPresetName(presetLists[list], presetCounts[list], presetCapacities[list], strings);
+            strings += len + 1;
+        }
+    }
+    
+    // 有索引区时先恢复名称字典并取出各学生的字典编号，学生记录不必逐条登记名称
+    SnapshotReader reader = {(const unsigned char *)stringsEnd, header.indexBytes};
+    const unsigned char *nameIds = NULL;
+    if (header.indexBytes > 0) {
+        if (snapshotTakeDict(&reader, &manager->strings)) {
+            nameIds = snapshotTake(&reader, sizeof(int) * 3 * (size_t)header.studentCount);
+        }
+        if (nameIds == NULL) {
+            dictFree(&manager->strings);
+        }
+    }
+    
+    // 恢复学生记录：定长字段直接拷贝，成绩数组按记录的偏移取出
+    // 先预留全部学生块并逐条拷入，最后统一恢复或建立索引（只用于刚初始化的空管理器）
+    while ((long long)manager->capacity < (long long)header.studentCount && growStudentStore(manager)) {
+    }
+    Student student;
+    for (unsigned int i = 0; i < header.studentCount; i++) {
+        const SnapshotStudent *record = &records[i];
+        if ((size_t)record->scoreOffset + record->scoreCount > header.scoreTotal) {
+            continue;
+        }
+        if (manager->count >= manager->capacity && !growStudentStore(manager)) {
+            break;
+        }
+        int keys[3];
+        if (nameIds != NULL) {
+            memcpy(keys, nameIds + sizeof(keys) * i, sizeof(keys));
+        }
+        if (!recordToStudent(manager, record, scores + record->scoreOffset, nameIds != NULL ? keys : NULL, &student)) {
+            break;
+        }
+        student.deleted = 0;
+        *getStudent(manager, manager->count++) = student;
+    }
+    
+    // 学生全部载入时索引区的下标与之一一对应，整块拷入；否则（版本1快照、跳过了记录、索引区无效或内存不足）重建
+    int restored = nameIds != NULL && manager->count == (int)header.studentCount &&
+                   loadSnapshotIndexes(manager, &reader);
+    unmapFile(&mapped);
+    if (!restored) {
+        clearStudentIndexes(manager);
+        if (!buildStudentIndexes(manager)) {
+            // 内存不足：与逐条追加失败时一样放弃这些学生
+            for (int i = 0; i < manager->count; i++) {
+                releaseStudentScores(&manager->scorePool, getStudent(manager, i));
+            }
+            manager->count = 0;
+        }
+    }
+    return manager->count;
+}
+
+// 获取单调递增的毫秒时间
+long long currentTimeMs() {
+#ifdef _WIN32
+    return (long long)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
+
+// 获取单调递增的微秒时间（计时毫秒以下的操作用）
+double currentTimeUs() {
+#ifdef _WIN32
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double)counter.QuadPart * 1000000.0 / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+#endif
+}
+
+#ifdef _WIN32
+// Windows 线程入口适配
+typedef struct {
+    void *(*func)(void *);
+    void *arg;
+} ThreadStart;
+
+DWORD WINAPI threadTrampoline(LPVOID param) {
+    ThreadStart start = *(ThreadStart *)param;
+    free(param);
+    start.func(start.arg);
+    return 0;
+}
+#endif
+
+// 启动线程，成功返回1
+int startThread(SimsThread *thread, void *(*func)(void *), void *arg) {
+#ifdef _WIN32
+    ThreadStart *start = (ThreadStart *)malloc(sizeof(ThreadStart));
+    if (start == NULL) {
+        return 0;
+    }
+    start->func = func;
+    start->arg = arg;
+    *thread = CreateThread(NULL, 0, threadTrampoline, start, 0, NULL);
+    if (*thread == NULL) {
+        free(start);
+        return 0;
+    }
+    return 1;
+#else
+    return pthread_create(thread, NULL, func, arg) == 0;
+#endif
+}
+
+// 等待线程结束
+void joinThread(SimsThread thread) {
+#ifdef _WIN32
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
+// 创建新的日志文件（覆盖同名文件），失败返回NULL
+Journal *journalOpen(const char *path, unsigned int generation) {
+    Journal *journal = (Journal *)malloc(sizeof(Journal));
+    if (journal == NULL) {
+        return NULL;
+    }
+    memset(journal, 0, sizeof(Journal));
+    
+    journal->buffer = (unsigned char *)malloc(JOURNAL_BUFFER_SIZE);
+    journal->file = fopen(path, "wb");
+    if (journal->buffer == NULL || journal->file == NULL) {
+        if (journal->file != NULL) {
+            fclose(journal->file);
+        }
+        free(journal->buffer);
+        free(journal);
+        return NULL;
+    }
+    // 日志由自身的缓冲区成组写出，关闭 stdio 缓冲
+    setvbuf(journal->file, NULL, _IONBF, 0);
+    
+    JournalFileHeader header;
+    memcpy(header.magic, JOURNAL_MAGIC, 4);
+    header.generation = generation;
+    if (fwrite(&header, sizeof(header), 1, journal->file) != 1 || !syncFile(journal->file)) {
+        fclose(journal->file);
+        free(journal->buffer);
+        free(journal);
+        return NULL;
+    }
+    
+    strncpy(journal->path, path, sizeof(journal->path) - 1);
+    journal->generation = generation;
+    journal->bytesWritten = sizeof(header);
+    journal->lastSyncMs = currentTimeMs();
+    return journal;
+}
+
+// 将缓冲区中的记录成组写入日志文件
+// 未落盘记录达到 JOURNAL_GROUP_COMMIT 条、距上次落盘超过 JOURNAL_SYNC_INTERVAL_MS 或 forceSync 时执行 fsync
+int journalCommit(Journal *journal, int forceSync) {
+    if (journal->used > 0) {
+        if (fwrite(journal->buffer, journal->used, 1, journal->file) != 1) {
+            journal->failed = 1;
+            return 0;
+        }
+        journal->bytesWritten += (long long)journal->used;
+        journal->used = 0;
+    }
+    
+    if (journal->unsyncedRecords > 0 &&
+        (forceSync || journal->unsyncedRecords >= JOURNAL_GROUP_COMMIT ||
+         currentTimeMs() - journal->lastSyncMs >= JOURNAL_SYNC_INTERVAL_MS)) {
+        if (!syncFile(journal->file)) {
+            journal->failed = 1;
+            return 0;
+        }
+        journal->unsyncedRecords = 0;
+        journal->lastSyncMs = currentTimeMs();
+    }
+    return 1;
+}
+
+// 向日志缓冲区追加一条记录，缓冲区满时先写出，成功返回1
+int journalAppend(Journal *journal, unsigned char type, const void *payload, unsigned int length) {
+    size_t recordSize = sizeof(JournalRecordHeader) + length;
+    if (journal->used + recordSize > JOURNAL_BUFFER_SIZE && !journalCommit(journal, 0)) {
+        return 0;
+    }
+    if (recordSize > JOURNAL_BUFFER_SIZE) {
+        return 0;
+    }
+    
+    JournalRecordHeader header;
+    memset(&header, 0, sizeof(header));
+    header.length = length;
+    header.checksum = snapshotChecksum((const unsigned char *)payload, length);
+    header.type = type;
+    memcpy(journal->buffer + journal->used, &header, sizeof(header));
+    memcpy(journal->buffer + journal->used + sizeof(header), payload, length);
+    journal->used += recordSize;
+    journal->unsyncedRecords++;
+    return 1;
+}
+
+// 等待后台压缩结束，返回上次压缩是否已写出快照（失败时 .old 日志仍保留在磁盘上）
+int journalWaitCompaction(Journal *journal) {
+    if (journal->compacting) {
+        joinThread(journal->compactThread);
+        journal->compacting = 0;
+    }
+    return !journal->compactFailed;
+}
+
+// 关闭日志（等待后台压缩完成，剩余记录写出并落盘）
+void journalClose(Journal *journal) {
+    if (journal == NULL) {
+        return;
+    }
+    journalWaitCompaction(journal);
+    journalCommit(journal, 1);
+    fclose(journal->file);
+    free(journal->buffer);
+    free(journal);
+}
+
+// 生成新增或修改记录的内容：定长记录后接成绩数组（最多 JOURNAL_MAX_SCORES 门），返回字节数
+// payload 的容量须不小于 sizeof(SnapshotStudent) + sizeof(float) * JOURNAL_MAX_SCORES
+unsigned int journalStudentPayload(StudentManager *manager, const Student *student, unsigned char *payload) {
+    SnapshotStudent record;
+    int scoreCount = student->scoreCount < JOURNAL_MAX_SCORES ? student->scoreCount : JOURNAL_MAX_SCORES;
+    studentToRecord(manager, student, &record);
+    record.scoreCount = (unsigned int)scoreCount;
+    memcpy(payload, &record, sizeof(record));
+    for (int i = 0; i < scoreCount; i++) {
+        float score = studentScore(student, i);
+        memcpy(payload + sizeof(record) + sizeof(float) * i, &score, sizeof(float));
+    }
+    return (unsigned int)(sizeof(record) + sizeof(float) * scoreCount);
+}
+
+// 记录学生的新增或修改（保存修改后的完整记录，重放时按学号覆盖）
+void journalRecordStudent(StudentManager *manager, unsigned char type, const Student *student) {
+    if (manager->journal == NULL) {
+        return;
+    }
+    unsigned char payload[sizeof(SnapshotStudent) + sizeof(float) * JOURNAL_MAX_SCORES];
+    unsigned int length = journalStudentPayload(manager, student, payload);
+    journalAppend(manager->journal, type, payload, length);
+    journalCommit(manager->journal, 0);
+    compactJournalIfNeeded(manager);
+}
+
+// 记录学生删除
+void journalRecordDelete(StudentManager *manager, const char *id) {
+    if (manager->journal == NULL) {
+        return;
+    }
+    journalAppend(manager->journal, JOURNAL_DELETE, id, (unsigned int)strlen(id) + 1);
+    journalCommit(manager->journal, 0);
+    compactJournalIfNeeded(manager);
+}
+
+// 记录预设的添加（name 非NULL）或清除（name 为NULL）
+void journalRecordPreset(StudentManager *manager, int list, const char *name) {
+    if (manager->journal == NULL) {
+        return;
+    }
+    unsigned char payload[64];
+    unsigned int length = 1;
+    payload[0] = (unsigned char)list;
+    if (name != NULL) {
+        size_t len = strlen(name) + 1;
+        if (len > sizeof(payload) - 1) {
+            return;
+        }
+        memcpy(payload + 1, name, len);
+        length += (unsigned int)len;
+    }
+    journalAppend(manager->journal, name != NULL ? JOURNAL_PRESET_ADD : JOURNAL_PRESET_CLEAR, payload, length);
+    journalCommit(manager->journal, 0);
+}
+
+// 把下标为 index 的学生标记为已删除：移出学号哈希索引、总分排行与成绩分布，成绩存储立即归还成绩池
+// 学生暂时留在原位置，倒排、姓名、学号有序索引中的旧下标留到 compactStudents 一次性清理，
+// 因此每次标记与学生总数无关（排行另需 O(log n)）。已标记过返回0，成功返回1，内存不足返回-1
+// 只标记不压缩时倒排列表里仍有旧下标，调用者须在返回前用 compactOrUnlinkDeleted 清理（批量删除、日志重放）；
+// 逐个删除用 removeStudentAt
+int markStudentDeleted(StudentManager *manager, int index) {
+    Student *student = getStudent(manager, index);
+    if (student->deleted) {
+        return 0;
+    }
+    if (manager->deletedCount >= manager->deletedCapacity) {
+        int newCapacity = manager->deletedCapacity == 0 ? 64 : manager->deletedCapacity * 2;
+        int *newSlots = (int *)realloc(manager->deletedSlots, sizeof(int) * (size_t)newCapacity);
+        if (newSlots == NULL) {
+            return -1;
+        }
+        manager->deletedSlots = newSlots;
+        manager->deletedCapacity = newCapacity;
+    }
+    idIndexRemove(manager, student->id);
+    unindexStudentScores(manager, index);
+    releaseStudentScores(&manager->scorePool, student);
+    student->deleted = 1;
+    manager->deletedSlots[manager->deletedCount++] = index;
+    return 1;
+}
+
+// 把学生移出专业/院系/班级倒排与姓名、拼音索引（学生已不在列表中的不受影响）
+void unlinkStudentPostings(StudentManager *manager, int index) {
+    const Student *student = getStudent(manager, index);
+    postingRemove(&manager->majorIndex, student->majorId, index);
+    postingRemove(&manager->departmentIndex, student->departmentId, index);
+    postingRemove(&manager->classIndex, student->classId, index);
+    unindexStudentName(manager, index);
+}
+
+// 清理只标记未压缩的学生：先尝试压缩；内存不足压缩失败时，逐个把空位移出倒排与姓名索引，
+// 筛选、按姓名查找等不会再返回已删除的学生，空位留到下次压缩。压缩成功返回1，退回逐个移出返回0
+int compactOrUnlinkDeleted(StudentManager *manager) {
+    if (compactStudents(manager)) {
+        return 1;
+    }
+    for (int d = 0; d < manager->deletedCount; d++) {
+        unlinkStudentPostings(manager, manager->deletedSlots[d]);
+    }
+    invalidateColumns(manager);
+    return 0;
+}
+
+// 压缩学生存储：未删除的学生按原顺序前移，填满已删除学生留下的空位，
+// 再用一张“旧下标 -> 新下标”映射表一次性改写全部索引，并归还多余的学生块。
+// 耗时 O(n + 索引总长)，与这一批删除了多少人无关，批量删除只需压缩一次。内存不足返回0（标记保留，下次再压缩）
+int compactStudents(StudentManager *manager) {
+    if (manager->deletedCount == 0) {
+        return 1;
+    }
+    int *remap = (int *)malloc(sizeof(int) * (size_t)manager->count);
+    if (remap == NULL) {
+        return 0;
+    }
+    for (int i = 0; i < manager->count; i++) {
+        remap[i] = i;
+    }
+    int first = manager->count;
+    for (int d = 0; d < manager->deletedCount; d++) {
+        remap[manager->deletedSlots[d]] = -1;
+        if (manager->deletedSlots[d] < first) {
+            first = manager->deletedSlots[d];
+        }
+    }
+    
+    // 第一个空位之前的学生不动，之后的学生依次前移
+    int kept = first;
+    for (int i = first; i < manager->count; i++) {
+        if (remap[i] == -1) {
+            continue;
+        }
+        remap[i] = kept;
+        *getStudent(manager, kept) = *getStudent(manager, i);
+        kept++;
+    }
+    
+    // 学号哈希索引顺序扫一遍槽位改写下标，不必逐个按学号重新查找（已删除学生的槽位已是删除标记）
+    // 映射为-1的槽位也只能改成删除标记：改成空槽会截断经过它的探测链，链上后面的学号将查不到
+    for (int i = 0; i < manager->idIndexCapacity; i++) {
+        if (manager->idIndex[i].index >= 0) {
+            int to = remap[manager->idIndex[i].index];
+            manager->idIndex[i].index = to != -1 ? to : ID_INDEX_DELETED;
+        }
+    }
+    postingRemap(&manager->majorIndex, remap, first);
+    postingRemap(&manager->departmentIndex, remap, first);
+    postingRemap(&manager->classIndex, remap, first);
+    postingRemap(&manager->nameIndex, remap, first);
+    postingRemap(&manager->pinyinIndex, remap, first);
+    idOrderRemap(manager, remap);
+    rankRemapAll(manager, remap);
+    invalidateColumns(manager);
+    free(remap);
+    manager->count = kept;
+    manager->deletedCount = 0;
+    
+    // 只保留容纳现有学生所需的块再加一个备用块
+    while (manager->chunkCount > (manager->count >> STUDENT_CHUNK_SHIFT) + 2) {
+        free(manager->studentChunks[--manager->chunkCount]);
+        manager->capacity -= STUDENT_CHUNK_SIZE;
+    }
+    return 1;
+}
+
+// 核对各索引与学生数据是否一致，返回不一致的项数（自检与性能测试使用）
+// 学号哈希、专业/院系/班级倒排与学号有序索引，以及已建立的全体排行和成绩分布，都应恰好包含全部未删除的学生
+int checkStudentIndexes(StudentManager *manager) {
+    PostingIndex *postings[3] = {&manager->majorIndex, &manager->departmentIndex, &manager->classIndex};
+    int errors = 0;
+    int live = 0, withScores = 0;
+    for (int i = 0; i < manager->count; i++) {
+        const Student *student = getStudent(manager, i);
+        if (student->deleted) {
+            continue;
+        }
+        live++;
+        withScores += student->scoreCount > 0;
+        errors += findStudentById(manager, student->id) != i;
+        int keys[3] = {student->majorId, student->departmentId, student->classId};
+        for (int k = 0; k < 3; k++) {
+            const PostingList *list = postingFind(postings[k], keys[k]);
+            int pos = list != NULL ? postingLowerBound(list, i) : 0;
+            errors += list == NULL || pos >= list->count || list->items[pos] != i;
+        }
+    }
+    for (int k = 0; k < 3; k++) {
+        int total = 0;
+        for (int key = 0; key < postings[k]->capacity; key++) {
+            total += postings[k]->lists[key].count;
+        }
+        errors += total != live;
+    }
+    int matched;
+    free(findStudentsByIdPrefix(manager, "", &matched));
+    errors += matched != live;
+    if (manager->rankAll.built) {
+        errors += rankSize(&manager->rankAll, manager->rankAll.root) != live;
+    }
+    if (manager->histogramAll.built) {
+        errors += (manager->histogramAll.courseCount > 0 ? manager->histogramAll.totals[0] : 0) != withScores;
+    }
+    return errors;
+}
+
+// 空位超过 1/DELETE_COMPACT_RATIO 时压缩，逐个删除的压缩开销分摊到每次删除为 O(1)。压缩失败返回0
+int compactStudentsIfNeeded(StudentManager *manager) {
+    if ((long long)manager->deletedCount * DELETE_COMPACT_RATIO <= manager->count) {
+        return 1;
+    }
+    return compactStudents(manager);
+}
+
+// 未删除的学生人数（manager->count 含尚未压缩的空位）
+int liveStudentCount(StudentManager *manager) {
+    return manager->count - manager->deletedCount;
+}
+
+// 逐个删除下标为 index 的学生，内存不足返回0
+// 学生立即移出全部倒排与姓名索引，只在学生数组中留下空位（按下标顺序扫描的地方跳过空位），
+// 不必每删一人就把后面的学生整体前移；空位积累到一定比例，或保存快照时再统一压缩。
+// 空位不给新学生复用：学生数组的顺序就是录入顺序（列表、导出按此顺序），
+// 倒排列表也依赖新学生下标最大、直接追加在末尾，填回中间的空位会打乱这两者
+int removeStudentAt(StudentManager *manager, int index) {
+    if (markStudentDeleted(manager, index) == -1) {
+        return 0;
+    }
+    unlinkStudentPostings(manager, index);
+    invalidateColumns(manager);
+    compactStudentsIfNeeded(manager);
+    return 1;
+}
+
+// 批量删除一组学生：逐个标记后只压缩一次，耗时与学生总数成线性。返回删除人数（内存不足时只删除已标记的部分）
+int bulkDeleteStudents(StudentManager *manager, const int *indexes, int count) {
+    int deleted = 0;
+    for (int i = 0; i < count; i++) {
+        int marked = markStudentDeleted(manager, indexes[i]);
+        if (marked == -1) {
+            break;
+        }
+        deleted += marked;
+    }
+    compactOrUnlinkDeleted(manager);
+    return deleted;
+}
+
+// 把专业 fromMajorId 的学生整体转入专业 toMajorId，返回转入人数，内存不足返回-1（数据不变）
+// 排行与成绩分布逐个调整；专业倒排列表不逐个增删，直接把两个升序列表归并成一个
+int bulkMoveMajor(StudentManager *manager, int fromMajorId, int toMajorId) {
+    PostingList *target = postingGet(&manager->majorIndex, toMajorId);
+    if (target == NULL) {
+        return -1;
+    }
+    PostingList *source = postingFind(&manager->majorIndex, fromMajorId);
+    if (source == NULL || source->count == 0 || fromMajorId == toMajorId) {
+        return 0;
+    }
+    int total = target->count + source->count;
+    int *merged = (int *)malloc(sizeof(int) * (size_t)total);
+    if (merged == NULL) {
+        return -1;
+    }
+    int a = 0, b = 0, k = 0;
+    while (a < target->count || b < source->count) {
+        if (b >= source->count || (a < target->count && target->items[a] < source->items[b])) {
+            merged[k++] = target->items[a++];
+        } else {
+            merged[k++] = source->items[b++];
+        }
+    }
+    
+    for (int i = 0; i < source->count; i++) {
+        int index = source->items[i];
+        unindexStudentScores(manager, index);
+        getStudent(manager, index)->majorId = toMajorId;
+        indexStudentScores(manager, index);
+    }
+    int moved = source->count;
+    free(target->items);
+    target->items = merged;
+    target->count = total;
+    target->capacity = total;
+    source->count = 0;
+    invalidateColumns(manager);
+    return moved;
+}
+
+// 给一组学生的第 course 门成绩（从0开始）加 delta 分，结果超出0~100分的按边界计
+// 没有这门成绩或加分后分数不变的学生不计入；返回改动人数，内存不足返回-1（之前的学生已改动）
+int bulkAddScore(StudentManager *manager, const int *indexes, int count, int course, float delta) {
+    int maxScores = 1;
+    for (int i = 0; i < count; i++) {
+        if (getStudent(manager, indexes[i])->scoreCount > maxScores) {
+            maxScores = getStudent(manager, indexes[i])->scoreCount;
+        }
+    }
+    float *scores = (float *)malloc(sizeof(float) * (size_t)maxScores);
+    if (scores == NULL) {
+        return -1;
+    }
+    
+    int changed = 0;
+    for (int i = 0; i < count; i++) {
+        int index = indexes[i];
+        Student *student = getStudent(manager, index);
+        int scoreCount = student->scoreCount;
+        if (scoreCount <= course) {
+            continue;
+        }
+        copyStudentScores(student, scores);
+        float value = scores[course] + delta;
+        value = value < 0.0f ? 0.0f : (value > 100.0f ? 100.0f : value);
+        if (value == scores[course]) {
+            continue;
+        }
+        scores[course] = value;
+        unindexStudentScores(manager, index);
+        int ok = setStudentScores(&manager->scorePool, student, scores, scoreCount);
+        indexStudentScores(manager, index);
+        if (!ok) {
+            changed = -1;
+            break;
+        }
+        changed++;
+    }
+    free(scores);
+    invalidateColumns(manager);
+    return changed;
+}
+
+// 按成绩名或从1开始的序号查找课程位置，找不到返回-1
+int findCourse(StudentManager *manager, const char *text) {
+    for (int j = 0; j < manager->scoreNameCount; j++) {
+        if (strcmp(manager->scoreNames[j], text) == 0) {
+            return j;
+        }
+    }
+    int position = atoi(text);
+    return position >= 1 ? position - 1 : -1;
+}
+
+// 在当前数据上应用一条日志记录
+void applyJournalRecord(StudentManager *manager, unsigned char type, const unsigned char *payload, unsigned int length) {
+    switch (type) {
+        case JOURNAL_ADD:
+        case JOURNAL_MODIFY: {
+            SnapshotStudent record;
+            Student student;
+            if (length < sizeof(record)) {
+                return;
+            }
+            memcpy(&record, payload, sizeof(record));
+            if (sizeof(record) + sizeof(float) * (size_t)record.scoreCount != length ||
+                !recordToStudent(manager, &record, (const float *)(payload + sizeof(record)), NULL, &student)) {
+                return;
+            }
+            int index = findStudentById(manager, student.id);
+            if (index != -1) {
+                unindexStudent(manager, index);
+                releaseStudentScores(&manager->scorePool, getStudent(manager, index));
+                *getStudent(manager, index) = student;
+                getStudent(manager, index)->deleted = 0;
+                indexStudent(manager, index);
+                invalidateColumns(manager);
+            } else if (appendStudent(manager, &student) == -1) {
+                releaseStudentScores(&manager->scorePool, &student);
+            }
+            break;
+        }
+        case JOURNAL_DELETE: {
+            if (length == 0 || payload[length - 1] != '\0') {
+                return;
+            }
+            int index = findStudentById(manager, (const char *)payload);
+            if (index != -1) {
+                markStudentDeleted(manager, index);  // 重放结束后统一压缩
+            }
+            break;
+        }
+        case JOURNAL_PRESET_ADD:
+        case JOURNAL_PRESET_CLEAR: {
+            if (length == 0 || payload[0] > PRESET_MAJOR) {
+                return;
+            }
+            char ***presetLists[3] = {&manager->scoreNames, &manager->departmentNames, &manager->majorNames};
+            int *presetCounts[3] = {&manager->scoreNameCount, &manager->departmentCount, &manager->majorCount};
+            int *presetCapacities[3] = {&manager->scoreNameCapacity, &manager->departmentCapacity, &manager->majorCapacity};
+            int list = payload[0];
+            if (type == JOURNAL_PRESET_CLEAR) {
+                for (int i = 0; i < *presetCounts[list]; i++) {
+                    free((*presetLists[list])[i]);
+                }
+                *presetCounts[list] = 0;
+            } else if (length > 1 && payload[length - 1] == '\0') {
+                const char *name = (const char *)payload + 1;
+                for (int i = 0; i < *presetCounts[list]; i++) {
+                    if (strcmp((*presetLists[list])[i], name) == 0) {
+                        return;
+                    }
+                }
+                pushPresetName(presetLists[list], presetCounts[list], presetCapacities[list], name);
+            }
+            break;
+        }
+    }
+}
+
+// 重放日志文件中代数不小于 minGeneration 的记录，遇到不完整或校验失败的记录即停止
+// 返回重放的记录数；文件不存在或属于已合并的旧代日志返回-1
+int replayJournal(StudentManager *manager, const char *path, unsigned int minGeneration) {
+    MappedFile mapped;
+    if (!mapFile(path, &mapped)) {
+        return -1;
+    }
+    
+    JournalFileHeader fileHeader;
+    if (mapped.size < sizeof(fileHeader)) {
+        unmapFile(&mapped);
+        return -1;
+    }
+    memcpy(&fileHeader, mapped.data, sizeof(fileHeader));
+    if (memcmp(fileHeader.magic, JOURNAL_MAGIC, 4) != 0 || fileHeader.generation < minGeneration) {
+        unmapFile(&mapped);
+        return -1;
+    }
+    
+    int applied = 0;
+    size_t offset = sizeof(fileHeader);
+    while (offset + sizeof(JournalRecordHeader) <= mapped.size) {
+        JournalRecordHeader header;
+        memcpy(&header, mapped.data + offset, sizeof(header));
+        const unsigned char *payload = mapped.data + offset + sizeof(header);
+        if (header.length > mapped.size - offset - sizeof(header) ||
+            snapshotChecksum(payload, header.length) != header.checksum) {
+            break;  // 崩溃时写了一半的尾部记录
+        }
+        applyJournalRecord(manager, header.type, payload, header.length);
+        applied++;
+        offset += sizeof(header) + header.length;
+    }
+    
+    unmapFile(&mapped);
+    compactOrUnlinkDeleted(manager);
+    return applied;
+}
+
+// 后台压缩线程：写出快照后删除已合并的旧日志，失败时保留旧日志并记录结果
+void *compactionWorker(void *arg) {
+    CompactionJob *job = (CompactionJob *)arg;
+    if (writeSnapshotFile(job->snapshotPath, job->data, job->size)) {
+        remove(job->oldJournalPath);
+        *job->failed = 0;
+    } else {
+        *job->failed = 1;
+    }
+    free(job->data);
+    free(job);
+    return NULL;
+}
+
+// 将当前日志合并进新快照：在主线程中序列化内存数据并切换到新一代日志，
+// 文件写入与落盘交给后台线程，不阻塞后续操作。成功启动返回1
+// 上次后台写快照失败时 .old 尚未合并，本次改为同步写出快照，成功后才轮换日志
+int compactJournal(StudentManager *manager) {
+    Journal *journal = manager->journal;
+    if (journal == NULL || journal->failed) {
+        return 0;
+    }
+    int previousWritten = journalWaitCompaction(journal);
+    
+    CompactionJob *job = (CompactionJob *)malloc(sizeof(CompactionJob));
+    if (job == NULL || !journalCommit(journal, 1)) {
+        free(job);
+        return 0;
+    }
+    job->data = serializeSnapshot(manager, journal->generation + 1, &job->size);
+    if (job->data == NULL) {
+        free(job);
+        return 0;
+    }
+    snprintf(job->snapshotPath, sizeof(job->snapshotPath), "%s", SNAPSHOT_FILE);
+    snprintf(job->oldJournalPath, sizeof(job->oldJournalPath), "%s.old", journal->path);
+    job->failed = &journal->compactFailed;
+    if (!previousWritten) {
+        // 新快照同时包含 .old 和当前日志的内容，写出之前两份日志都不能动
+        if (!writeSnapshotFile(job->snapshotPath, job->data, job->size)) {
+            free(job->data);
+            free(job);
+            return 0;
+        }
+        journal->compactFailed = 0;
+        free(job->data);
+        job->data = NULL;
+    }
+    
+    // 当前日志改名为 .old，在新快照落盘前崩溃时启动会同时重放两份日志
+    fclose(journal->file);
+    remove(job->oldJournalPath);
+    rename(journal->path, job->oldJournalPath);
+    journal->file = fopen(journal->path, "wb");
+    if (journal->file == NULL) {
+        journal->failed = 1;
+        free(job->data);
+        free(job);
+        return 0;
+    }
+    setvbuf(journal->file, NULL, _IONBF, 0);
+    journal->generation++;
+    JournalFileHeader header;
+    memcpy(header.magic, JOURNAL_MAGIC, 4);
+    header.generation = journal->generation;
+    fwrite(&header, sizeof(header), 1, journal->file);
+    syncFile(journal->file);
+    journal->bytesWritten = sizeof(header);
+    
+    if (job->data == NULL) {
+        // 快照已同步写出，轮换下来的日志无需保留
+        remove(job->oldJournalPath);
+        free(job);
+        return 1;
+    }
+    if (!startThread(&journal->compactThread, compactionWorker, job)) {
+        compactionWorker(job);
+        return !journal->compactFailed;
+    }
+    journal->compacting = 1;
+    return 1;
+}
+
+// 日志超过 JOURNAL_COMPACT_BYTES 时触发后台压缩
+void compactJournalIfNeeded(StudentManager *manager) {
+    if (manager->journal != NULL && manager->journal->bytesWritten >= JOURNAL_COMPACT_BYTES) {
+        compactJournal(manager);
+    }
+}
+
+// 启动时恢复数据：加载快照，按顺序重放尚未合并的日志，然后开启新日志
+// 返回重放的日志记录数，snapshotResult 返回 loadSnapshot 的结果
+// 调用方须持有数据文件锁（见 lockDataFiles）
+int recoverManager(StudentManager *manager, int *snapshotResult) {
+    unsigned int generation = 0;
+    *snapshotResult = loadSnapshot(manager, SNAPSHOT_FILE, &generation);
+    int replayed = replayJournals(manager, generation);
+    
+    // 重放过日志则立即合并为新快照，新日志从快照记录的下一代开始
+    // 合并失败时保留未合并的日志，不开启新日志
+    manager->snapshotGeneration = generation;
+    if (replayed > 0) {
+        foldJournals(manager, generation + 1);
+        return replayed;
+    }
+    char oldJournalPath[270];
+    snprintf(oldJournalPath, sizeof(oldJournalPath), "%s.old", JOURNAL_FILE);
+    remove(oldJournalPath);
+    manager->journal = journalOpen(JOURNAL_FILE, generation);
+    return replayed;
+}
+
+// 只读方式恢复数据：加载快照后只在内存中重放日志，不合并、不删除也不重新开启日志（manager->journal 保持NULL）
+// 供只读的批处理命令使用，不需要数据文件锁，也不会截断正在运行的交互进程的日志。返回重放的日志记录数
+int recoverManagerReadOnly(StudentManager *manager, int *snapshotResult) {
+    unsigned int generation = 0;
+    *snapshotResult = loadSnapshot(manager, SNAPSHOT_FILE, &generation);
+    manager->snapshotGeneration = generation;
+    return replayJournals(manager, generation);
+}
+
+// 按顺序重放快照之后的旧日志（.old）与当前日志，返回重放的记录总数
+int replayJournals(StudentManager *manager, unsigned int generation) {
+    char oldJournalPath[270];
+    snprintf(oldJournalPath, sizeof(oldJournalPath), "%s.old", JOURNAL_FILE);
+    int oldCount = replayJournal(manager, oldJournalPath, generation);
+    int currentCount = replayJournal(manager, JOURNAL_FILE, generation);
+    return (oldCount > 0 ? oldCount : 0) + (currentCount > 0 ? currentCount : 0);
+}
+
+// 把内存中的全部数据（含已重放的日志）写成第 generation 代快照，删除已合并的日志并开启同代的新日志
+// 快照写出失败返回0，此时日志文件保持不动
+int foldJournals(StudentManager *manager, unsigned int generation) {
+    size_t size;
+    unsigned char *data = serializeSnapshot(manager, generation, &size);
+    int folded = data != NULL && writeSnapshotFile(SNAPSHOT_FILE, data, size);
+    free(data);
+    if (!folded) {
+        return 0;
+    }
+    char oldJournalPath[270];
+    snprintf(oldJournalPath, sizeof(oldJournalPath), "%s.old", JOURNAL_FILE);
+    remove(oldJournalPath);
+    manager->snapshotGeneration = generation;
+    manager->journal = journalOpen(JOURNAL_FILE, generation);
+    return 1;
+}
+
+// 批量修改不逐条写日志，结束后同步把全部数据写成新快照，写出失败返回0（调用方须报告，修改并未保存）
+// 启动时未能合并日志（没有开启日志）的，连同未合并的日志一起写出
+int saveBulkChanges(StudentManager *manager) {
+    if (manager->journal == NULL) {
+        return foldJournals(manager, manager->snapshotGeneration + 1);
+    }
+    return compactJournal(manager) && journalWaitCompaction(manager->journal);
+}
+
+// 锁定数据文件，同一目录下同时只允许一个进程修改快照与日志（交互界面与会写数据的批处理命令）
+// 成功返回1，已被其他进程锁定返回0，无法创建锁文件返回-1。锁随进程退出释放，异常退出不会留下失效的锁
+int lockDataFiles() {
+#ifdef _WIN32
+    // 以不共享方式打开锁文件，其他进程再打开即失败
+    dataLock = CreateFileA(LOCK_FILE, GENERIC_WRITE, 0, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (dataLock == INVALID_HANDLE_VALUE) {
+        return GetLastError() == ERROR_SHARING_VIOLATION ? 0 : -1;
+    }
+    return 1;
+#else
+    dataLock = open(LOCK_FILE, O_RDWR | O_CREAT, 0644);
+    if (dataLock == -1) {
+        return -1;
+    }
+    struct flock lock;
+    memset(&lock, 0, sizeof(lock));
+    lock.l_type = F_WRLCK;
+    lock.l_whence = SEEK_SET;
+    if (fcntl(dataLock, F_SETLK, &lock) == -1) {
+        close(dataLock);
+        dataLock = -1;
+        return 0;
+    }
+    return 1;
+#endif
+}
+
+// 释放数据文件锁（锁文件本身保留）
+void unlockDataFiles() {
+#ifdef _WIN32
+    if (dataLock != INVALID_HANDLE_VALUE) {
+        CloseHandle(dataLock);
+        dataLock = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (dataLock != -1) {
+        close(dataLock);
+        dataLock = -1;
+    }
+#endif
+}
+
+// 原地切分一行字段（支持双引号包裹的字段，字段指针指向行缓冲区内部），返回字段数
+int splitFields(char *line, char delimiter, char **fields, int maxFields) {
+    int count = 0;
+    char *p = line;
+    while (count < maxFields) {
+        if (*p == '"') {
+            // 引号字段：去掉引号，"" 还原为 "
+            char *out = ++p;
+            fields[count++] = out;
+            while (*p != '\0') {
+                if (*p == '"') {
+                    if (p[1] == '"') {
+                        *out++ = '"';
+                        p += 2;
+                        continue;
+                    }
+                    p++;
+                    break;
+                }
+                *out++ = *p++;
+            }
+            while (*p != '\0' && *p != delimiter) {
+                p++;
+            }
+            char next = *p;
+            *out = '\0';
+            if (next == '\0') {
+                break;
+            }
+            p++;
+        } else {
+            fields[count++] = p;
+            while (*p != '\0' && *p != delimiter) {
+                p++;
+            }
+            if (*p == '\0') {
+                break;
+            }
+            *p++ = '\0';
+        }
+    }
+    return count;
+}
+
+// 解析成绩文本，常见的"整数[.小数]"格式直接计算，其余格式交给 strtof，成功返回1
+int parseScoreText(const char *text, float *score) {
+    const char *p = text;
+    int integer = 0;
+    int digits = 0;
+    while (*p >= '0' && *p <= '9' && digits < 6) {
+        integer = integer * 10 + (*p++ - '0');
+        digits++;
+    }
+    if (digits > 0 && (*p == '\0' || *p == '.')) {
+        int fraction = 0;
+        int scale = 1;
+        if (*p == '.') {
+            p++;
+            while (*p >= '0' && *p <= '9' && scale < 100000) {
+                fraction = fraction * 10 + (*p++ - '0');
+                scale *= 10;
+            }
+        }
+        if (*p == '\0') {
+            *score = (float)integer + (float)fraction / (float)scale;
+            return 1;
+        }
+    }
+    
+    char *endptr;
+    *score = strtof(text, &endptr);
+    return endptr != text && *endptr == '\0';
+}
+
+// 校验一行导入数据并转换为学生（成绩数组从 pool 分配），成功返回NULL，失败返回拒绝原因
+const char *parseImportRow(StudentManager *manager, ScorePool *pool, char **fields, int fieldCount, Student *student) {
+    if (fieldCount < IMPORT_FIXED_FIELDS) {
+        return "字段数量不足";
+    }
+    if (!isValidName(fields[0]) || strlen(fields[0]) >= sizeof(student->name)) {
+        return "姓名无效";
+    }
+    if (!isValidGender(fields[1])) {
+        return "性别无效";
+    }
+    if (!isValidId(fields[2]) || strlen(fields[2]) >= sizeof(student->id)) {
+        return "学号无效";
+    }
+    if (findStudentById(manager, fields[2]) != -1) {
+        return "学号已存在";
+    }
+    if (isEmptyString(fields[3]) || strlen(fields[3]) >= CLASS_NAME_SIZE) {
+        return "班级无效";
+    }
+    if (!isValidDepartment(manager, fields[4])) {
+        return "院系不在预设中";
+    }
+    if (!isValidMajor(manager, fields[5])) {
+        return "专业不在预设中";
+    }
+    
+    float scores[IMPORT_MAX_FIELDS];
+    int scoreCount = 0;
+    for (int i = IMPORT_FIXED_FIELDS; i < fieldCount; i++) {
+        if (isEmptyString(fields[i])) {
+            continue;
+        }
+        float score;
+        if (!parseScoreText(fields[i], &score) || !isValidScore(score)) {
+            return "成绩无效";
+        }
+        scores[scoreCount++] = score;
+    }
+    
+    strcpy(student->name, fields[0]);
+    strcpy(student->gender, fields[1]);
+    strcpy(student->id, fields[2]);
+    // 多线程解析时字典只读：字典中还没有的名称编号记为-1，由调用者登记
+    student->classId = dictLookup(&manager->strings, fields[3]);
+    student->departmentId = dictLookup(&manager->strings, fields[4]);
+    student->majorId = dictLookup(&manager->strings, fields[5]);
+    // 与手动录入一致：没有成绩时记一个默认0分
+    if (scoreCount == 0) {
+        scores[scoreCount++] = 0;
+    }
+    student->scoreCount = 0;
+    if (!setStudentScores(pool, student, scores, scoreCount)) {
+        return "内存不足";
+    }
+    return NULL;
+}
+
+// 登记导入行中字典里还没有的班级、院系、专业名称，成功返回1
+int internImportFields(StudentManager *manager, Student *student, char **fields) {
+    if (student->classId == -1) {
+        student->classId = dictIntern(&manager->strings, fields[3]);
+    }
+    if (student->departmentId == -1) {
+        student->departmentId = dictIntern(&manager->strings, fields[4]);
+    }
+    if (student->majorId == -1) {
+        student->majorId = dictIntern(&manager->strings, fields[5]);
+    }
+    return student->classId != -1 && student->departmentId != -1 && student->majorId != -1;
+}
+
+// 写一条拒绝记录
+void reportRejectedRow(FILE *report, long long line, const char *reason, const char *id) {
+    if (report != NULL) {
+        fprintf(report, "%lld,%s,%s\n", line, reason, id != NULL ? id : "");
+    }
+}
+
+// 按块流式读取文件，逐行去掉换行符和回车后交给 reader 处理（空行跳过，数据行计入 stats->rows）
+// 单行超过缓冲区大小时计为拒绝（"行过长"）写入 report（可为NULL）并丢弃到下一个换行。内存不足返回0
+int readFileLines(FILE *file, const LineReader *reader, FILE *report, ImportStats *stats) {
+    char *buffer = (char *)malloc(IMPORT_BUFFER_SIZE + 1);
+    if (buffer == NULL) {
+        return 0;
+    }
+    
+    int firstLine = 1;
+    int skipping = 0;   // 正在丢弃超长行的剩余部分
+    long long lineNumber = 0;
+    size_t carry = 0;
+    
+    while (1) {
+        size_t readBytes = fread(buffer + carry, 1, IMPORT_BUFFER_SIZE - carry, file);
+        size_t length = carry + readBytes;
+        int eof = readBytes == 0;
+        if (length == 0) {
+            break;
+        }
+        
+        char *p = buffer;
+        char *end = buffer + length;
+        while (p < end) {
+            char *newline = (char *)memchr(p, '\n', (size_t)(end - p));
+            if (newline == NULL) {
+                if (!eof) {
+                    break;
+                }
+                newline = end;
+            }
+            *newline = '\0';
+            char *line = p;
+            p = newline + 1;
+            if (skipping) {
+                skipping = 0;
+                continue;
+            }
+            
+            lineNumber++;
+            if (newline > line && newline[-1] == '\r') {
+                newline[-1] = '\0';
+            }
+            if (firstLine) {
+                firstLine = 0;
+                if ((unsigned char)line[0] == 0xEF && (unsigned char)line[1] == 0xBB && (unsigned char)line[2] == 0xBF) {
+                    line += 3;
+                }
+                if (reader->firstLine != NULL) {
+                    reader->firstLine(reader->context, line);
+                }
+                // 跳过表头
+                int header = 0;
+                for (int i = 0; reader->headers[i] != NULL && !header; i++) {
+                    header = strncmp(line, reader->headers[i], strlen(reader->headers[i])) == 0;
+                }
+                if (header) {
+                    continue;
+                }
+            }
+            if (isEmptyString(line)) {
+                continue;
+            }
+            
+            stats->rows++;
+            reader->handleRow(reader->context, line, lineNumber);
+        }
+        
+        carry = (size_t)(end - p);
+        if (eof) {
+            break;
+        }
+        if (carry == IMPORT_BUFFER_SIZE) {
+            // 单行超过缓冲区大小：拒绝并丢弃到下一个换行
+            lineNumber++;
+            stats->rows++;
+            stats->rejected++;
+            reportRejectedRow(report, lineNumber, "行过长", NULL);
+            skipping = 1;
+            carry = 0;
+        } else if (carry > 0) {
+            memmove(buffer, p, carry);
+        }
+    }
+    free(buffer);
+    return 1;
+}
+
+// 批量导入的首行：扩展名不是 .csv 且首行含制表符时按 TSV 解析
+void importFirstLine(void *context, const char *line) {
+    ImportContext *import = (ImportContext *)context;
+    if ((import->ext == NULL || strcmp(import->ext, ".csv") != 0) && strchr(line, '\t') != NULL) {
+        import->delimiter = '\t';
+    }
+}
+
+// 批量导入的一行：原地切分校验后直接写入学生存储，被拒绝的写入拒绝报告
+void importRow(void *context, char *line, long long lineNumber) {
+    ImportContext *import = (ImportContext *)context;
+    StudentManager *manager = import->manager;
+    char *fields[IMPORT_MAX_FIELDS];
+    Student student;
+    int fieldCount = splitFields(line, import->delimiter, fields, IMPORT_MAX_FIELDS);
+    const char *reason = parseImportRow(manager, &manager->scorePool, fields, fieldCount, &student);
+    if (reason == NULL && (!internImportFields(manager, &student, fields) || appendStudent(manager, &student) == -1)) {
+        releaseStudentScores(&manager->scorePool, &student);
+        reason = "内存不足";
+    }
+    if (reason != NULL) {
+        import->stats->rejected++;
+        reportRejectedRow(import->report, lineNumber, reason, fieldCount > 2 ? fields[2] : NULL);
+    } else {
+        import->stats->imported++;
+    }
+}
+
+// 流式批量导入 CSV/TSV 文件（列：姓名,性别,学号,班级,院系,专业,成绩1,成绩2,...）
+// 文件按块读入（readFileLines），逐行原地切分校验后直接写入学生存储；被拒绝的行写入 reportPath（可为NULL）
+// 导入的学生不写日志，由调用方用 saveBulkChanges 保存。返回0表示文件无法打开
+int importStudents(StudentManager *manager, const char *path, const char *reportPath, ImportStats *stats) {
+    static const char *const headers[] = {"姓名", "name", NULL};
+    memset(stats, 0, sizeof(ImportStats));
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return 0;
+    }
+    FILE *report = reportPath != NULL ? fopen(reportPath, "w") : NULL;
+    if (report != NULL) {
+        fprintf(report, "行号,原因,学号\n");
+    }
+    
+    // 扩展名为 .tsv 或首行含制表符时按 TSV 解析
+    ImportContext import;
+    import.manager = manager;
+    import.report = report;
+    import.stats = stats;
+    import.ext = strrchr(path, '.');
+    import.delimiter = import.ext != NULL && strcmp(import.ext, ".tsv") == 0 ? '\t' : ',';
+    LineReader reader = {headers, importFirstLine, importRow, &import};
+    long long start = currentTimeMs();
+    int ok = readFileLines(file, &reader, report, stats);
+    stats->seconds = (double)(currentTimeMs() - start) / 1000;
+    
+    fclose(file);
+    if (report != NULL) {
+        fclose(report);
+    }
+    return ok;
+}
+
+// 获取可用的CPU核心数
+int getCpuCount() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+// 记录分片内的一条拒绝
+void addShardRejection(ImportShard *shard, long long line, const char *reason, const char *id) {
+    if (shard->rejectionCount >= shard->rejectionCapacity) {
+        int newCapacity = shard->rejectionCapacity == 0 ? 64 : shard->rejectionCapacity * 2;
+        ImportRejection *newRejections = (ImportRejection *)realloc(shard->rejections, sizeof(ImportRejection) * newCapacity);
+        if (newRejections == NULL) {
+            return;
+        }
+        shard->rejections = newRejections;
+        shard->rejectionCapacity = newCapacity;
+    }
+    ImportRejection *rejection = &shard->rejections[shard->rejectionCount++];
+    rejection->line = line;
+    rejection->reason = reason;
+    rejection->id[0] = '\0';
+    if (id != NULL) {
+        strncpy(rejection->id, id, sizeof(rejection->id) - 1);
+        rejection->id[sizeof(rejection->id) - 1] = '\0';
+    }
+}
+
+// 导入工作线程：解析并校验分片内的所有行，结果保存在分片自己的缓冲区中
+void *importShardWorker(void *arg) {
+    ImportShard *shard = (ImportShard *)arg;
+    char line[IMPORT_LINE_MAX];
+    char *fields[IMPORT_MAX_FIELDS];
+    Student student;
+    const char *p = shard->begin;
+    
+    while (p < shard->end) {
+        const char *newline = (const char *)memchr(p, '\n', (size_t)(shard->end - p));
+        const char *lineEnd = newline != NULL ? newline : shard->end;
+        size_t length = (size_t)(lineEnd - p);
+        const char *lineStart = p;
+        p = newline != NULL ? newline + 1 : shard->end;
+        shard->lines++;
+        
+        if (length > 0 && lineStart[length - 1] == '\r') {
+            length--;
+        }
+        if (length >= IMPORT_LINE_MAX) {
+            shard->rows++;
+            addShardRejection(shard, shard->lines, "行过长", NULL);
+            continue;
+        }
+        // 映射的文件只读，把行拷进线程本地缓冲区后再原地切分
+        memcpy(line, lineStart, length);
+        line[length] = '\0';
+        if (isEmptyString(line)) {
+            continue;
+        }
+        
+        shard->rows++;
+        int fieldCount = splitFields(line, shard->delimiter, fields, IMPORT_MAX_FIELDS);
+        const char *reason = parseImportRow(shard->manager, &shard->scorePool, fields, fieldCount, &student);
+        if (reason == NULL && shard->count >= shard->capacity) {
+            int newCapacity = shard->capacity == 0 ? 4096 : shard->capacity * 2;
+            ImportedStudent *newStudents = (ImportedStudent *)realloc(shard->students, sizeof(ImportedStudent) * newCapacity);
+            if (newStudents == NULL) {
+                releaseStudentScores(&shard->scorePool, &student);
+                reason = "内存不足";
+            } else {
+                shard->students = newStudents;
+                shard->capacity = newCapacity;
+            }
+        }
+        if (reason != NULL) {
+            addShardRejection(shard, shard->lines, reason, fieldCount > 2 ? fields[2] : NULL);
+        } else {
+            shard->students[shard->count].student = student;
+            shard->students[shard->count].line = shard->lines;
+            if (student.classId == -1) {
+                strcpy(shard->students[shard->count].className, fields[3]);
+            }
+            shard->count++;
+        }
+    }
+    return NULL;
+}
+
+// 按行号排序拒绝记录
+int compareRejections(const void *a, const void *b) {
+    long long la = ((const ImportRejection *)a)->line;
+    long long lb = ((const ImportRejection *)b)->line;
+    return la < lb ? -1 : (la > lb ? 1 : 0);
+}
+
+// 多线程批量导入：文件映射后按行边界切成 threadCount 个分片，各线程并行解析校验，
+// 最后按分片顺序合并进学生存储，合并时检测跨分片的重复学号（与 importStudents 一样由调用方保存）
+// 返回0表示文件无法打开
+int importStudentsParallel(StudentManager *manager, const char *path, const char *reportPath,
+                           int threadCount, ImportStats *stats) {
+    memset(stats, 0, sizeof(ImportStats));
+    MappedFile mapped;
+    if (!mapFile(path, &mapped)) {
+        return 0;
+    }
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+    if (threadCount > IMPORT_MAX_THREADS) {
+        threadCount = IMPORT_MAX_THREADS;
+    }
+    long long start = currentTimeMs();
+    
+    // 处理 BOM、表头和分隔符
+    const char *data = (const char *)mapped.data;
+    const char *end = data + mapped.size;
+    const char *p = data;
+    long long headerLines = 0;
+    if (mapped.size >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0) {
+        p += 3;
+    }
+    const char *firstEnd = (const char *)memchr(p, '\n', (size_t)(end - p));
+    if (firstEnd == NULL) {
+        firstEnd = end;
+    }
+    const char *ext = strrchr(path, '.');
+    char delimiter = ',';
+    if ((ext != NULL && strcmp(ext, ".tsv") == 0) ||
+        ((ext == NULL || strcmp(ext, ".csv") != 0) && memchr(p, '\t', (size_t)(firstEnd - p)) != NULL)) {
+        delimiter = '\t';
+    }
+    if (strncmp(p, "姓名", strlen("姓名")) == 0 || strncmp(p, "name", 4) == 0) {
+        p = firstEnd < end ? firstEnd + 1 : end;
+        headerLines = 1;
+    }
+    
+    // 按行边界切分
+    ImportShard shards[IMPORT_MAX_THREADS];
+    SimsThread threads[IMPORT_MAX_THREADS];
+    int started[IMPORT_MAX_THREADS];
+    size_t shardSize = (size_t)(end - p) / threadCount + 1;
+    for (int i = 0; i < threadCount; i++) {
+        memset(&shards[i], 0, sizeof(ImportShard));
+        shards[i].manager = manager;
+        shards[i].delimiter = delimiter;
+        shards[i].begin = i == 0 ? p : shards[i - 1].end;
+        const char *shardEnd = shards[i].begin + shardSize;
+        if (i == threadCount - 1 || shardEnd >= end) {
+            shardEnd = end;
+        } else {
+            const char *newline = (const char *)memchr(shardEnd, '\n', (size_t)(end - shardEnd));
+            shardEnd = newline != NULL ? newline + 1 : end;
+        }
+        if (shardEnd < shards[i].begin) {
+            shardEnd = shards[i].begin;
+        }
+        shards[i].end = shardEnd;
+    }
+    
+    // 工作线程只读字典：先把院系、专业预设登记进去，解析时只剩新班级需要合并阶段登记
+    for (int i = 0; i < manager->departmentCount; i++) {
+        dictIntern(&manager->strings, manager->departmentNames[i]);
+    }
+    for (int i = 0; i < manager->majorCount; i++) {
+        dictIntern(&manager->strings, manager->majorNames[i]);
+    }
+    for (int i = 0; i < threadCount; i++) {
+        started[i] = i > 0 && startThread(&threads[i], importShardWorker, &shards[i]);
+    }
+    importShardWorker(&shards[0]);
+    for (int i = 1; i < threadCount; i++) {
+        if (started[i]) {
+            joinThread(threads[i]);
+        } else {
+            importShardWorker(&shards[i]);
+        }
+    }
+    
+    // 合并：预留存储和索引空间后按分片顺序追加
+    long long parsed = 0;
+    for (int i = 0; i < threadCount; i++) {
+        parsed += shards[i].count;
+    }
+    while ((long long)manager->capacity < manager->count + parsed && growStudentStore(manager)) {
+    }
+    long long needSlots = (manager->count + parsed) * 2;
+    if (needSlots > manager->idIndexCapacity && needSlots < INT_MAX / 2) {
+        int slotCapacity = manager->idIndexCapacity;
+        while (slotCapacity < needSlots) {
+            slotCapacity *= 2;
+        }
+        idIndexRebuild(manager, slotCapacity);
+    }
+    
+    long long lineBase = headerLines;
+    for (int i = 0; i < threadCount; i++) {
+        ImportShard *shard = &shards[i];
+        for (int j = 0; j < shard->count; j++) {
+            Student *student = &shard->students[j].student;
+            if (student->classId == -1) {
+                student->classId = dictIntern(&manager->strings, shard->students[j].className);
+            }
+            if (findStudentById(manager, student->id) != -1) {
+                addShardRejection(shard, shard->students[j].line, "学号重复", student->id);
+                continue;
+            }
+            // 超出记录内容量的成绩从线程本地的成绩池复制到管理器的成绩池
+            if (student->scoreCount > inlineScoreCapacity()) {
+                float *scores = scorePoolAlloc(&manager->scorePool, scorePoolSlots(student->scoreCount));
+                if (scores == NULL) {
+                    addShardRejection(shard, shard->students[j].line, "内存不足", student->id);
+                    continue;
+                }
+                memcpy(scores, student->scoreData.heapScores, sizeof(float) * scorePoolSlots(student->scoreCount));
+                student->scoreData.heapScores = scores;
+            }
+            if (student->classId == -1 || appendStudent(manager, student) == -1) {
+                addShardRejection(shard, shard->students[j].line, "内存不足", student->id);
+                releaseStudentScores(&manager->scorePool, student);
+            } else {
+                stats->imported++;
+            }
+        }
+        for (int j = 0; j < shard->rejectionCount; j++) {
+            shard->rejections[j].line += lineBase;
+        }
+        lineBase += shard->lines;
+        stats->rows += shard->rows;
+        stats->rejected += shard->rejectionCount;
+        free(shard->students);
+        scorePoolRelease(&shard->scorePool);
+    }
+    stats->seconds = (double)(currentTimeMs() - start) / 1000;
+    unmapFile(&mapped);
+    
+    // 按行号顺序输出拒绝报告
+    FILE *report = reportPath != NULL ? fopen(reportPath, "w") : NULL;
+    if (report != NULL) {
+        fprintf(report, "行号,原因,学号\n");
+    }
+    for (int i = 0; i < threadCount; i++) {
+        ImportShard *shard = &shards[i];
+        qsort(shard->rejections, (size_t)shard->rejectionCount, sizeof(ImportRejection), compareRejections);
+        for (int j = 0; j < shard->rejectionCount; j++) {
+            reportRejectedRow(report, shard->rejections[j].line, shard->rejections[j].reason, shard->rejections[j].id);
+        }
+        free(shard->rejections);
+    }
+    if (report != NULL) {
+        fclose(report);
+    }
+    return 1;
+}
+
+// 成绩表合并的一行（学号,成绩）：经学号哈希索引找到学生写入成绩，被拒绝的写入拒绝报告
+void mergeCourseRow(void *context, char *line, long long lineNumber) {
+    MergeContext *merge = (MergeContext *)context;
+    StudentManager *manager = merge->manager;
+    char *scoreText = line;
+    while (*scoreText != '\0' && *scoreText != ',' && *scoreText != '\t') {
+        scoreText++;
+    }
+    if (*scoreText != '\0') {
+        *scoreText++ = '\0';
+    }
+    const char *reason = NULL;
+    float score;
+    int index = idIndexFind(manager, line);
+    if (index == -1) {
+        reason = "学号不存在";
+    } else if (!parseScoreText(scoreText, &score) || !isValidScore(score)) {
+        reason = "成绩无效";
+    } else {
+        Student *student = getStudent(manager, index);
+        unindexStudentScores(manager, index);
+        int result = setStudentScoreAt(&manager->scorePool, student, merge->course, score);
+        indexStudentScores(manager, index);
+        if (result == 0) {
+            reason = "前面的成绩缺失";
+        } else if (result == -1) {
+            reason = "内存不足";
+        }
+    }
+    if (reason != NULL) {
+        merge->stats->rejected++;
+        reportRejectedRow(merge->report, lineNumber, reason, line);
+    } else {
+        merge->stats->imported++;
+    }
+}
+
+// 流式合并一门课程的成绩表（每行：学号,成绩，逗号或制表符分隔，可带表头）
+// 文件按块读入（readFileLines），逐行经学号哈希索引找到学生，把成绩写到第 course 门（course 等于学生现有成绩数时追加一门），
+// 总分按差值增量更新，排行与成绩分布随之调整；同一学号出现多次时以最后一行为准。
+// 找不到学号、成绩无效、前面的成绩缺失的行写入 report（可为NULL）。stats->imported 为写入的成绩数，内存不足返回0
+int mergeCourseFile(StudentManager *manager, FILE *file, int course, FILE *report, ImportStats *stats) {
+    static const char *const headers[] = {"学号", "id", "ID", NULL};
+    memset(stats, 0, sizeof(ImportStats));
+    MergeContext merge = {manager, course, report, stats};
+    LineReader reader = {headers, NULL, mergeCourseRow, &merge};
+    long long start = currentTimeMs();
+    int ok = readFileLines(file, &reader, report, stats);
+    stats->seconds = (double)(currentTimeMs() - start) / 1000;
+    if (stats->imported > 0) {
+        invalidateColumns(manager);
+    }
+    return ok;
+}
+
+// 合并成绩表文件（见 mergeCourseFile），被拒绝的行写入 reportPath（可为NULL），成绩不写日志，由调用方用 saveBulkChanges 保存
+// 返回0表示文件无法打开
+int mergeCourseScores(StudentManager *manager, const char *path, int course, const char *reportPath, ImportStats *stats) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return 0;
+    }
+    FILE *report = reportPath != NULL ? fopen(reportPath, "w") : NULL;
+    if (report != NULL) {
+        fprintf(report, "行号,原因,学号\n");
+    }
+    int ok = mergeCourseFile(manager, file, course, report, stats);
+    fclose(file);
+    if (report != NULL) {
+        fclose(report);
+    }
+    return ok;
+}
+
+// 确保输出缓冲区还能容纳 extra 字节：容量未到上限时扩容，否则先写出已有内容
+void outputReserve(OutputBuffer *out, size_t extra) {
+    if (out->used + extra <= out->capacity) {
+        return;
+    }
+    size_t newCapacity = out->capacity == 0 ? OUTPUT_BUFFER_INITIAL : out->capacity;
+    while (newCapacity < out->used + extra && newCapacity < OUTPUT_BUFFER_MAX) {
+        newCapacity *= 2;
+    }
+    if (newCapacity > out->capacity) {
+        char *newData = (char *)realloc(out->data, newCapacity);
+        if (newData != NULL) {
+            out->data = newData;
+            out->capacity = newCapacity;
+        }
+    }
+    if (out->used + extra > out->capacity) {
+        outputFlush(out);
+    }
+}
+
+// 追加一段文本（超过缓冲区容量的文本直接写出）
+void outputAppend(OutputBuffer *out, const char *text, size_t length) {
+    outputReserve(out, length);
+    if (out->used + length > out->capacity) {
+        // 缓冲区无法再扩大时直接写出
+        OutputBuffer direct = {(char *)text, length, length, out->fd, 0};
+        outputFlush(&direct);
+        out->failed |= direct.failed;
+        return;
+    }
+    memcpy(out->data + out->used, text, length);
+    out->used += length;
+}
+
+// 追加字符串
+void outputString(OutputBuffer *out, const char *text) {
+    outputAppend(out, text, strlen(text));
+}
+
+// 追加颜色控制码（仅在输出到终端时）
+void outputColor(OutputBuffer *out, const char *color) {
+    if (useColor) {
+        outputString(out, color);
+    }
+}
+
+// 追加整数
+void outputInt(OutputBuffer *out, long long value) {
+    char digits[24];
+    int length = 0;
+    unsigned long long magnitude = value < 0 ? (unsigned long long)(-(value + 1)) + 1 : (unsigned long long)value;
+    do {
+        digits[sizeof(digits) - 1 - length++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) {
+        digits[sizeof(digits) - 1 - length++] = '-';
+    }
+    outputAppend(out, digits + sizeof(digits) - length, (size_t)length);
+}
+
+// 把数值格式化为保留两位小数的文本（与 printf("%.2f") 相同的四舍五入结果），返回长度
+int formatFixed2(char *text, size_t size, double value) {
+    if (value > 1e15 || value < -1e15) {
+        int length = snprintf(text, size, "%.2f", value);
+        return length < (int)size ? length : (int)size - 1;
+    }
+    // float 乘以100在 double 中是精确的，按"四舍六入五成双"取整即与 printf 一致
+    int negative = value < 0;
+    if (negative) {
+        value = -value;
+    }
+    double scaled = value * 100;
+    long long hundredths = (long long)scaled;
+    double fraction = scaled - (double)hundredths;
+    if (fraction > 0.5 || (fraction == 0.5 && (hundredths & 1))) {
+        hundredths++;
+    }
+    // 从后往前填写：两位小数、小数点、整数部分、符号
+    char digits[24];
+    int length = 0;
+    digits[sizeof(digits) - 1 - length++] = (char)('0' + hundredths % 10);
+    digits[sizeof(digits) - 1 - length++] = (char)('0' + hundredths % 100 / 10);
+    digits[sizeof(digits) - 1 - length++] = '.';
+    long long whole = hundredths / 100;
+    do {
+        digits[sizeof(digits) - 1 - length++] = (char)('0' + whole % 10);
+        whole /= 10;
+    } while (whole > 0);
+    if (negative) {
+        digits[sizeof(digits) - 1 - length++] = '-';
+    }
+    if ((size_t)length >= size) {
+        length = (int)size - 1;
+    }
+    memcpy(text, digits + sizeof(digits) - length, (size_t)length);
+    text[length] = '\0';
+    return length;
+}
+
+// 追加保留两位小数的数值
+void outputFixed2(OutputBuffer *out, double value) {
+    char text[48];
+    outputAppend(out, text, (size_t)formatFixed2(text, sizeof(text), value));
+}
+
+// 计算 UTF-8 字符串的显示宽度（中日韩字符按2列计算）
+int utf8DisplayWidth(const char *text) {
+    int width = 0;
+    const unsigned char *p = (const unsigned char *)text;
+    while (*p != '\0') {
+        if (*p < 0x80) {
+            p++;
+            width++;
+        } else if ((*p & 0xE0) == 0xC0) {
+            p += p[1] != '\0' ? 2 : 1;
+            width++;
+        } else if ((*p & 0xF0) == 0xE0) {
+            p += (p[1] != '\0' && p[2] != '\0') ? 3 : 1;
+            width += 2;
+        } else {
+            p += (p[1] != '\0' && p[2] != '\0' && p[3] != '\0') ? 4 : 1;
+            width += 2;
+        }
+    }
+    return width;
+}
+
+// 追加文本并用空格补足到指定显示宽度
+void outputPadded(OutputBuffer *out, const char *text, int width) {
+    static const char spaces[] = "                                        ";
+    outputString(out, text);
+    int padding = width - utf8DisplayWidth(text);
+    while (padding > 0) {
+        int chunk = padding < (int)sizeof(spaces) - 1 ? padding : (int)sizeof(spaces) - 1;
+        outputAppend(out, spaces, (size_t)chunk);
+        padding -= chunk;
+    }
+}
+
+// 用一次 write 写出缓冲区内容
+void outputFlush(OutputBuffer *out) {
+    fflush(stdout);
+    const char *p = out->data;
+    size_t remaining = out->used;
+    while (remaining > 0) {
+#ifdef _WIN32
+        int written = _write(out->fd, p, remaining > 0x40000000 ? 0x40000000 : (unsigned int)remaining);
+#else
+        ssize_t written = write(out->fd, p, remaining);
+#endif
+        if (written <= 0) {
+            out->failed = 1;
+            break;
+        }
+        p += written;
+        remaining -= (size_t)written;
+    }
+    out->used = 0;
+}
+
+// 以详情格式渲染一名学生（与 displayStudent 输出相同）
+void renderStudentDetail(OutputBuffer *out, StudentManager *manager, const Student *student, int seq) {
+    outputString(out, "\t\t学生 ");
+    outputInt(out, seq);
+    outputString(out, ":\n");
+    outputColor(out, COLOR_CYAN);
+    outputString(out, "\n============================================================\n"
+                      "\t             学生信息详情\n"
+                      "============================================================\n");
+    outputColor(out, COLOR_RESET);
+    outputColor(out, COLOR_YELLOW);
+    outputString(out, "\t姓名: ");
+    outputString(out, student->name);
+    outputString(out, "\n\t学号: ");
+    outputString(out, student->id);
+    outputString(out, "\n\t性别: ");
+    outputString(out, student->gender);
+    outputString(out, "\n\t班级: ");
+    outputString(out, dictString(&manager->strings, student->classId));
+    outputString(out, "\n\t院系: ");
+    outputString(out, dictString(&manager->strings, student->departmentId));
+    outputString(out, "\n\t专业: ");
+    outputString(out, dictString(&manager->strings, student->majorId));
+    outputString(out, "\n\t成绩列表: ");
+    for (int i = 0; i < student->scoreCount; i++) {
+        if (i > 0) {
+            outputAppend(out, ", ", 2);
+        }
+        outputFixed2(out, studentScore(student, i));
+    }
+    outputString(out, "\n\t成绩总和: ");
+    outputFixed2(out, studentTotal(student));
+    outputString(out, "\n");
+    outputColor(out, COLOR_RESET);
+    outputColor(out, COLOR_CYAN);
+    outputString(out, "============================================================\n");
+    outputColor(out, COLOR_RESET);
+    outputString(out, "\t\t-----------------------------\n");
+}
+
+// 渲染紧凑表格的表头
+void renderTableHeader(OutputBuffer *out) {
+    outputColor(out, COLOR_CYAN);
+    outputPadded(out, "序号", 8);
+    outputPadded(out, "学号", 22);
+    outputPadded(out, "姓名", 14);
+    outputPadded(out, "性别", 8);
+    outputPadded(out, "班级", 12);
+    outputPadded(out, "院系", 18);
+    outputPadded(out, "专业", 18);
+    outputPadded(out, "总分", 10);
+    outputString(out, "成绩\n");
+    outputColor(out, COLOR_RESET);
+}
+
+// 以紧凑表格格式渲染一名学生（每人一行）
+void renderStudentRow(OutputBuffer *out, StudentManager *manager, const Student *student, int seq) {
+    char number[24];
+    snprintf(number, sizeof(number), "%d", seq);
+    outputPadded(out, number, 8);
+    outputPadded(out, student->id, 22);
+    outputPadded(out, student->name, 14);
+    outputPadded(out, student->gender, 8);
+    outputPadded(out, dictString(&manager->strings, student->classId), 12);
+    outputPadded(out, dictString(&manager->strings, student->departmentId), 18);
+    outputPadded(out, dictString(&manager->strings, student->majorId), 18);
+    // 总分先格式化到局部缓冲区再补齐；outputFixed2 中途可能刷新缓冲区，不能靠 used 的差值计算宽度
+    char total[48];
+    formatFixed2(total, sizeof(total), studentTotal(student));
+    outputPadded(out, total, 10);
+    for (int i = 0; i < student->scoreCount; i++) {
+        if (i > 0) {
+            outputAppend(out, " ", 1);
+        }
+        outputFixed2(out, studentScore(student, i));
+    }
+    outputAppend(out, "\n", 1);
+}
+
+// 渲染性能测试：把 count 名学生分别按逐条 printf、缓冲详情、缓冲表格三种方式输出到空设备
+void benchmarkRender(int count) {
+#ifdef _WIN32
+    const char *nullDevice = "NUL";
+#else
+    const char *nullDevice = "/dev/null";
+#endif
+    StudentManager *manager = initManager(count);
+    if (manager == NULL) {
+        return;
+    }
+    addSyntheticStudents(manager, 0, count, NULL, 0, 0, NULL);
+    
+    int savedColor = useColor;
+    useColor = 1;
+    fflush(stdout);
+    int savedStdout = dup(1);
+    int nullFd = open(nullDevice, O_WRONLY);
+    if (savedStdout < 0 || nullFd < 0) {
+        freeManager(manager);
+        return;
+    }
+    dup2(nullFd, 1);
+    
+    // 原有方式：逐条调用 displayStudent
+    long long start = currentTimeMs();
+    for (int i = 0; i < manager->count; i++) {
+        printf("\t\t学生 %d:\n", i + 1);
+        displayStudent(manager, getStudent(manager, i));
+        printf("\t\t-----------------------------\n");
+    }
+    fflush(stdout);
+    long long printfMs = currentTimeMs() - start;
+    
+    OutputBuffer out = {NULL, 0, 0, 1, 0};
+    start = currentTimeMs();
+    for (int i = 0; i < manager->count; i++) {
+        renderStudentDetail(&out, manager, getStudent(manager, i), i + 1);
+    }
+    outputFlush(&out);
+    long long detailMs = currentTimeMs() - start;
+    
+    start = currentTimeMs();
+    renderTableHeader(&out);
+    for (int i = 0; i < manager->count; i++) {
+        renderStudentRow(&out, manager, getStudent(manager, i), i + 1);
+    }
+    outputFlush(&out);
+    long long tableMs = currentTimeMs() - start;
+    free(out.data);
+    
+    dup2(savedStdout, 1);
+    close(savedStdout);
+    close(nullFd);
+    useColor = savedColor;
+    
+    printf("渲染性能测试：%d 名学生输出到 %s\n", manager->count, nullDevice);
+    printf("%-16s %10s %14s\n", "方式", "耗时(ms)", "行/秒");
+    printf("%-16s %10lld %14.0f\n", "逐条printf", printfMs, printfMs > 0 ? manager->count * 1000.0 / printfMs : 0.0);
+    printf("%-16s %10lld %14.0f\n", "缓冲详情", detailMs, detailMs > 0 ? manager->count * 1000.0 / detailMs : 0.0);
+    printf("%-16s %10lld %14.0f\n", "缓冲表格", tableMs, tableMs > 0 ? manager->count * 1000.0 / tableMs : 0.0);
+    freeManager(manager);
+}
+
+// 列式布局性能测试：生成 count 名测试学生，对比行式（逐个 Student）与列式镜像的聚合、筛选扫描速度
+void benchmarkColumns(int count) {
+    StudentManager *manager = initManager(count);
+    if (manager == NULL) {
+        return;
+    }
+    addSyntheticStudents(manager, 0, count, NULL, 0, 0, NULL);
+    int n = manager->count;
+    
+    long long start = currentTimeMs();
+    StudentColumns *columns = getColumns(manager);
+    long long buildMs = currentTimeMs() - start;
+    if (columns == NULL) {
+        printf("内存不足，无法建立列式镜像\n");
+        freeManager(manager);
+        return;
+    }
+    
+    int classId = dictLookup(&manager->strings, "7班");
+    int rounds = 10;
+    double rowSum = 0, columnSum = 0, rowCourse = 0, columnCourse = 0;
+    int rowMatches = 0, columnMatches = 0;
+    long long rowTotalMs, columnTotalMs, rowFilterMs, columnFilterMs, rowCourseMs, columnCourseMs;
+    
+    // 聚合：全部学生的成绩总和
+    start = currentTimeMs();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < n; i++) {
+            rowSum += studentTotal(getStudent(manager, i));
+        }
+    }
+    rowTotalMs = currentTimeMs() - start;
+    start = currentTimeMs();
+    for (int r = 0; r < rounds; r++) {
+        const float *totals = columns->totals;
+        for (int i = 0; i < n; i++) {
+            columnSum += totals[i];
+        }
+    }
+    columnTotalMs = currentTimeMs() - start;
+    
+    // 筛选：某班级总分不低于150的人数
+    start = currentTimeMs();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < n; i++) {
+            const Student *s = getStudent(manager, i);
+            rowMatches += s->classId == classId && studentTotal(s) >= 150;
+        }
+    }
+    rowFilterMs = currentTimeMs() - start;
+    start = currentTimeMs();
+    for (int r = 0; r < rounds; r++) {
+        const int *classIds = columns->classIds;
+        const float *totals = columns->totals;
+        for (int i = 0; i < n; i++) {
+            columnMatches += classIds[i] == classId && totals[i] >= 150;
+        }
+    }
+    columnFilterMs = currentTimeMs() - start;
+    
+    // 单门课程：第2门成绩的总和（行式需要再跳转到各自的成绩数组）
+    start = currentTimeMs();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < n; i++) {
+            const Student *s = getStudent(manager, i);
+            if (s->scoreCount > 1) {
+                rowCourse += studentScore(s, 1);
+            }
+        }
+    }
+    rowCourseMs = currentTimeMs() - start;
+    start = currentTimeMs();
+    for (int r = 0; r < rounds; r++) {
+        const float *course = columns->scoreColumnCount > 1 ? columns->scoreColumns[1] : NULL;
+        for (int i = 0; course != NULL && i < n; i++) {
+            if (course[i] != COLUMN_SCORE_MISSING) {
+                columnCourse += course[i];
+            }
+        }
+    }
+    columnCourseMs = currentTimeMs() - start;
+    
+    printf("列式布局性能测试：%d 名学生，每项扫描 %d 轮，建立镜像 %lld ms\n", n, rounds, buildMs);
+    printf("%-20s %12s %12s %14s\n", "扫描", "行式(ms)", "列式(ms)", "列式(MB/s)");
+    printf("%-20s %12lld %12lld %14.0f\n", "总分求和", rowTotalMs, columnTotalMs,
+           columnTotalMs > 0 ? (double)sizeof(float) * n * rounds / 1048576.0 * 1000 / columnTotalMs : 0.0);
+    printf("%-20s %12lld %12lld %14.0f\n", "班级+总分筛选", rowFilterMs, columnFilterMs,
+           columnFilterMs > 0 ? (double)(sizeof(int) + sizeof(float)) * n * rounds / 1048576.0 * 1000 / columnFilterMs : 0.0);
+    printf("%-20s %12lld %12lld %14.0f\n", "单门成绩求和", rowCourseMs, columnCourseMs,
+           columnCourseMs > 0 ? (double)sizeof(float) * n * rounds / 1048576.0 * 1000 / columnCourseMs : 0.0);
+    if (rowSum != columnSum || rowMatches != columnMatches || rowCourse != columnCourse) {
+        printf("结果校验失败！\n");
+    }
+    freeManager(manager);
+}
+
+// 成绩池测试：为 count 名学生分配成绩数组并让其中十分之一重新录入不同数量的成绩，
+// 对比成绩池与逐个 malloc/realloc/free 的耗时和系统分配次数，最后输出成绩池碎片报告
+// 只有记录内放不下的成绩才进成绩池，所以成绩数取超出记录内容量的9~11门，重新录入的为9~20门
+void benchmarkScorePool(int count) {
+    if (count <= 0) {
+        return;
+    }
+    float **arrays = (float **)malloc(sizeof(float *) * (size_t)count);
+    int *counts = (int *)malloc(sizeof(int) * (size_t)count);
+    if (arrays == NULL || counts == NULL) {
+        free(arrays);
+        free(counts);
+        return;
+    }
+    
+    // 逐个向系统申请（原有方式：录入时先申请10个再收缩）
+    long long mallocCalls = 0;
+    long long start = currentTimeMs();
+    for (int i = 0; i < count; i++) {
+        arrays[i] = (float *)malloc(sizeof(float) * 20);
+        counts[i] = SCORE_INLINE_COUNT + 1 + i % 3;
+        arrays[i] = (float *)realloc(arrays[i], sizeof(float) * counts[i]);
+        mallocCalls += 2;
+    }
+    for (int i = 0; i < count; i += 10) {
+        counts[i] = SCORE_INLINE_COUNT + 1 + i % 12;
+        arrays[i] = (float *)realloc(arrays[i], sizeof(float) * counts[i]);
+        mallocCalls++;
+    }
+    long long mallocMs = currentTimeMs() - start;
+    start = currentTimeMs();
+    for (int i = 0; i < count; i++) {
+        free(arrays[i]);
+    }
+    long long mallocFreeMs = currentTimeMs() - start;
+    
+    // 成绩池
+    ScorePool pool;
+    memset(&pool, 0, sizeof(ScorePool));
+    start = currentTimeMs();
+    for (int i = 0; i < count; i++) {
+        counts[i] = SCORE_INLINE_COUNT + 1 + i % 3;
+        arrays[i] = scorePoolAlloc(&pool, counts[i]);
+    }
+    for (int i = 0; i < count; i += 10) {
+        int newCount = SCORE_INLINE_COUNT + 1 + i % 12;
+        arrays[i] = scorePoolRealloc(&pool, arrays[i], counts[i], newCount);
+        counts[i] = newCount;
+    }
+    long long poolMs = currentTimeMs() - start;
+    
+    printf("成绩池测试：%d 名学生，%d 名重新录入成绩\n", count, (count + 9) / 10);
+    reportScorePool(&pool);
+    long long poolAllocs = pool.systemAllocs;
+    start = currentTimeMs();
+    scorePoolRelease(&pool);
+    long long poolFreeMs = currentTimeMs() - start;
+    
+    printf("%-12s %14s %12s %14s\n", "方式", "系统分配次数", "分配(ms)", "整体释放(ms)");
+    printf("%-12s %14lld %12lld %14lld\n", "malloc", mallocCalls, mallocMs, mallocFreeMs);
+    printf("%-12s %14lld %12lld %14lld\n", "成绩池", poolAllocs, poolMs, poolFreeMs);
+    free(arrays);
+    free(counts);
+}
+
+// 成绩内嵌测试：对 count 名各有3门成绩的学生遍历全部成绩求和，
+// 对比成绩存放在记录内与每名学生单独分配成绩数组（按打乱的顺序分配，模拟长期增删后的堆）两种布局
+void benchmarkInlineScores(int count) {
+    StudentManager *manager = initManager(count);
+    EmbeddedStudent *legacy = (EmbeddedStudent *)malloc(sizeof(EmbeddedStudent) * (size_t)(count > 0 ? count : 1));
+    int *order = (int *)malloc(sizeof(int) * (size_t)(count > 0 ? count : 1));
+    if (manager == NULL || legacy == NULL || order == NULL) {
+        freeManager(manager);
+        free(legacy);
+        free(order);
+        return;
+    }
+    addSyntheticStudents(manager, 0, count, NULL, 0, 0, NULL);
+    int n = manager->count;
+    
+    // 单独分配的成绩数组：按随机顺序申请，相邻学生的成绩不再相邻
+    unsigned int seed = 12345;
+    for (int i = 0; i < n; i++) {
+        order[i] = i;
+    }
+    for (int i = n - 1; i > 0; i--) {
+        seed = seed * 1103515245u + 12345u;
+        int j = (int)(seed % (unsigned int)(i + 1));
+        int temp = order[i];
+        order[i] = order[j];
+        order[j] = temp;
+    }
+    int allocated = 0;
+    for (; allocated < n; allocated++) {
+        int i = order[allocated];
+        const Student *source = getStudent(manager, i);
+        legacy[i].scoreCount = source->scoreCount;
+        legacy[i].totalScore = (float)studentTotal(source);
+        legacy[i].scores = (float *)malloc(sizeof(float) * source->scoreCount);
+        if (legacy[i].scores == NULL) {
+            break;
+        }
+        copyStudentScores(source, legacy[i].scores);
+    }
+    
+    int rounds = 10;
+    double inlineSum = 0, heapSum = 0;
+    long long start = currentTimeMs();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < n; i++) {
+            const Student *s = getStudent(manager, i);
+            for (int j = 0; j < s->scoreCount; j++) {
+                inlineSum += studentScore(s, j);
+            }
+        }
+    }
+    long long inlineMs = currentTimeMs() - start;
+    
+    long long heapMs = 0;
+    if (allocated == n) {
+        start = currentTimeMs();
+        for (int r = 0; r < rounds; r++) {
+            for (int i = 0; i < n; i++) {
+                const EmbeddedStudent *s = &legacy[i];
+                for (int j = 0; j < s->scoreCount; j++) {
+                    heapSum += s->scores[j];
+                }
+            }
+        }
+        heapMs = currentTimeMs() - start;
+    }
+    
+    // 每名学生访问的缓存行：记录本身按顺序读取，单独分配的成绩数组还要多读一行（随机位置）
+    printf("成绩内嵌测试：%d 名学生，遍历全部成绩 %d 轮\n", n, rounds);
+    printf("%-16s %10s %12s %16s\n", "布局", "耗时(ms)", "ns/学生", "缓存行/学生(估)");
+    printf("%-16s %10lld %12.2f %16.2f\n", "记录内成绩", inlineMs,
+           n > 0 ? inlineMs * 1e6 / ((double)n * rounds) : 0.0, sizeof(Student) / 64.0);
+    printf("%-16s %10lld %12.2f %16.2f\n", "单独成绩数组", heapMs,
+           n > 0 ? heapMs * 1e6 / ((double)n * rounds) : 0.0, sizeof(EmbeddedStudent) / 64.0 + 1);
+    if (allocated == n && inlineSum != heapSum) {
+        printf("结果校验失败！\n");
+    }
+    
+    for (int i = 0; i < allocated; i++) {
+        free(legacy[order[i]].scores);
+    }
+    free(legacy);
+    free(order);
+    freeManager(manager);
+}
+
+// 学号哈希索引性能测试：从1千到 maxCount 条记录，统计插入与查找的平均耗时
+void benchmarkIdIndex(int maxCount) {
+    printf("学号哈希索引性能测试\n");
+    printf("%12s %16s %16s %16s\n", "记录数", "插入(ns/条)", "命中查找(ns/次)", "未命中(ns/次)");
+    
+    for (int n = 1000; n <= maxCount; n *= 10) {
+        StudentManager *manager = initManager(n);
+        if (manager == NULL) {
+            return;
+        }
+        
+        Student student;
+        memset(&student, 0, sizeof(Student));
+        clock_t start = clock();
+        for (int i = 0; i < n; i++) {
+            sprintf(student.id, "S%09d", i);
+            appendStudent(manager, &student);
+        }
+        double insertTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+        
+        int lookups = 1000000;
+        char id[20];
+        int found = 0;
+        unsigned int seed = 12345;
+        start = clock();
+        for (int i = 0; i < lookups; i++) {
+            seed = seed * 1103515245u + 12345u;
+            sprintf(id, "S%09d", (int)(seed % (unsigned int)n));
+            found += findStudentById(manager, id) != -1;
+        }
+        double hitTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+        
+        start = clock();
+        for (int i = 0; i < lookups; i++) {
+            sprintf(id, "X%09d", i);
+            found += findStudentById(manager, id) != -1;
+        }
+        double missTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+        
+        printf("%12d %16.1f %16.1f %16.1f\n", n, insertTime * 1e9 / n,
+               hitTime * 1e9 / lookups, missTime * 1e9 / lookups);
+        if (found != lookups) {
+            printf("索引校验失败：命中 %d / %d\n", found, lookups);
+        }
+        
+        freeManager(manager);
+    }
+}
+
+// 生成第 seq 个测试学生（含3门成绩）
+void makeSyntheticStudent(StudentManager *manager, Student *student, int seq) {
+    static const char *genders[] = {"男", "女"};
+    char className[CLASS_NAME_SIZE];
+    memset(student, 0, sizeof(Student));
+    sprintf(student->name, "学生%d", seq);
+    strcpy(student->gender, genders[seq & 1]);
+    sprintf(student->id, "S%09d", seq);
+    sprintf(className, "%d班", seq % 40 + 1);
+    student->classId = dictIntern(&manager->strings, className);
+    student->departmentId = dictIntern(&manager->strings, "测试学院");
+    student->majorId = dictIntern(&manager->strings, "测试专业");
+    float scores[3];
+    for (int i = 0; i < 3; i++) {
+        scores[i] = (float)((seq * 7 + i * 13) % 101);
+    }
+    setStudentScores(&manager->scorePool, student, scores, 3);
+}
+
+// 向 manager 追加 count 名测试学生（见 makeSyntheticStudent），性能测试与自检共用
+// 第 i 名的编号为 order[i]（order 为NULL时为 first + i）；scoreCount 大于0时改为这么多门（最多16门）
+// 0.00~100.00 的随机成绩，randomNames 非0时改用随机中文姓名，两者的随机数都取自 *seed。
+// 内存不足时提前停止，返回添加的人数
+int addSyntheticStudents(StudentManager *manager, int first, int count, const int *order,
+                         int scoreCount, int randomNames, unsigned int *seed) {
+    Student student;
+    float scores[16];
+    scoreCount = scoreCount < 16 ? scoreCount : 16;
+    for (int i = 0; i < count; i++) {
+        makeSyntheticStudent(manager, &student, order != NULL ? order[i] : first + i);
+        if (randomNames) {
+            makeRandomChineseName(student.name, seed);
+        }
+        if (scoreCount > 0) {
+            for (int j = 0; j < scoreCount; j++) {
+                *seed = *seed * 1103515245u + 12345u;
+                scores[j] = (float)((*seed >> 8) % 10001) / 100.0f;
+            }
+            setStudentScores(&manager->scorePool, &student, scores, scoreCount);
+        }
+        if (appendStudent(manager, &student) == -1) {
+            releaseStudentScores(&manager->scorePool, &student);
+            return i;
+        }
+    }
+    return count;
+}
+
+// 获取进程峰值常驻内存（KB），不支持时返回-1
+long getPeakRssKb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return (long)(counters.PeakWorkingSetSize / 1024);
+    }
+    return -1;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return usage.ru_maxrss;
+    }
+    return -1;
+#endif
+}
+
+// 存储压力测试：从初始容量100开始连续插入 total 个学生，报告吞吐量与峰值内存
+void stressTestStore(int total) {
+    StudentManager *manager = initManager(100);
+    if (manager == NULL) {
+        return;
+    }
+    
+    printf("存储压力测试：插入 %d 名学生\n", total);
+    Student student;
+    int reportStep = total / 10 > 0 ? total / 10 : 1;
+    clock_t start = clock();
+    for (int i = 0; i < total; i++) {
+        makeSyntheticStudent(manager, &student, i);
+        if (appendStudent(manager, &student) == -1) {
+            releaseStudentScores(&manager->scorePool, &student);
+            printf("第 %d 条插入失败：内存不足\n", i + 1);
+            break;
+        }
+        if ((i + 1) % reportStep == 0) {
+            double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+            printf("%12d 条  %8.2f 秒  %12.0f 条/秒  峰值内存 %ld KB\n", i + 1, elapsed,
+                   elapsed > 0 ? (i + 1) / elapsed : 0.0, getPeakRssKb());
+        }
+    }
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+    
+    printf("完成：%d 条，容量 %d（%d 块），耗时 %.2f 秒，%.0f 条/秒，峰值内存 %ld KB\n",
+           manager->count, manager->capacity, manager->chunkCount, elapsed,
+           elapsed > 0 ? manager->count / elapsed : 0.0, getPeakRssKb());
+    freeManager(manager);
+}
+
+// 学生记录内存报告：对比名称内嵌在记录中与改用字典编号两种布局下每名学生占用的字节数
+void reportStudentMemory(StudentManager *manager) {
+    size_t dictBytes = dictMemoryBytes(&manager->strings);
+    double shared = manager->count > 0 ? (double)dictBytes / manager->count : 0.0;
+    printf("字典字符串数\t%d\n", manager->strings.count);
+    printf("字典占用字节\t%llu\n", (unsigned long long)dictBytes);
+    printf("内嵌名称每名学生字节\t%llu\n", (unsigned long long)sizeof(EmbeddedStudent));
+    printf("字典编号每名学生字节\t%.2f（记录 %llu + 字典分摊 %.2f）\n", sizeof(Student) + shared,
+           (unsigned long long)sizeof(Student), shared);
+    printf("学生记录总字节\t%llu -> %llu\n", (unsigned long long)sizeof(EmbeddedStudent) * manager->count,
+           (unsigned long long)(sizeof(Student) * manager->count + dictBytes));
+}
+
+// 字典内存测试：生成 count 名测试学生（40个班级）后输出内存报告
+void benchmarkStringDict(int count) {
+    StudentManager *manager = initManager(count);
+    if (manager == NULL) {
+        return;
+    }
+    addSyntheticStudents(manager, 0, count, NULL, 0, 0, NULL);
+    printf("字典内存测试：%d 名学生\n", manager->count);
+    reportStudentMemory(manager);
+    printf("峰值内存\t%ld KB\n", getPeakRssKb());
+    freeManager(manager);
+}
+
+// 以制表符分隔输出一名学生（批处理模式使用）
+void printStudentLine(FILE *out, StudentManager *manager, const Student *student) {
+    fprintf(out, "%s\t%s\t%s\t%s\t%s\t%s\t", student->id, student->name, student->gender,
+            dictString(&manager->strings, student->classId), dictString(&manager->strings, student->departmentId),
+            dictString(&manager->strings, student->majorId));
+    for (int i = 0; i < student->scoreCount; i++) {
+        fprintf(out, i == 0 ? "%.2f" : ",%.2f", studentScore(student, i));
+    }
+    fprintf(out, "\t%.2f\n", studentTotal(student));
+}
+
+// CSV 字段输出（含逗号、引号或换行时加引号）
+void writeCsvField(FILE *out, const char *text) {
+    if (strpbrk(text, ",\"\r\n") == NULL) {
+        fputs(text, out);
+        return;
+    }
+    fputc('"', out);
+    for (const char *p = text; *p != '\0'; p++) {
+        if (*p == '"') {
+            fputc('"', out);
+        }
+        fputc(*p, out);
+    }
+    fputc('"', out);
+}
+
+// 自检失败时输出原因并计数
+int selfTestCheck(int condition, const char *message, int *failures) {
+    if (!condition) {
+        printf("失败\t%s（%s模式）\n", message, fixedScoreMode ? "定点" : "浮点");
+        (*failures)++;
+    }
+    return condition;
+}
+
+// 排行与逐个扫描不一致的项数：前50名的总分逐个相同，抽查的学生名次等于总分更高的人数加1，排行人数等于学生数
+int selfTestRankMismatches(StudentManager *manager) {
+    int n = manager->count;
+    int *keys = (int *)malloc(sizeof(int) * (size_t)(n > 0 ? n : 1));
+    int topCount;
+    int *top = rankTopStudents(manager, RANK_SCOPE_ALL, -1, 50, &topCount);
+    if (keys == NULL || top == NULL) {
+        free(keys);
+        free(top);
+        return 1;
+    }
+    for (int i = 0; i < n; i++) {
+        keys[i] = rankKey(getStudent(manager, i));
+    }
+    qsort(keys, (size_t)n, sizeof(int), compareIndexes);
+    int mismatches = topCount != (n < 50 ? n : 50);
+    for (int i = 0; i < topCount && i < n; i++) {
+        mismatches += rankKey(getStudent(manager, top[i])) != keys[n - 1 - i];
+    }
+    for (int index = 0; index < n; index += n / 20 + 1) {
+        int key = rankKey(getStudent(manager, index));
+        int above = 0, rank, total;
+        double percentile;
+        for (int i = 0; i < n; i++) {
+            above += keys[i] > key;
+        }
+        mismatches += !rankOfStudent(manager, RANK_SCOPE_ALL, -1, index, &rank, &total, &percentile) ||
+                      rank != above + 1 || total != n;
+    }
+    RankTree *tree = rankTreeFor(manager, RANK_SCOPE_ALL, -1);
+    mismatches += tree == NULL || rankSize(tree, tree->root) != n;
+    free(keys);
+    free(top);
+    return mismatches;
+}
+
+// 成绩分布与排序不一致的项数：第1门成绩的中位数、P90、P99 等于排序后按最近秩法取得的值，人数等于学生数
+int selfTestQuantileMismatches(StudentManager *manager) {
+    static const double quantiles[3] = {0.5, 0.9, 0.99};
+    int n = manager->count;
+    ScoreHistogram *histogram = histogramFor(manager, -1);
+    int *sorted = (int *)malloc(sizeof(int) * (size_t)(n > 0 ? n : 1));
+    if (histogram == NULL || sorted == NULL) {
+        free(sorted);
+        return 1;
+    }
+    for (int i = 0; i < n; i++) {
+        sorted[i] = scoreToHundredths(studentScore(getStudent(manager, i), 0));
+    }
+    qsort(sorted, (size_t)n, sizeof(int), compareIndexes);
+    int mismatches = histogram->totals[0] != n;
+    for (int q = 0; q < 3 && n > 0; q++) {
+        long long rank = (long long)(quantiles[q] * n + 0.999999);
+        mismatches += histogramQuantile(histogram, 0, quantiles[q]) != sorted[(rank < 1 ? 1 : rank) - 1];
+    }
+    free(sorted);
+    return mismatches;
+}
+
+// 索引自检：学号打乱顺序添加、随机姓名与随机成绩的测试学生，姓名、拼音、学号有序索引的查询结果
+// 应与逐个扫描一致，排行与成绩分布应与排序结果一致；再交替添加与查询、随机修改成绩后复核
+void selfTestIndexes(int *failures) {
+    int count = 3000;
+    StudentManager *manager = initManager(count);
+    int *order = (int *)malloc(sizeof(int) * (size_t)count);
+    if (manager == NULL || order == NULL) {
+        free(order);
+        freeManager(manager);
+        selfTestCheck(0, "索引自检内存分配", failures);
+        return;
+    }
+    unsigned int seed = 12345;
+    for (int i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    for (int i = count - 1; i > 0; i--) {
+        seed = seed * 1103515245u + 12345u;
+        int j = (int)((seed >> 8) % (unsigned int)(i + 1));
+        int temp = order[i];
+        order[i] = order[j];
+        order[j] = temp;
+    }
+    int added = addSyntheticStudents(manager, 0, count, order, 3, 1, &seed);
+    free(order);
+    if (!selfTestCheck(added == count, "索引自检添加学生", failures)) {
+        freeManager(manager);
+        return;
+    }
+    
+    // 姓名：字元倒排索引与逐个 strstr 的匹配数
+    const Student *sample = getStudent(manager, count / 2);
+    char sampleName[sizeof(sample->name)];
+    strcpy(sampleName, sample->name);
+    const char *names[] = {sampleName, "欧阳", "子轩", "张伟", "王", "诸葛亮"};
+    int mismatches = 0;
+    for (int q = 0; q < (int)(sizeof(names) / sizeof(names[0])); q++) {
+        int scanned = 0, found;
+        for (int i = 0; i < manager->count; i++) {
+            scanned += strstr(getStudent(manager, i)->name, names[q]) != NULL;
+        }
+        free(findStudentsByName(manager, names[q], &found));
+        mismatches += found != scanned;
+    }
+    selfTestCheck(mismatches == 0, "姓名索引与逐个扫描一致", failures);
+    
+    // 拼音：有序拼音键的前缀查找与逐个转换拼音比较；之后每添加一名学生（带来新键）就查询一次
+    char full[PINYIN_KEY_SIZE], initials[PINYIN_KEY_SIZE];
+    char sampleFull[PINYIN_KEY_SIZE], sampleInitials[PINYIN_KEY_SIZE];
+    namePinyinKeys(sampleName, sampleFull, sizeof(sampleFull), sampleInitials, sizeof(sampleInitials));
+    const char *prefixes[] = {sampleFull, sampleInitials, "zhangw", "zw", "ouyang", "z", "xues", "xs"};
+    int prefixCount = (int)(sizeof(prefixes) / sizeof(prefixes[0]));
+    mismatches = 0;
+    for (int round = 0; round <= 40; round++) {
+        if (round > 0 && addSyntheticStudents(manager, count + round, 1, NULL, 0, 0, NULL) != 1) {
+            mismatches++;
+            break;
+        }
+        for (int q = round == 0 ? 0 : prefixCount - 2; q < prefixCount; q++) {
+            size_t length = strlen(prefixes[q]);
+            int scanned = 0, found;
+            for (int i = 0; i < manager->count; i++) {
+                namePinyinKeys(getStudent(manager, i)->name, full, sizeof(full), initials, sizeof(initials));
+                scanned += strncmp(full, prefixes[q], length) == 0 || strncmp(initials, prefixes[q], length) == 0;
+            }
+            free(findStudentsByPinyin(manager, prefixes[q], &found));
+            mismatches += found != scanned;
+        }
+    }
+    selfTestCheck(mismatches == 0, "拼音索引与逐个扫描一致", failures);
+    
+    // 学号：不同长度的前缀与范围（学号按打乱的顺序添加）
+    const char *lows[] = {"S0000015", "S000001", "S00000", "S000001000", "S000002990"};
+    const char *highs[] = {NULL, NULL, NULL, "S000001999", "S000003020"};
+    mismatches = 0;
+    for (int q = 0; q < (int)(sizeof(lows) / sizeof(lows[0])); q++) {
+        size_t length = strlen(lows[q]);
+        int scanned = 0, found;
+        for (int i = 0; i < manager->count; i++) {
+            const char *id = getStudent(manager, i)->id;
+            scanned += highs[q] == NULL ? strncmp(id, lows[q], length) == 0
+                                        : strcmp(id, lows[q]) >= 0 && strcmp(id, highs[q]) <= 0;
+        }
+        free(highs[q] == NULL ? findStudentsByIdPrefix(manager, lows[q], &found)
+                              : findStudentsByIdRange(manager, lows[q], highs[q], &found));
+        mismatches += found != scanned;
+    }
+    selfTestCheck(mismatches == 0, "学号有序索引与逐个扫描一致", failures);
+    
+    // 排行与成绩分布：建立后核对，随机修改一批成绩（两者随之增量维护）后再核对
+    float scores[3];
+    mismatches = selfTestRankMismatches(manager) + selfTestQuantileMismatches(manager);
+    for (int u = 0; u < 500; u++) {
+        seed = seed * 1103515245u + 12345u;
+        int index = (int)((seed >> 8) % (unsigned int)manager->count);
+        for (int j = 0; j < 3; j++) {
+            seed = seed * 1103515245u + 12345u;
+            scores[j] = (float)((seed >> 8) % 10001) / 100.0f;
+        }
+        unindexStudentScores(manager, index);
+        setStudentScores(&manager->scorePool, getStudent(manager, index), scores, 3);
+        indexStudentScores(manager, index);
+    }
+    mismatches += selfTestRankMismatches(manager) + selfTestQuantileMismatches(manager);
+    selfTestCheck(mismatches == 0, "排行与成绩分布与排序一致", failures);
+    freeManager(manager);
+}
+
+// 成绩存储自检：0.00-100.00 全部两位小数成绩的文本-存储-显示往返、记录内与成绩池存放、
+// 精确总和、跨存储模式的快照保存与加载，日志重放删除后的索引一致性，以及各查询索引与逐个扫描的结果一致。全部通过返回0
+int runSelfTest() {
+    int savedMode = fixedScoreMode;
+    int failures = 0;
+    const char *path = "sims_selftest.tmp";
+    
+    for (int mode = 0; mode < 2; mode++) {
+        fixedScoreMode = mode;
+        StudentManager *manager = initManager(16);
+        if (manager == NULL) {
+            fixedScoreMode = savedMode;
+            return 1;
+        }
+        Student student;
+        memset(&student, 0, sizeof(student));
+        
+        // 逐个两位小数成绩：文本解析后存入，再按两位小数显示应与原文本一致
+        int textMismatches = 0;
+        for (int h = 0; h <= 10000; h++) {
+            char text[16], shown[16];
+            float score;
+            sprintf(text, "%d.%02d", h / 100, h % 100);
+            if (!parseScoreText(text, &score) || !setStudentScores(&manager->scorePool, &student, &score, 1)) {
+                textMismatches++;
+                continue;
+            }
+            sprintf(shown, "%.2f", studentScore(&student, 0));
+            if (strcmp(text, shown) != 0 || (mode == 1 && student.scoreData.inlineFixed[0] != h)) {
+                textMismatches++;
+            }
+        }
+        selfTestCheck(textMismatches == 0, "两位小数成绩往返", &failures);
+        
+        // 记录内与成绩池两种存放方式，以及两者之间的切换
+        float scores[40];
+        int counts[] = {1, inlineScoreCapacity(), inlineScoreCapacity() + 1, 40, 3};
+        for (int c = 0; c < (int)(sizeof(counts) / sizeof(counts[0])); c++) {
+            int count = counts[c];
+            int expectedHundredths = 0;
+            for (int i = 0; i < count; i++) {
+                int h = (i * 3719 + c * 131) % 10001;
+                scores[i] = h / 100.0f;
+                expectedHundredths += h;
+            }
+            if (!selfTestCheck(setStudentScores(&manager->scorePool, &student, scores, count), "成绩存放", &failures)) {
+                continue;
+            }
+            int same = student.scoreCount == count;
+            for (int i = 0; i < count && same; i++) {
+                same = studentScore(&student, i) == scores[i];
+            }
+            selfTestCheck(same, "成绩数组往返", &failures);
+            // 定点模式下总和是精确的整数，浮点模式允许累加误差
+            double total = studentTotal(&student);
+            selfTestCheck(mode == 1 ? student.total.totalHundredths == expectedHundredths
+                                    : (int)(total * 100 + 0.5) == expectedHundredths,
+                          "成绩总和", &failures);
+        }
+        releaseStudentScores(&manager->scorePool, &student);
+        
+        // 快照：以本模式保存，再以另一模式加载，成绩应逐个一致
+        for (int i = 0; i < 200; i++) {
+            makeSyntheticStudent(manager, &student, i);
+            if (i % 7 == 0) {
+                for (int j = 0; j < 20; j++) {
+                    scores[j] = ((i + j * 53) % 10001) / 100.0f;
+                }
+                setStudentScores(&manager->scorePool, &student, scores, 20);
+            }
+            if (appendStudent(manager, &student) == -1) {
+                releaseStudentScores(&manager->scorePool, &student);
+            }
+        }
+        int saved = selfTestCheck(saveSnapshot(manager, path), "快照保存", &failures);
+        fixedScoreMode = !mode;
+        StudentManager *reloaded = initManager(16);
+        if (saved && reloaded != NULL) {
+            int loaded = loadSnapshot(reloaded, path, NULL);
+            int same = loaded == manager->count;
+            for (int i = 0; i < loaded && same; i++) {
+                const Student *after = getStudent(reloaded, i);
+                fixedScoreMode = mode;
+                const Student *before = getStudent(manager, i);
+                float expected[40];
+                int expectedCount = before->scoreCount;
+                double expectedTotal = studentTotal(before);
+                copyStudentScores(before, expected);
+                fixedScoreMode = !mode;
+                same = strcmp(after->id, before->id) == 0 && after->scoreCount == expectedCount &&
+                       (int)(studentTotal(after) * 100 + 0.5) == (int)(expectedTotal * 100 + 0.5);
+                for (int j = 0; j < expectedCount && same; j++) {
+                    same = scoreToHundredths(studentScore(after, j)) == scoreToHundredths(expected[j]);
+                }
+            }
+            selfTestCheck(same, "跨模式快照往返", &failures);
+            // 快照带索引区，载入后直接恢复的索引应与学生数据一致，姓名检索结果与原管理器相同
+            int before = 0, after = 0;
+            if (loaded > 0) {
+                free(findStudentsByName(manager, getStudent(manager, 0)->name, &before));
+                free(findStudentsByName(reloaded, getStudent(reloaded, 0)->name, &after));
+            }
+            selfTestCheck(checkStudentIndexes(reloaded) == 0 && before == after, "快照恢复索引", &failures);
+        }
+        freeManager(reloaded);
+        remove(path);
+        fixedScoreMode = mode;
+        freeManager(manager);
+        
+        // 日志重放：删除（只做标记）之后追加的学生使学号哈希扩容重建，已删除的学生不能回到哈希中；
+        // 删除后以同一学号重新录入、再修改的学生应落在新记录上。重放结束压缩后各索引应一致
+        manager = initManager(16);
+        if (manager == NULL) {
+            continue;
+        }
+        unsigned char payload[sizeof(SnapshotStudent) + sizeof(float) * JOURNAL_MAX_SCORES];
+        int n = 0;
+        while (n < 150 || (manager->idIndexUsed + 2) * 10 <= manager->idIndexCapacity * 7) {
+            addSyntheticStudents(manager, n++, 1, NULL, 0, 0, NULL);
+        }
+        rankTreeFor(manager, RANK_SCOPE_ALL, 0);
+        histogramFor(manager, -1);
+        char id[20];
+        for (int i = 0; i < n; i += 4) {
+            sprintf(id, "S%09d", i);
+            applyJournalRecord(manager, JOURNAL_DELETE, (const unsigned char *)id, (unsigned int)strlen(id) + 1);
+        }
+        for (int i = n; i < n + 4; i++) {
+            makeSyntheticStudent(manager, &student, i);
+            applyJournalRecord(manager, JOURNAL_ADD, payload, journalStudentPayload(manager, &student, payload));
+            releaseStudentScores(&manager->scorePool, &student);
+        }
+        makeSyntheticStudent(manager, &student, 5);
+        sprintf(id, "S%09d", 5);
+        applyJournalRecord(manager, JOURNAL_DELETE, (const unsigned char *)id, (unsigned int)strlen(id) + 1);
+        applyJournalRecord(manager, JOURNAL_ADD, payload, journalStudentPayload(manager, &student, payload));
+        strcpy(student.name, "重新录入");
+        applyJournalRecord(manager, JOURNAL_MODIFY, payload, journalStudentPayload(manager, &student, payload));
+        releaseStudentScores(&manager->scorePool, &student);
+        compactStudents(manager);
+        
+        int missing = 0;
+        for (int i = 0; i < n + 4; i++) {
+            sprintf(id, "S%09d", i);
+            missing += (findStudentById(manager, id) != -1) != (i >= n || i % 4 != 0);
+        }
+        int index = findStudentById(manager, "S000000005");
+        selfTestCheck(missing == 0 && manager->count == n + 4 - (n + 3) / 4 &&
+                      index != -1 && strcmp(getStudent(manager, index)->name, "重新录入") == 0,
+                      "日志重放删除后按学号查找", &failures);
+        selfTestCheck(checkStudentIndexes(manager) == 0, "日志重放删除后索引一致", &failures);
+        
+        // 逐个删除：空位留在学生数组中，各索引与不带条件的筛选都不应再包含它们
+        int before = liveStudentCount(manager);
+        for (int i = 1; i < manager->count; i += 9) {
+            removeStudentAt(manager, i);
+        }
+        int listed;
+        free(filterStudents(manager, NULL, NULL, NULL, &listed));
+        selfTestCheck(manager->deletedCount > 0 && listed == liveStudentCount(manager) &&
+                      listed == before - (before + 7) / 9 && checkStudentIndexes(manager) == 0,
+                      "逐个删除后索引一致", &failures);
+        freeManager(manager);
+        
+        // 各查询索引与逐个扫描的结果
+        selfTestIndexes(&failures);
+    }
+    
+    fixedScoreMode = savedMode;
+    printf(failures == 0 ? "自检通过\n" : "自检失败 %d 项\n", failures);
+    return failures == 0 ? 0 : 1;
+}
+
+// 生成一个随机中文姓名（单姓或复姓加一到两个字），seed 为随机数状态
+void makeRandomChineseName(char *name, unsigned int *seed) {
+    static const char *surnames[] = {"王", "李", "张", "刘", "陈", "杨", "黄", "赵", "吴", "周",
+                                     "徐", "孙", "马", "朱", "胡", "郭", "何", "林", "罗", "高",
+                                     "欧阳", "司马", "诸葛", "上官"};
+    static const char *givenChars[] = {"伟", "芳", "娜", "敏", "静", "丽", "强", "磊", "军", "洋",
+                                       "勇", "艳", "杰", "娟", "涛", "明", "超", "秀", "霞", "平",
+                                       "刚", "桂", "英", "华", "文", "玉", "兰", "建", "国", "红",
+                                       "志", "海", "燕", "鹏", "飞", "宇", "浩", "然", "晨", "欣",
+                                       "子", "轩", "梓", "涵", "怡", "博", "思", "雨", "嘉", "琪"};
+    int surnameCount = (int)(sizeof(surnames) / sizeof(surnames[0]));
+    int givenCount = (int)(sizeof(givenChars) / sizeof(givenChars[0]));
+    *seed = *seed * 1103515245u + 12345u;
+    strcpy(name, surnames[(*seed >> 16) % (unsigned int)surnameCount]);
+    int givenLength = (*seed & 3) == 0 ? 1 : 2;
+    for (int j = 0; j < givenLength; j++) {
+        *seed = *seed * 1103515245u + 12345u;
+        strcat(name, givenChars[(*seed >> 16) % (unsigned int)givenCount]);
+    }
+}
+
+// 姓名索引性能测试：count 名随机中文姓名，对比逐个扫描与字元倒排索引的查找耗时
+void benchmarkNameIndex(int count) {
+    StudentManager *manager = initManager(count);
+    if (manager == NULL) {
+        return;
+    }
+    
+    unsigned int seed = 12345;
+    long long start = currentTimeMs();
+    addSyntheticStudents(manager, 0, count, NULL, 0, 1, &seed);
+    long long buildMs = currentTimeMs() - start;
+    
+    const char *queries[] = {getStudent(manager, manager->count / 2)->name, "欧阳", "子轩", "张伟", "诸葛亮"};
+    const char *labels[] = {"完整姓名", "复姓", "名字两字", "常见姓名", "不存在"};
+    int queryCount = (int)(sizeof(queries) / sizeof(queries[0]));
+    printf("学生数量\t%d\n", manager->count);
+    printf("建立索引（随添加）\t%lld ms\n", buildMs);
+    printf("字元字典\t%d 个\n", manager->nameGrams.count);
+    printf("查询          匹配数    扫描(ms)    索引(ms)\n");
+    for (int q = 0; q < queryCount; q++) {
+        int scanRounds = 3, indexRounds = 200;
+        int scanMatches = 0, indexMatches = 0;
+        start = currentTimeMs();
+        for (int r = 0; r < scanRounds; r++) {
+            scanMatches = 0;
+            for (int i = 0; i < manager->count; i++) {
+                scanMatches += strstr(getStudent(manager, i)->name, queries[q]) != NULL;
+            }
+        }
+        double scanMs = (double)(currentTimeMs() - start) / scanRounds;
+        start = currentTimeMs();
+        for (int r = 0; r < indexRounds; r++) {
+            free(findStudentsByName(manager, queries[q], &indexMatches));
+        }
+        double indexMs = (double)(currentTimeMs() - start) / indexRounds;
+        printf("%-12s %9d %11.2f %11.3f\n", labels[q], scanMatches, scanMs, indexMs);
+    }
+    freeManager(manager);
+}
+
+// 拼音索引性能测试：count 名随机中文姓名，对比逐个转换拼音比较与有序拼音键的前缀查找耗时
+void benchmarkPinyinIndex(int count) {
+    StudentManager *manager = initManager(count);
+    if (manager == NULL) {
+        return;
+    }
+    unsigned int seed = 12345;
+    long long start = currentTimeMs();
+    addSyntheticStudents(manager, 0, count, NULL, 0, 1, &seed);
+    long long buildMs = currentTimeMs() - start;
+    
+    char full[PINYIN_KEY_SIZE], initials[PINYIN_KEY_SIZE];
+    char sampleFull[PINYIN_KEY_SIZE], sampleInitials[PINYIN_KEY_SIZE];
+    namePinyinKeys(getStudent(manager, manager->count / 2)->name, sampleFull, sizeof(sampleFull),
+                   sampleInitials, sizeof(sampleInitials));
+    const char *queries[] = {sampleFull, sampleInitials, "zhangw", "zw", "ouyang", "z", "lx"};
+    int queryCount = (int)(sizeof(queries) / sizeof(queries[0]));
+    printf("学生数量\t%d\n", manager->count);
+    printf("建立索引（随添加）\t%lld ms\n", buildMs);
+    printf("拼音检索键\t%d 个\n", manager->pinyinOrderCount);
+    printf("查询          匹配数    扫描(ms)    索引(ms)\n");
+    for (int q = 0; q < queryCount; q++) {
+        size_t length = strlen(queries[q]);
+        int scanMatches = 0, indexMatches = 0;
+        start = currentTimeMs();
+        for (int i = 0; i < manager->count; i++) {
+            namePinyinKeys(getStudent(manager, i)->name, full, sizeof(full), initials, sizeof(initials));
+            scanMatches += strncmp(full, queries[q], length) == 0 || strncmp(initials, queries[q], length) == 0;
+        }
+        long long scanMs = currentTimeMs() - start;
+        int rounds = 100;
+        start = currentTimeMs();
+        for (int r = 0; r < rounds; r++) {
+            free(findStudentsByPinyin(manager, queries[q], &indexMatches));
+        }
+        double indexMs = (double)(currentTimeMs() - start) / rounds;
+        printf("%-12s %9d %11lld %11.3f\n", queries[q], scanMatches, scanMs, indexMs);
+    }
+    
+    // 添加与查询交替：新增学生用带编号的姓名，每人带来一个新键，查找前只需排序新键并归并
+    int rounds = 1000, added = 0, matches = 0;
+    int keysBefore = manager->pinyinOrderCount;
+    start = currentTimeMs();
+    for (int r = 0; r < rounds && addSyntheticStudents(manager, count + r, 1, NULL, 0, 0, NULL) == 1; r++) {
+        added++;
+        free(findStudentsByPinyin(manager, "zw", &matches));
+    }
+    double alternateMs = (double)(currentTimeMs() - start) / (rounds > 0 ? rounds : 1);
+    printf("添加后立即查询\t%d 次，新键 %d 个，平均每次 %.3f ms\n", added, manager->pinyinOrderCount - keysBefore,
+           alternateMs);
+    freeManager(manager);
+}
+
+// 学号有序索引性能测试：count 名学生按打乱的学号顺序添加，对比全表扫描与有序索引的前缀、范围查找耗时
+void benchmarkIdOrder(int count) {
+    StudentManager *manager = initManager(count);
+    int *order = malloc(sizeof(int) * (count > 0 ? count : 1));
+    if (manager == NULL || order == NULL) {
+        free(order);
+        if (manager != NULL) {
+            freeManager(manager);
+        }
+        return;
+    }
+    unsigned int seed = 12345;
+    for (int i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    for (int i = count - 1; i > 0; i--) {
+        seed = seed * 1103515245u + 12345u;
+        int j = (int)((seed >> 8) % (unsigned int)(i + 1));
+        int temp = order[i];
+        order[i] = order[j];
+        order[j] = temp;
+    }
+    long long start = currentTimeMs();
+    addSyntheticStudents(manager, 0, count, order, 0, 0, NULL);
+    long long buildMs = currentTimeMs() - start;
+    free(order);
+    
+    // 查询取自中间学号：不同长度的前缀，以及约 1000 个与约 1% 学号的范围
+    int middle = count / 2;
+    char prefixes[3][20], lows[2][20], highs[2][20];
+    sprintf(prefixes[0], "S%09d", middle);
+    prefixes[0][8] = '\0';
+    sprintf(prefixes[1], "S%09d", middle);
+    prefixes[1][7] = '\0';
+    sprintf(prefixes[2], "S%09d", middle);
+    prefixes[2][6] = '\0';
+    sprintf(lows[0], "S%09d", middle);
+    sprintf(highs[0], "S%09d", middle + 999);
+    sprintf(lows[1], "S%09d", middle);
+    sprintf(highs[1], "S%09d", middle + count / 100);
+    
+    start = currentTimeMs();
+    idOrderPrepare(manager);
+    long long prepareMs = currentTimeMs() - start;
+    printf("学生数量\t%d\n", manager->count);
+    printf("建立索引（随添加）\t%lld ms\n", buildMs);
+    printf("首次查询前排序归并\t%lld ms\n", prepareMs);
+    printf("查询                          匹配数    扫描(ms)    索引(ms)\n");
+    for (int q = 0; q < 5; q++) {
+        const char *low = q < 3 ? prefixes[q] : lows[q - 3];
+        const char *high = q < 3 ? NULL : highs[q - 3];
+        size_t length = strlen(low);
+        int scanMatches = 0, indexMatches = 0;
+        start = currentTimeMs();
+        for (int i = 0; i < manager->count; i++) {
+            const char *id = getStudent(manager, i)->id;
+            scanMatches += high == NULL ? strncmp(id, low, length) == 0
+                                        : strcmp(id, low) >= 0 && strcmp(id, high) <= 0;
+        }
+        long long scanMs = currentTimeMs() - start;
+        int rounds = 100;
+        start = currentTimeMs();
+        for (int r = 0; r < rounds; r++) {
+            free(high == NULL ? findStudentsByIdPrefix(manager, low, &indexMatches)
+                              : findStudentsByIdRange(manager, low, high, &indexMatches));
+        }
+        double indexMs = (double)(currentTimeMs() - start) / rounds;
+        char label[48];
+        if (high == NULL) {
+            snprintf(label, sizeof(label), "前缀 %s", low);
+        } else {
+            snprintf(label, sizeof(label), "%s~%s", low, high);
+        }
+        printf("%-28s %9d %11lld %11.3f\n", label, scanMatches, scanMs, indexMs);
+    }
+    freeManager(manager);
+}
+
+// 排行性能测试：count 名随机成绩的学生，对比全表扫描与排行树的前50名、名次查询耗时，并测试修改成绩后的维护开销
+void benchmarkRank(int count) {
+    StudentManager *manager = initManager(count);
+    if (manager == NULL) {
+        return;
+    }
+    unsigned int seed = 12345;
+    float scores[3];
+    addSyntheticStudents(manager, 0, count, NULL, 3, 0, &seed);
+    
+    long long start = currentTimeMs();
+    RankTree *tree = rankTreeFor(manager, RANK_SCOPE_ALL, -1);
+    long long buildMs = currentTimeMs() - start;
+    if (tree == NULL) {
+        freeManager(manager);
+        return;
+    }
+    printf("学生数量\t%d\n", manager->count);
+    printf("建立排行\t%lld ms\n", buildMs);
+    
+    // 前50名：扫描时维护一个按总分降序的小数组
+    int top[50], topCount = 0;
+    start = currentTimeMs();
+    for (int i = 0; i < manager->count; i++) {
+        int key = rankKey(getStudent(manager, i));
+        int pos = topCount;
+        while (pos > 0 && rankKey(getStudent(manager, top[pos - 1])) < key) {
+            pos--;
+        }
+        if (pos >= 50) {
+            continue;
+        }
+        memmove(top + pos + 1, top + pos, sizeof(int) * (size_t)((topCount < 50 ? topCount : 49) - pos));
+        top[pos] = i;
+        if (topCount < 50) {
+            topCount++;
+        }
+    }
+    long long scanMs = currentTimeMs() - start;
+    int rounds = 1000, indexCount = 0;
+    start = currentTimeMs();
+    for (int r = 0; r < rounds; r++) {
+        free(rankTopStudents(manager, RANK_SCOPE_ALL, -1, 50, &indexCount));
+    }
+    printf("前50名\t扫描 %lld ms，排行树 %.2f 微秒，最高总分 %.2f\n", scanMs, (currentTimeMs() - start) * 1000.0 / rounds,
+           topCount > 0 ? studentTotal(getStudent(manager, top[0])) : 0.0);
+    
+    // 名次查询：扫描统计总分更高的人数
+    int queries = 100, rank, total;
+    double percentile;
+    long long rankSum = 0;
+    long long scanTotal = 0, indexTotal = 0;
+    for (int q = 0; q < queries; q++) {
+        seed = seed * 1103515245u + 12345u;
+        int index = (int)((seed >> 8) % (unsigned int)manager->count);
+        int key = rankKey(getStudent(manager, index));
+        start = currentTimeMs();
+        int above = 0;
+        for (int i = 0; i < manager->count; i++) {
+            above += rankKey(getStudent(manager, i)) > key;
+        }
+        scanTotal += currentTimeMs() - start;
+        start = currentTimeMs();
+        for (int r = 0; r < rounds; r++) {
+            rankOfStudent(manager, RANK_SCOPE_ALL, -1, index, &rank, &total, &percentile);
+        }
+        indexTotal += currentTimeMs() - start;
+        rankSum += above + 1;
+    }
+    printf("名次查询\t扫描 %.3f ms，排行树 %.2f 微秒，平均名次 %.0f\n", (double)scanTotal / queries,
+           indexTotal * 1000.0 / queries / rounds, (double)rankSum / queries);
+    
+    // 修改成绩：移出排行、改成绩、放回
+    int updates = 100000;
+    start = currentTimeMs();
+    for (int u = 0; u < updates; u++) {
+        seed = seed * 1103515245u + 12345u;
+        int index = (int)((seed >> 8) % (unsigned int)manager->count);
+        for (int j = 0; j < 3; j++) {
+            seed = seed * 1103515245u + 12345u;
+            scores[j] = (float)((seed >> 8) % 10001) / 100.0f;
+        }
+        rankUnindexStudent(manager, index);
+        setStudentScores(&manager->scorePool, getStudent(manager, index), scores, 3);
+        rankIndexStudent(manager, index);
+    }
+    long long updateMs = currentTimeMs() - start;
+    printf("修改成绩\t%d 次 %lld ms（每次 %.2f 微秒），排行人数 %d\n", updates, updateMs,
+           updateMs * 1000.0 / updates, rankSize(tree, tree->root));
+    freeManager(manager);
+}
+
+// 课程统计性能测试：count 个成绩（约2%缺考）组成一列，分别用逐个计算、SSE2、AVX2 版本统计，取5轮中最快的一轮
+void benchmarkCourseStats(int count) {
+    float *scores = (float *)malloc(sizeof(float) * (size_t)(count > 0 ? count : 1));
+    if (scores == NULL) {
+        printf("内存不足\n");
+        return;
+    }
+    unsigned int seed = 12345;
+    for (int i = 0; i < count; i++) {
+        seed = seed * 1103515245u + 12345u;
+        scores[i] = (seed >> 8) % 50 == 0 ? COLUMN_SCORE_MISSING : (float)((seed >> 8) % 10001) / 100.0f;
+    }
+    
+    static const char *names[] = {"逐个计算", "SSE2", "AVX2"};
+    CourseStats reference, stats;
+    courseStatsScalar(scores, count, &reference);
+    printf("成绩数量\t%d（有效 %d）\n", count, reference.count);
+    printf("平均分 %.4f，方差 %.4f，最低 %.2f，最高 %.2f，及格 %d\n", courseMean(&reference),
+           courseVariance(&reference), reference.min, reference.max, reference.passCount);
+    printf("版本          耗时(ms)        成绩/秒\n");
+    for (int level = 0; level <= courseStatsSimdLevel(); level++) {
+        double best = -1;
+        for (int round = 0; round < 5; round++) {
+            double start = currentTimeUs();
+            if (level == 0) {
+                courseStatsScalar(scores, count, &stats);
+            }
+#ifdef HAVE_SSE2
+            if (level == 1) {
+                courseStatsSse2(scores, count, &stats);
+            }
+#endif
+#ifdef HAVE_AVX2_TARGET
+            if (level == 2) {
+                courseStatsAvx2(scores, count, &stats);
+            }
+#endif
+            double ms = (currentTimeUs() - start) / 1000.0;
+            best = best < 0 || ms < best ? ms : best;
+        }
+        double relative = reference.sum != 0 ? (stats.sum - reference.sum) / reference.sum : 0;
+        int same = stats.count == reference.count && stats.passCount == reference.passCount &&
+                   stats.min == reference.min && stats.max == reference.max &&
+                   relative < 1e-12 && relative > -1e-12;
+        printf("%s%*s%10.2f %14.0f%s\n", names[level], 12 - utf8DisplayWidth(names[level]), "", best,
+               best > 0 ? count / best * 1000.0 : 0.0, same ? "" : "  结果不一致！");
+    }
+    free(scores);
+}
+
+// 成绩分布性能测试：count 名随机成绩的学生，对比排序求分位数与成绩分布查询的耗时，并测试修改成绩后的维护开销
+void benchmarkDistribution(int count) {
+    StudentManager *manager = initManager(count);
+    if (manager == NULL) {
+        return;
+    }
+    unsigned int seed = 12345;
+    float scores[3];
+    addSyntheticStudents(manager, 0, count, NULL, 3, 0, &seed);
+    
+    long long start = currentTimeMs();
+    ScoreHistogram *histogram = histogramFor(manager, -1);
+    long long buildMs = currentTimeMs() - start;
+    if (histogram == NULL) {
+        freeManager(manager);
+        return;
+    }
+    printf("学生数量\t%d\n", manager->count);
+    printf("建立成绩分布\t%lld ms\n", buildMs);
+    
+    // 对照：取出第1门成绩排序后按同样的最近秩法取分位数
+    int n = manager->count;
+    int *sorted = (int *)malloc(sizeof(int) * (size_t)(n > 0 ? n : 1));
+    if (sorted == NULL) {
+        freeManager(manager);
+        return;
+    }
+    start = currentTimeMs();
+    for (int i = 0; i < n; i++) {
+        sorted[i] = scoreToHundredths(studentScore(getStudent(manager, i), 0));
+    }
+    qsort(sorted, (size_t)n, sizeof(int), compareIndexes);
+    long long sortMs = currentTimeMs() - start;
+    
+    const double quantiles[3] = {0.5, 0.9, 0.99};
+    int values[3] = {0, 0, 0};
+    int rounds = 1000;
+    double queryStart = currentTimeUs();
+    for (int r = 0; r < rounds; r++) {
+        for (int q = 0; q < 3; q++) {
+            values[q] = histogramQuantile(histogram, 0, quantiles[q]);
+        }
+    }
+    double queryUs = (currentTimeUs() - queryStart) / rounds;
+    printf("中位数/P90/P99\t排序 %lld ms，成绩分布 %.1f 微秒（%d.%02d / %d.%02d / %d.%02d）\n", sortMs, queryUs,
+           values[0] / 100, values[0] % 100, values[1] / 100, values[1] % 100, values[2] / 100, values[2] % 100);
+    free(sorted);
+    
+    // 修改成绩：移出分布、改成绩、放回
+    int updates = 100000;
+    start = currentTimeMs();
+    for (int u = 0; u < updates && n > 0; u++) {
+        seed = seed * 1103515245u + 12345u;
+        int index = (int)((seed >> 8) % (unsigned int)n);
+        for (int j = 0; j < 3; j++) {
+            seed = seed * 1103515245u + 12345u;
+            scores[j] = (float)((seed >> 8) % 10001) / 100.0f;
+        }
+        histogramIndexStudent(manager, index, -1);
+        setStudentScores(&manager->scorePool, getStudent(manager, index), scores, 3);
+        histogramIndexStudent(manager, index, 1);
+    }
+    long long updateMs = currentTimeMs() - start;
+    printf("修改成绩\t%d 次 %lld ms，第1门人数 %d\n", updates, updateMs, histogram->totals[0]);
+    freeManager(manager);
+}
+
+// 毕业批量删除测试：count 名学生（每人12门成绩）中毕业的4个班（约十分之一）离校。
+// 逐个删除每次都要移动其后的全部学生并改写索引，只测少量后按人数折算；
+// 批量删除先逐个标记，再统一压缩一次，总耗时与学生总数成线性。最后核对各索引并测试新生复用成绩池
+void benchmarkGraduation(int count) {
+    StudentManager *manager = initManager(count);
+    if (manager == NULL) {
+        return;
+    }
+    unsigned int seed = 12345;
+    long long start = currentTimeMs();
+    addSyntheticStudents(manager, 0, count, NULL, 12, 0, &seed);
+    long long buildMs = currentTimeMs() - start;
+    int n = manager->count;
+    
+    // 先建立排行、成绩分布和学号有序索引，删除时一并维护
+    rankTreeFor(manager, RANK_SCOPE_ALL, 0);
+    histogramFor(manager, -1);
+    idOrderPrepare(manager);
+    size_t liveBefore = manager->scorePool.liveBytes;
+    printf("学生数量\t%d（建立 %lld ms）\n", n, buildMs);
+    
+    // 逐个删除：40班的前若干名学生
+    int sample = 0;
+    char id[20];
+    start = currentTimeMs();
+    for (int k = 0; k < 100 && 39 + 40 * k < n; k++) {
+        sprintf(id, "S%09d", 39 + 40 * k);
+        int index = findStudentById(manager, id);
+        if (index != -1 && removeStudentAt(manager, index)) {
+            sample++;
+        }
+    }
+    double singleMs = sample > 0 ? (double)(currentTimeMs() - start) / sample : 0;
+    
+    // 批量删除：1班~4班全部毕业
+    int graduates = 0;
+    start = currentTimeMs();
+    for (int c = 1; c <= 4; c++) {
+        char className[CLASS_NAME_SIZE];
+        sprintf(className, "%d班", c);
+        int matched;
+        int *indexes = filterStudents(manager, NULL, NULL, className, &matched);
+        for (int i = 0; i < matched; i++) {
+            graduates += markStudentDeleted(manager, indexes[i]) == 1;
+        }
+        free(indexes);
+    }
+    long long markMs = currentTimeMs() - start;
+    start = currentTimeMs();
+    compactStudents(manager);
+    long long compactMs = currentTimeMs() - start;
+    printf("逐个删除\t%d 人，平均每人 %.2f ms，折算 %d 人约 %.0f ms\n", sample, singleMs, graduates, singleMs * graduates);
+    printf("批量删除\t%d 人：标记 %lld ms，压缩 %lld ms，共 %lld ms\n", graduates, markMs, compactMs, markMs + compactMs);
+    
+    // 核对：人数、学号索引、班级倒排、学号有序索引、排行与成绩分布
+    int errors = 0;
+    int expected = n - sample - graduates;
+    errors += manager->count != expected;
+    for (int i = 0; i < manager->count; i++) {
+        errors += atoi(getStudent(manager, i)->id + 1) % 40 < 4;
+    }
+    int matched;
+    free(filterStudents(manager, NULL, NULL, "1班", &matched));
+    errors += matched != 0;
+    free(filterStudents(manager, NULL, NULL, "5班", &matched));
+    errors += matched != (n + 35) / 40;
+    errors += checkStudentIndexes(manager);
+    printf("剩余学生\t%d，索引核对%s\n", manager->count, errors == 0 ? "一致" : "不一致！");
+    printf("成绩池使用\t删除前 %zu KB，删除后 %zu KB\n", liveBefore / 1024, manager->scorePool.liveBytes / 1024);
+    
+    // 新生入学：成绩从空闲链表复用，不再向系统申请
+    long long systemAllocs = manager->scorePool.systemAllocs;
+    addSyntheticStudents(manager, n, graduates, NULL, 12, 0, &seed);
+    printf("新生入学\t%d 人，成绩池新增系统分配 %lld 次\n", graduates, manager->scorePool.systemAllocs - systemAllocs);
+    freeManager(manager);
+}
+
+// 成绩表合并测试：count 名学生（各有3门成绩），生成一份打乱顺序的“学号,成绩”表（临时文件），
+// 先作为第4门课程合并（追加），再合并一次（原位修改），最后核对成绩与增量维护的总分
+void benchmarkMergeScores(int count) {
+    StudentManager *manager = initManager(count);
+    int *order = (int *)malloc(sizeof(int) * (size_t)(count > 0 ? count : 1));
+    FILE *sheet = tmpfile();
+    if (manager == NULL || order == NULL || sheet == NULL) {
+        free(order);
+        if (sheet != NULL) {
+            fclose(sheet);
+        }
+        if (manager != NULL) {
+            freeManager(manager);
+        }
+        return;
+    }
+    addSyntheticStudents(manager, 0, count, NULL, 0, 0, NULL);
+    int n = manager->count;
+    unsigned int seed = 12345;
+    for (int i = 0; i < n; i++) {
+        order[i] = i;
+    }
+    for (int i = n - 1; i > 0; i--) {
+        seed = seed * 1103515245u + 12345u;
+        int j = (int)((seed >> 8) % (unsigned int)(i + 1));
+        int temp = order[i];
+        order[i] = order[j];
+        order[j] = temp;
+    }
+    fprintf(sheet, "学号,成绩\n");
+    for (int i = 0; i < n; i++) {
+        int hundredths = order[i] * 37 % 10001;
+        fprintf(sheet, "S%09d,%d.%02d\n", order[i], hundredths / 100, hundredths % 100);
+    }
+    long sheetBytes = ftell(sheet);
+    free(order);
+    printf("学生数量\t%d，成绩表 %ld KB\n", n, sheetBytes / 1024);
+    
+    const char *passes[2] = {"合并为新课程（追加）", "再次合并（原位修改）"};
+    for (int pass = 0; pass < 2; pass++) {
+        ImportStats stats;
+        rewind(sheet);
+        if (!mergeCourseFile(manager, sheet, 3, NULL, &stats)) {
+            break;
+        }
+        printf("%s\t%lld 行 %.0f ms，%.2f 百万行/秒，拒绝 %lld 行\n", passes[pass], stats.rows, stats.seconds * 1000,
+               stats.seconds > 0 ? stats.rows / stats.seconds / 1e6 : 0.0, stats.rejected);
+    }
+    fclose(sheet);
+    
+    // 核对：第4门成绩与总分（总分按差值增量维护，与重新求和比较）
+    int errors = 0;
+    float scores[4];
+    for (int i = 0; i < n; i++) {
+        const Student *s = getStudent(manager, i);
+        if (s->scoreCount != 4) {
+            errors++;
+            continue;
+        }
+        copyStudentScores(s, scores);
+        double drift = studentTotal(s) - ((double)scores[0] + scores[1] + scores[2] + scores[3]);
+        errors += scoreToHundredths(scores[3]) != i * 37 % 10001 || drift < -0.005 || drift > 0.005;
+    }
+    printf("成绩与总分核对\t%s\n", errors == 0 ? "一致" : "不一致！");
+    freeManager(manager);
+}
+
+// 显示批处理模式用法
+void printBatchUsage() {
+    printf("用法: sims [--fixed-scores] [命令] [参数]\n");
+    printf("不带命令时进入交互菜单。\n");
+    printf("--fixed-scores 以16位定点（百分之一分）存储成绩，内存减半且总分精确；数据文件格式不变。\n\n");
+    printf("  import <文件> [--report <拒绝报告>] [--jobs <线程数>]\n");
+    printf("                          批量导入 CSV/TSV（姓名,性别,学号,班级,院系,专业,成绩...）\n");
+    printf("  query --id <学号>       按学号查询\n");
+    printf("  query --name <姓名>     按姓名查询（列出全部包含该文本的学生，完全相同的在前）\n");
+    printf("  query --pinyin <拼音>   按全拼或首字母前缀查询（如 zhangsan、zs）\n");
+    printf("  query --id-prefix <前缀>\n");
+    printf("                          按学号前缀查询（按学号排序输出）\n");
+    printf("  query --id-range <起> <止>\n");
+    printf("                          按学号范围查询（含两端，按学号排序输出）\n");
+    printf("  list [--major <专业>] [--department <院系>] [--class <班级>]\n");
+    printf("                          按条件组合筛选并列出学生\n");
+    printf("  rank [--top <N> | --id <学号>] [--major <专业> | --class <班级>]\n");
+    printf("                          总分排行：前N名（默认50），或某学号的名次与百分位\n");
+    printf("  courses [--major <专业>] [--department <院系>] [--class <班级>]\n");
+    printf("                          各门课程的平均分、方差、最低最高分和及格率\n");
+    printf("  dist [--major <专业>] [--course <成绩名或序号>]\n");
+    printf("                          成绩分布：中位数、P90、P99和每10分一段的直方图\n");
+    printf("  bulk delete --class <班级> [--yes]\n");
+    printf("                          删除整个班级（先显示人数，不带 --yes 时需确认）\n");
+    printf("  bulk move-major --from <原专业> --to <新专业> [--yes]\n");
+    printf("                          专业整体转入另一专业\n");
+    printf("  bulk add-score --class <班级> --course <成绩名或序号> --points <分数> [--yes]\n");
+    printf("                          给班级的一门课程加分（可为负数，超出0~100分的按边界计）\n");
+    printf("  merge-scores <文件> --course <成绩名或序号> [--report <拒绝报告>]\n");
+    printf("                          按学号合并一门课程的成绩表（学号,成绩），没有这门成绩的学生追加一门\n");
+    printf("  preset add [--department <院系>] [--major <专业>] [--score <成绩名>] ...\n");
+    printf("                          添加预设（选项可重复；已存在的跳过），导入前须先登记院系和专业\n");
+    printf("  preset clear [--department] [--major] [--score]\n");
+    printf("                          清除指定种类的全部预设\n");
+    printf("  preset list             列出全部预设\n");
+    printf("  export [<文件>] [--format csv|ndjson] [--major <专业>] [--department <院系>] [--class <班级>]\n");
+    printf("                          流式导出学生为 CSV 或 NDJSON（默认输出到标准输出，.ndjson/.jsonl 文件默认 NDJSON）\n");
+    printf("  stats                   显示统计信息\n");
+    printf("  bench index [最大记录数]  学号哈希索引性能测试\n");
+    printf("  bench names [学生数量]    姓名字元索引查找性能测试\n");
+    printf("  bench pinyin [学生数量]   拼音前缀索引查找性能测试\n");
+    printf("  bench idrange [学生数量]  学号有序索引前缀/范围查找性能测试\n");
+    printf("  bench rank [学生数量]     总分排行前N名与名次查询性能测试\n");
+    printf("  bench courses [成绩数量]  课程统计（逐个计算、SSE2、AVX2）性能测试\n");
+    printf("  bench dist [学生数量]     成绩分布分位数查询与维护性能测试\n");
+    printf("  bench graduate [学生数量] 毕业批量删除（逐个删除与标记后统一压缩对比）性能测试\n");
+    printf("  bench merge [学生数量]    成绩表按学号合并性能测试\n");
+    printf("  bench stress [插入数量]   学生存储压力测试\n");
+    printf("  bench render [学生数量]   列表渲染性能测试（输出到空设备）\n");
+    printf("  bench export [学生数量]   CSV/NDJSON 流式导出性能测试（输出到空设备）\n");
+    printf("  bench dict [学生数量]     名称字典内存测试\n");
+    printf("  bench columns [学生数量]  行式与列式布局扫描性能对比\n");
+    printf("  bench scores [学生数量]   成绩池分配次数与碎片报告\n");
+    printf("  bench inline [学生数量]   记录内成绩与单独成绩数组的遍历性能对比\n");
+    printf("  selftest                成绩存储往返自检（浮点与定点两种模式）\n");
+    printf("  help                    显示本帮助\n");
+}
+
+// 批处理命令：批量导入
+int batchImport(StudentManager *manager, int argc, char *argv[]) {
+    if (argc < 1) {
+        fprintf(stderr, "缺少导入文件\n");
+        return 2;
+    }
+    const char *path = argv[0];
+    const char *reportPath = NULL;
+    int threadCount = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+            reportPath = argv[++i];
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            threadCount = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "未知参数 %s\n", argv[i]);
+            return 2;
+        }
+    }
+    
+    // 未指定线程数时，大文件按CPU核心数并行解析
+    if (threadCount <= 0) {
+        MappedFile probe;
+        size_t fileSize = 0;
+        if (mapFile(path, &probe)) {
+            fileSize = probe.size;
+            unmapFile(&probe);
+        }
+        threadCount = fileSize >= IMPORT_PARALLEL_MIN ? getCpuCount() : 1;
+    }
+    
+    ImportStats stats;
+    int ok = threadCount > 1 ? importStudentsParallel(manager, path, reportPath, threadCount, &stats)
+                             : importStudents(manager, path, reportPath, &stats);
+    if (!ok) {
+        fprintf(stderr, "无法打开文件 %s\n", path);
+        return 1;
+    }
+    if (stats.imported > 0 && !saveBulkChanges(manager)) {
+        fprintf(stderr, "无法写入数据文件 %s，导入的 %lld 行未保存\n", SNAPSHOT_FILE, stats.imported);
+        return 1;
+    }
+    printf("共 %lld 行，导入 %lld 行，拒绝 %lld 行，耗时 %.2f 秒（%.0f 行/秒）\n",
+           stats.rows, stats.imported, stats.rejected, stats.seconds,
+           stats.seconds > 0 ? stats.rows / stats.seconds : 0.0);
+    return stats.rejected > 0 ? 3 : 0;
+}
+
+// 批处理命令：查询
+int batchQuery(StudentManager *manager, int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "用法: sims query --id <学号> | --name <姓名> | --pinyin <拼音>"
+                        " | --id-prefix <前缀> | --id-range <起> <止>\n");
+        return 2;
+    }
+    int index = -1;
+    if (strcmp(argv[0], "--id") == 0) {
+        index = findStudentById(manager, argv[1]);
+    } else if (strcmp(argv[0], "--name") == 0 || strcmp(argv[0], "--pinyin") == 0 ||
+               strcmp(argv[0], "--id-prefix") == 0 || strcmp(argv[0], "--id-range") == 0) {
+        // 按姓名输出全部匹配的学生（姓名完全相同的在前），或按拼音前缀输出候选学生，
+        // 或按学号前缀/范围输出（按学号排序）
+        int count;
+        int *matches;
+        if (strcmp(argv[0], "--name") == 0) {
+            matches = findStudentsByName(manager, argv[1], &count);
+        } else if (strcmp(argv[0], "--pinyin") == 0) {
+            matches = findStudentsByPinyin(manager, argv[1], &count);
+        } else if (strcmp(argv[0], "--id-prefix") == 0) {
+            matches = findStudentsByIdPrefix(manager, argv[1], &count);
+        } else if (argc < 3) {
+            fprintf(stderr, "用法: sims query --id-range <起始学号> <结束学号>\n");
+            return 2;
+        } else {
+            matches = findStudentsByIdRange(manager, argv[1], argv[2], &count);
+        }
+        if (matches == NULL) {
+            fprintf(stderr, "内存不足\n");
+            return 1;
+        }
+        for (int i = 0; i < count; i++) {
+            printStudentLine(stdout, manager, getStudent(manager, matches[i]));
+        }
+        free(matches);
+        if (count == 0) {
+            fprintf(stderr, "未找到该学生信息\n");
+            return 1;
+        }
+        return 0;
+    } else {
+        fprintf(stderr, "未知参数 %s\n", argv[0]);
+        return 2;
+    }
+    if (index == -1) {
+        fprintf(stderr, "未找到该学生信息\n");
+        return 1;
+    }
+    printStudentLine(stdout, manager, getStudent(manager, index));
+    return 0;
+}
+
+// 批处理命令：导出为 CSV（列顺序与导入一致，可直接重新导入）
+// 把一个字段按 CSV 规则写入缓冲区，规则与 writeCsvField 相同
+void outputCsvField(OutputBuffer *out, const char *text) {
+    if (strpbrk(text, ",\"\r\n") == NULL) {
+        outputString(out, text);
+        return;
+    }
+    outputAppend(out, "\"", 1);
+    const char *quote;
+    while ((quote = strchr(text, '"')) != NULL) {
+        outputAppend(out, text, (size_t)(quote - text + 1));
+        outputAppend(out, "\"", 1);
+        text = quote + 1;
+    }
+    outputString(out, text);
+    outputAppend(out, "\"", 1);
+}
+
+// 把字符串写成 JSON 字符串字面量，UTF-8 字符原样保留，只转义引号、反斜杠和控制字符
+void outputJsonString(OutputBuffer *out, const char *text) {
+    outputAppend(out, "\"", 1);
+    const char *start = text;
+    for (const char *p = text; *p != '\0'; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        outputAppend(out, start, (size_t)(p - start));
+        char escape[8];
+        if (c == '"' || c == '\\') {
+            escape[0] = '\\';
+            escape[1] = (char)c;
+            outputAppend(out, escape, 2);
+        } else {
+            outputAppend(out, escape, (size_t)snprintf(escape, sizeof(escape), "\\u%04x", c));
+        }
+        start = p + 1;
+    }
+    outputString(out, start);
+    outputAppend(out, "\"", 1);
+}
+
+// 按 printf("%g") 的格式写出成绩。最多两位小数的成绩（定点模式下全部如此）直接拼接数字，
+// 这时 float 与两位小数的十进制值相差不到百万分之一，%g 取6位有效数字得到的正是这个十进制值
+void outputScore(OutputBuffer *out, float score) {
+    if (score > 0.0f && score < 10000.0f) {
+        int hundredths = (int)((double)score * 100 + 0.5);
+        if ((float)hundredths / 100.0f == score) {
+            outputInt(out, hundredths / 100);
+            int fraction = hundredths % 100;
+            if (fraction != 0) {
+                char text[3] = {'.', (char)('0' + fraction / 10), (char)('0' + fraction % 10)};
+                outputAppend(out, text, fraction % 10 != 0 ? 3 : 2);
+            }
+            return;
+        }
+    }
+    char text[32];
+    outputAppend(out, text, (size_t)snprintf(text, sizeof(text), "%g", score));
+}
+
+// 写出表头：CSV 为列名行，成绩列共 scoreColumns 列（超出成绩名预设的列名见 courseName），
+// NDJSON 每行自带字段名，没有表头
+void exportHeader(OutputBuffer *out, StudentManager *manager, int format, int scoreColumns) {
+    if (format != EXPORT_CSV) {
+        return;
+    }
+    char nameBuffer[32];
+    outputString(out, "姓名,性别,学号,班级,院系,专业");
+    for (int j = 0; j < scoreColumns; j++) {
+        outputAppend(out, ",", 1);
+        outputCsvField(out, courseName(manager, j, nameBuffer, sizeof(nameBuffer)));
+    }
+    outputAppend(out, "\n", 1);
+}
+
+// 学生是否导出：未删除，且符合 ids 中指定的专业/院系/班级编号（-1 表示不限）
+int exportRowMatches(const Student *student, const int *ids) {
+    return !student->deleted &&
+           (ids[0] == -1 || student->majorId == ids[0]) &&
+           (ids[1] == -1 || student->departmentId == ids[1]) &&
+           (ids[2] == -1 || student->classId == ids[2]);
+}
+
+// 保证 NDJSON 的成绩键至少有 count 个：每个键是转义后的成绩名加冒号，只生成一次。内存不足返回0
+int exportReserveKeys(StudentManager *manager, char ***keys, int *keyCount, int count) {
+    if (count <= *keyCount) {
+        return 1;
+    }
+    char **newKeys = (char **)realloc(*keys, sizeof(char *) * (size_t)count);
+    if (newKeys == NULL) {
+        return 0;
+    }
+    *keys = newKeys;
+    char nameBuffer[32];
+    while (*keyCount < count) {
+        const char *name = courseName(manager, *keyCount, nameBuffer, sizeof(nameBuffer));
+        size_t capacity = strlen(name) * 6 + 4;
+        OutputBuffer key = {(char *)malloc(capacity), 0, capacity, -1, 0};
+        if (key.data == NULL) {
+            return 0;
+        }
+        outputJsonString(&key, name);
+        outputAppend(&key, ":", 2); // 连同结尾的 '\0'
+        newKeys[(*keyCount)++] = key.data;
+    }
+    return 1;
+}
+
+// 写出一名学生：courseKeys 为NULL时写 CSV 一行，否则写 NDJSON 一个对象（成绩以成绩名为键，另附总分）
+void exportStudentRow(OutputBuffer *out, StudentManager *manager, const Student *student, char **courseKeys) {
+    const char *fields[IMPORT_FIXED_FIELDS] = {student->name, student->gender, student->id,
+                                               dictString(&manager->strings, student->classId),
+                                               dictString(&manager->strings, student->departmentId),
+                                               dictString(&manager->strings, student->majorId)};
+    if (courseKeys == NULL) {
+        for (int j = 0; j < IMPORT_FIXED_FIELDS; j++) {
+            if (j > 0) {
+                outputAppend(out, ",", 1);
+            }
+            outputCsvField(out, fields[j]);
+        }
+        for (int j = 0; j < student->scoreCount; j++) {
+            outputAppend(out, ",", 1);
+            outputScore(out, studentScore(student, j));
+        }
+        outputAppend(out, "\n", 1);
+        return;
+    }
+    
+    static const char *keys[IMPORT_FIXED_FIELDS] = {"{\"name\":", ",\"gender\":", ",\"id\":",
+                                                    ",\"class\":", ",\"department\":", ",\"major\":"};
+    for (int j = 0; j < IMPORT_FIXED_FIELDS; j++) {
+        outputString(out, keys[j]);
+        outputJsonString(out, fields[j]);
+    }
+    outputString(out, ",\"scores\":{");
+    for (int j = 0; j < student->scoreCount; j++) {
+        if (j > 0) {
+            outputAppend(out, ",", 1);
+        }
+        outputString(out, courseKeys[j]);
+        outputScore(out, studentScore(student, j));
+    }
+    outputString(out, "},\"total\":");
+    outputFixed2(out, studentTotal(student));
+    outputAppend(out, "}\n", 2);
+}
+
+// 流式导出学生，返回导出人数，内存不足返回-1。指定了专业/院系/班级时沿最短的倒排列表逐个核对其余条件，
+// 不建立中间结果，除输出缓冲区（最大 OUTPUT_BUFFER_MAX）和每门课程一个的成绩键外不随学生数量占用内存
+long long exportStudents(StudentManager *manager, OutputBuffer *out, int format,
+                         const char *major, const char *department, const char *className) {
+    const char *keys[3] = {major, department, className};
+    PostingIndex *indexes[3] = {&manager->majorIndex, &manager->departmentIndex, &manager->classIndex};
+    int ids[3] = {-1, -1, -1};
+    const PostingList *shortest = NULL;
+    for (int i = 0; i < 3; i++) {
+        if (keys[i] == NULL) {
+            continue;
+        }
+        ids[i] = dictLookup(&manager->strings, keys[i]);
+        const PostingList *list = postingFind(indexes[i], ids[i]);
+        if (list == NULL || list->count == 0) {
+            exportHeader(out, manager, format, manager->scoreNameCount);
+            return 0;
+        }
+        if (shortest == NULL || list->count < shortest->count) {
+            shortest = list;
+        }
+    }
+    
+    // CSV 每行的成绩数可能超过成绩名预设，表头的成绩列取导出学生中最多的成绩数（先扫一遍，只读成绩数）
+    int total = shortest != NULL ? shortest->count : manager->count;
+    int scoreColumns = manager->scoreNameCount;
+    for (int i = 0; i < total && format == EXPORT_CSV; i++) {
+        const Student *student = getStudent(manager, shortest != NULL ? shortest->items[i] : i);
+        if (student->scoreCount > scoreColumns && exportRowMatches(student, ids)) {
+            scoreColumns = student->scoreCount;
+        }
+    }
+    exportHeader(out, manager, format, scoreColumns);
+    
+    long long exported = 0;
+    char **courseKeys = NULL;
+    int keyCount = 0;
+    if (format == EXPORT_NDJSON && !exportReserveKeys(manager, &courseKeys, &keyCount, 1)) {
+        exported = -1;
+    }
+    for (int i = 0; i < total && exported != -1; i++) {
+        const Student *student = getStudent(manager, shortest != NULL ? shortest->items[i] : i);
+        if (!exportRowMatches(student, ids)) {
+            continue;
+        }
+        if (courseKeys != NULL && !exportReserveKeys(manager, &courseKeys, &keyCount, student->scoreCount)) {
+            exported = -1;
+            break;
+        }
+        exportStudentRow(out, manager, student, courseKeys);
+        exported++;
+    }
+    for (int j = 0; j < keyCount; j++) {
+        free(courseKeys[j]);
+    }
+    free(courseKeys);
+    return exported;
+}
+
+int batchExport(StudentManager *manager, int argc, char *argv[]) {
+    const char *path = NULL, *major = NULL, *department = NULL, *className = NULL;
+    int format = -1;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "csv") == 0) {
+                format = EXPORT_CSV;
+            } else if (strcmp(argv[i], "ndjson") == 0 || strcmp(argv[i], "jsonl") == 0) {
+                format = EXPORT_NDJSON;
+            } else {
+                fprintf(stderr, "未知导出格式 %s（可选 csv、ndjson）\n", argv[i]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--major") == 0 && i + 1 < argc) {
+            major = argv[++i];
+        } else if (strcmp(argv[i], "--department") == 0 && i + 1 < argc) {
+            department = argv[++i];
+        } else if (strcmp(argv[i], "--class") == 0 && i + 1 < argc) {
+            className = argv[++i];
+        } else if (path == NULL && strncmp(argv[i], "--", 2) != 0) {
+            path = argv[i];
+        } else {
+            fprintf(stderr, "未知参数 %s\n", argv[i]);
+            return 2;
+        }
+    }
+    // 未指定格式时按文件扩展名判断
+    if (format == -1) {
+        const char *dot = path != NULL ? strrchr(path, '.') : NULL;
+        format = dot != NULL && (strcmp(dot, ".ndjson") == 0 || strcmp(dot, ".jsonl") == 0) ? EXPORT_NDJSON : EXPORT_CSV;
+    }
+    
+    FILE *file = path != NULL ? fopen(path, "wb") : stdout;
+    if (file == NULL) {
+        fprintf(stderr, "无法写入文件 %s\n", path);
+        return 1;
+    }
+    fflush(stdout);
+#ifdef _WIN32
+    OutputBuffer out = {NULL, 0, 0, _fileno(file), 0};
+#else
+    OutputBuffer out = {NULL, 0, 0, fileno(file), 0};
+#endif
+    long long exported = exportStudents(manager, &out, format, major, department, className);
+    outputFlush(&out);
+    free(out.data);
+    int ok = !out.failed;
+    if (file != stdout) {
+        ok = fclose(file) == 0 && ok;
+    }
+    if (exported < 0) {
+        fprintf(stderr, "内存分配失败，导出不完整\n");
+        return 1;
+    }
+    if (!ok) {
+        fprintf(stderr, "写出失败%s%s\n", path != NULL ? "：" : "", path != NULL ? path : "");
+        return 1;
+    }
+    fprintf(stderr, "共导出 %lld 名学生\n", exported);
+    return 0;
+}
+
+// 导出性能测试：原有的逐字段 fprintf 方式与缓冲流式导出对比，输出到空设备以排除磁盘影响
+void benchmarkExport(int count) {
+#ifdef _WIN32
+    const char *nullDevice = "NUL";
+#else
+    const char *nullDevice = "/dev/null";
+#endif
+    StudentManager *manager = initManager(count);
+    if (manager == NULL) {
+        return;
+    }
+    addSyntheticStudents(manager, 0, count, NULL, 0, 0, NULL);
+    FILE *file = fopen(nullDevice, "wb");
+    if (file == NULL || manager->count == 0) {
+        if (file != NULL) {
+            fclose(file);
+        }
+        freeManager(manager);
+        return;
+    }
+    
+    // 原有方式：fprintf/fputc 逐字段写出
+    long long start = currentTimeMs();
+    for (int i = 0; i < manager->count; i++) {
+        const Student *row = getStudent(manager, i);
+        const char *fields[IMPORT_FIXED_FIELDS] = {row->name, row->gender, row->id,
+                                                   dictString(&manager->strings, row->classId),
+                                                   dictString(&manager->strings, row->departmentId),
+                                                   dictString(&manager->strings, row->majorId)};
+        for (int j = 0; j < IMPORT_FIXED_FIELDS; j++) {
+            if (j > 0) {
+                fputc(',', file);
+            }
+            writeCsvField(file, fields[j]);
+        }
+        for (int j = 0; j < row->scoreCount; j++) {
+            fprintf(file, ",%g", studentScore(row, j));
+        }
+        fputc('\n', file);
+    }
+    fflush(file);
+    long long printfMs = currentTimeMs() - start;
+    
+#ifdef _WIN32
+    OutputBuffer out = {NULL, 0, 0, _fileno(file), 0};
+#else
+    OutputBuffer out = {NULL, 0, 0, fileno(file), 0};
+#endif
+    const char *className = dictString(&manager->strings, getStudent(manager, 0)->classId);
+    const char *labels[3] = {"缓冲CSV", "缓冲NDJSON", "按班级CSV"};
+    long long elapsed[3], exported[3];
+    for (int k = 0; k < 3; k++) {
+        start = currentTimeMs();
+        exported[k] = exportStudents(manager, &out, k == 1 ? EXPORT_NDJSON : EXPORT_CSV, NULL, NULL, k == 2 ? className : NULL);
+        outputFlush(&out);
+        elapsed[k] = currentTimeMs() - start;
+    }
+    size_t bufferBytes = out.capacity;
+    free(out.data);
+    fclose(file);
+    
+    printf("导出性能测试：%d 名学生输出到 %s\n", manager->count, nullDevice);
+    printf("%-16s %10s %10s %14s\n", "方式", "行数", "耗时(ms)", "行/秒");
+    printf("%-16s %10d %10lld %14.0f\n", "逐字段fprintf", manager->count, printfMs,
+           printfMs > 0 ? manager->count * 1000.0 / printfMs : 0.0);
+    for (int k = 0; k < 3; k++) {
+        printf("%-16s %10lld %10lld %14.0f\n", labels[k], exported[k], elapsed[k],
+               elapsed[k] > 0 ? exported[k] * 1000.0 / elapsed[k] : 0.0);
+    }
+    printf("输出缓冲区 %.1f MB（上限 %d MB，与学生数量无关）\n", bufferBytes / (1024.0 * 1024.0), OUTPUT_BUFFER_MAX / (1024 * 1024));
+    freeManager(manager);
 }
 
-// 验证性别有效性
-int isValidGender(const char *gender) {
-    // 支持多种输入方式避免编码问题
-    return (strcmp(gender, "男") == 0 || 
-            strcmp(gender, "女") == 0 || 
-            strcmp(gender, "1") == 0 || 
-            strcmp(gender, "0") == 0 || 
-            strcmp(gender, "male") == 0 || 
-            strcmp(gender, "female") == 0 || 
-            strcmp(gender, "M") == 0 || 
-            strcmp(gender, "F") == 0);
+// 批处理命令：按专业、院系、班级组合筛选并列出学生
+int batchList(StudentManager *manager, int argc, char *argv[]) {
+    const char *major = NULL, *department = NULL, *className = NULL;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--major") == 0 && i + 1 < argc) {
+            major = argv[++i];
+        } else if (strcmp(argv[i], "--department") == 0 && i + 1 < argc) {
+            department = argv[++i];
+        } else if (strcmp(argv[i], "--class") == 0 && i + 1 < argc) {
+            className = argv[++i];
+        } else {
+            fprintf(stderr, "未知参数 %s\n", argv[i]);
+            return 2;
+        }
+    }
+    
+    int count;
+    int *indexes = filterStudents(manager, major, department, className, &count);
+    if (count < 0) {
+        fprintf(stderr, "内存分配失败\n");
+        return 1;
+    }
+    for (int i = 0; i < count; i++) {
+        printStudentLine(stdout, manager, getStudent(manager, indexes != NULL ? indexes[i] : i));
+    }
+    fprintf(stderr, "共 %d 名学生\n", count);
+    free(indexes);
+    return 0;
 }
 
-// 验证学号有效性
-int isValidId(const char *id) {
-    if (isEmptyString(id)) return 0;
+// 批处理命令：总分排行（前N名，或某学号的名次与百分位），可限定专业或班级
+int batchRank(StudentManager *manager, int argc, char *argv[]) {
+    const char *id = NULL, *major = NULL, *className = NULL;
+    int limit = 50;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            limit = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--id") == 0 && i + 1 < argc) {
+            id = argv[++i];
+        } else if (strcmp(argv[i], "--major") == 0 && i + 1 < argc) {
+            major = argv[++i];
+        } else if (strcmp(argv[i], "--class") == 0 && i + 1 < argc) {
+            className = argv[++i];
+        } else {
+            fprintf(stderr, "未知参数 %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (major != NULL && className != NULL) {
+        fprintf(stderr, "--major 与 --class 只能指定一个\n");
+        return 2;
+    }
     
-    // 验证长度（学号长度应在合理范围内）
-    int len = strlen(id);
-    if (len < 4 || len > 20) {
+    int scope = major != NULL ? RANK_SCOPE_MAJOR : (className != NULL ? RANK_SCOPE_CLASS : RANK_SCOPE_ALL);
+    int scopeId = -1;
+    if (scope != RANK_SCOPE_ALL) {
+        scopeId = dictLookup(&manager->strings, major != NULL ? major : className);
+        if (scopeId == -1) {
+            fprintf(stderr, "没有%s %s 的学生\n", major != NULL ? "专业" : "班级", major != NULL ? major : className);
+            return 1;
+        }
+    }
+    
+    if (id != NULL) {
+        int index = findStudentById(manager, id);
+        int rank, total;
+        double percentile;
+        if (index == -1) {
+            fprintf(stderr, "未找到该学生信息\n");
+            return 1;
+        }
+        if (!rankOfStudent(manager, scope, scopeId, index, &rank, &total, &percentile)) {
+            fprintf(stderr, "该学生不在指定范围内\n");
+            return 1;
+        }
+        printStudentLine(stdout, manager, getStudent(manager, index));
+        printf("名次\t%d/%d\n", rank, total);
+        printf("百分位\t%.1f\n", percentile);
         return 0;
     }
     
-    // 验证字符：只允许数字和字母
-    for (int i = 0; id[i] != '\0'; i++) {
-        if (!((id[i] >= '0' && id[i] <= '9') || 
-              (id[i] >= 'a' && id[i] <= 'z') || 
-              (id[i] >= 'A' && id[i] <= 'Z'))) {
-            return 0;
+    // 输出名次（同分同名次）和学生信息
+    int count;
+    int *top = rankTopStudents(manager, scope, scopeId, limit, &count);
+    if (top == NULL) {
+        fprintf(stderr, "内存分配失败\n");
+        return 1;
+    }
+    int rank = 0;
+    for (int i = 0; i < count; i++) {
+        const Student *student = getStudent(manager, top[i]);
+        if (i == 0 || rankKey(student) != rankKey(getStudent(manager, top[i - 1]))) {
+            rank = i + 1;
         }
+        printf("%d\t", rank);
+        printStudentLine(stdout, manager, student);
     }
-    return 1;
+    free(top);
+    return 0;
 }
 
-// 验证姓名有效性
-int isValidName(const char *name) {
-    if (isEmptyString(name)) return 0;
+// 批处理命令：各门课程的统计（平均分、方差、最低最高分、及格率），可按专业、院系、班级筛选
+int batchCourses(StudentManager *manager, int argc, char *argv[]) {
+    const char *major = NULL, *department = NULL, *className = NULL;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--major") == 0 && i + 1 < argc) {
+            major = argv[++i];
+        } else if (strcmp(argv[i], "--department") == 0 && i + 1 < argc) {
+            department = argv[++i];
+        } else if (strcmp(argv[i], "--class") == 0 && i + 1 < argc) {
+            className = argv[++i];
+        } else {
+            fprintf(stderr, "未知参数 %s\n", argv[i]);
+            return 2;
+        }
+    }
     
-    // 验证长度
-    int len = strlen(name);
-    if (len < 1 || len > 20) {
+    int count, courses;
+    int *indexes = filterStudents(manager, major, department, className, &count);
+    CourseStats *stats = count < 0 ? NULL : computeCourseStats(manager, indexes, count, &courses);
+    free(indexes);
+    if (stats == NULL) {
+        fprintf(stderr, "内存分配失败\n");
+        return 1;
+    }
+    printf("课程\t人数\t平均分\t方差\t最低分\t最高分\t及格率\n");
+    for (int j = 0; j < courses; j++) {
+        char buffer[32];
+        printf("%s\t%d\t%.2f\t%.2f\t%.2f\t%.2f\t%.1f%%\n", courseName(manager, j, buffer, sizeof(buffer)),
+               stats[j].count, courseMean(&stats[j]), courseVariance(&stats[j]), stats[j].min, stats[j].max,
+               stats[j].count > 0 ? stats[j].passCount * 100.0 / stats[j].count : 0.0);
+    }
+    fprintf(stderr, "共 %d 名学生\n", count);
+    free(stats);
+    return 0;
+}
+
+// 批处理命令：成绩分布（中位数、P90、P99和分段直方图），可限定专业和课程
+int batchDistribution(StudentManager *manager, int argc, char *argv[]) {
+    const char *major = NULL, *course = NULL;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--major") == 0 && i + 1 < argc) {
+            major = argv[++i];
+        } else if (strcmp(argv[i], "--course") == 0 && i + 1 < argc) {
+            course = argv[++i];
+        } else {
+            fprintf(stderr, "未知参数 %s\n", argv[i]);
+            return 2;
+        }
+    }
+    
+    int majorId = -1;
+    if (major != NULL) {
+        majorId = dictLookup(&manager->strings, major);
+        if (majorId == -1) {
+            fprintf(stderr, "没有专业 %s 的学生\n", major);
+            return 1;
+        }
+    }
+    ScoreHistogram *histogram = histogramFor(manager, majorId);
+    if (histogram == NULL) {
+        fprintf(stderr, "内存分配失败\n");
+        return 1;
+    }
+    
+    // 课程可以用成绩名或从1开始的序号指定
+    int printed = 0;
+    for (int j = 0; j < histogram->courseCount; j++) {
+        char buffer[32];
+        const char *name = courseName(manager, j, buffer, sizeof(buffer));
+        if (course != NULL && strcmp(course, name) != 0 && atoi(course) != j + 1) {
+            continue;
+        }
+        printScoreDistribution(histogram, j, name, "");
+        printed++;
+    }
+    if (printed == 0) {
+        fprintf(stderr, course != NULL ? "没有课程 %s\n" : "没有成绩\n", course);
+        return 1;
+    }
+    return 0;
+}
+
+// 批处理命令：批量删除、转专业、加分。先输出受影响的人数，不带 --yes 时从标准输入读取确认
+int batchBulk(StudentManager *manager, int argc, char *argv[]) {
+    const char *operation = argc > 0 ? argv[0] : "";
+    const char *className = NULL, *source = NULL, *target = NULL, *course = NULL, *points = NULL;
+    int yes = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--class") == 0 && i + 1 < argc) {
+            className = argv[++i];
+        } else if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) {
+            source = argv[++i];
+        } else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc) {
+            target = argv[++i];
+        } else if (strcmp(argv[i], "--course") == 0 && i + 1 < argc) {
+            course = argv[++i];
+        } else if (strcmp(argv[i], "--points") == 0 && i + 1 < argc) {
+            points = argv[++i];
+        } else if (strcmp(argv[i], "--yes") == 0) {
+            yes = 1;
+        } else {
+            fprintf(stderr, "未知参数 %s\n", argv[i]);
+            return 2;
+        }
+    }
+    
+    int isDelete = strcmp(operation, "delete") == 0 && className != NULL;
+    int isMove = strcmp(operation, "move-major") == 0 && source != NULL && target != NULL;
+    int isAdd = strcmp(operation, "add-score") == 0 && className != NULL && course != NULL && points != NULL;
+    if (!isDelete && !isMove && !isAdd) {
+        fprintf(stderr, "用法: sims bulk delete --class <班级> [--yes]\n"
+                        "      sims bulk move-major --from <原专业> --to <新专业> [--yes]\n"
+                        "      sims bulk add-score --class <班级> --course <成绩名或序号> --points <分数> [--yes]\n");
+        return 2;
+    }
+    
+    int *indexes = NULL;
+    int count = 0, courseIndex = -1, fromId = -1, toId = -1;
+    float delta = 0;
+    if (isMove) {
+        fromId = dictLookup(&manager->strings, source);
+        PostingList *list = fromId == -1 ? NULL : postingFind(&manager->majorIndex, fromId);
+        count = list == NULL ? 0 : list->count;
+        if (!isValidMajor(manager, target)) {
+            fprintf(stderr, "专业 %s 不在预设中\n", target);
+            return 1;
+        }
+        if (strcmp(source, target) == 0) {
+            fprintf(stderr, "原专业与新专业相同\n");
+            return 1;
+        }
+        toId = dictIntern(&manager->strings, target);
+    } else {
+        indexes = filterStudents(manager, NULL, NULL, className, &count);
+        if (indexes == NULL) {
+            fprintf(stderr, "内存分配失败\n");
+            return 1;
+        }
+    }
+    if (isAdd) {
+        courseIndex = findCourse(manager, course);
+        char *end;
+        delta = strtof(points, &end);
+        if (courseIndex == -1 || *end != '\0' || end == points || delta < -100.0f || delta > 100.0f) {
+            fprintf(stderr, courseIndex == -1 ? "没有课程 %s\n" : "分数 %s 无效\n", courseIndex == -1 ? course : points);
+            free(indexes);
+            return 1;
+        }
+    }
+    
+    fprintf(stderr, "%s %d 名学生", isDelete ? "将删除" : (isMove ? "将转专业" : "将加分"), count);
+    if (count > 0 && !yes) {
+        char answer[16];
+        fprintf(stderr, "，是否确认？(y/n): ");
+        if (fgets(answer, sizeof(answer), stdin) == NULL || (answer[0] != 'y' && answer[0] != 'Y')) {
+            fprintf(stderr, "已取消\n");
+            free(indexes);
+            return 1;
+        }
+    } else {
+        fprintf(stderr, "\n");
+    }
+    
+    int affected = 0;
+    if (count > 0) {
+        if (isDelete) {
+            affected = bulkDeleteStudents(manager, indexes, count);
+        } else if (isMove) {
+            affected = toId == -1 ? -1 : bulkMoveMajor(manager, fromId, toId);
+        } else {
+            affected = bulkAddScore(manager, indexes, count, courseIndex, delta);
+        }
+    }
+    free(indexes);
+    if (affected != 0) {
+        compactJournal(manager);
+    }
+    if (affected == -1) {
+        fprintf(stderr, "内存分配失败，操作未全部完成\n");
+        return 1;
+    }
+    printf("%s %d 名学生\n", isDelete ? "已删除" : (isMove ? "已转专业" : "已加分"), affected);
+    return 0;
+}
+
+// 批处理命令：合并一门课程的成绩表
+int batchMergeScores(StudentManager *manager, int argc, char *argv[]) {
+    const char *path = argc > 0 ? argv[0] : NULL;
+    const char *course = NULL;
+    const char *reportPath = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--course") == 0 && i + 1 < argc) {
+            course = argv[++i];
+        } else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+            reportPath = argv[++i];
+        } else {
+            fprintf(stderr, "未知参数 %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (path == NULL || course == NULL) {
+        fprintf(stderr, "用法: sims merge-scores <文件> --course <成绩名或序号> [--report <拒绝报告>]\n");
+        return 2;
+    }
+    int courseIndex = findCourse(manager, course);
+    if (courseIndex == -1) {
+        fprintf(stderr, "没有课程 %s\n", course);
+        return 1;
+    }
+    
+    ImportStats stats;
+    if (!mergeCourseScores(manager, path, courseIndex, reportPath, &stats)) {
+        fprintf(stderr, "无法打开文件 %s\n", path);
+        return 1;
+    }
+    if (stats.imported > 0 && !saveBulkChanges(manager)) {
+        fprintf(stderr, "无法写入数据文件 %s，写入的 %lld 个成绩未保存\n", SNAPSHOT_FILE, stats.imported);
+        return 1;
+    }
+    printf("共 %lld 行，写入 %lld 个成绩，拒绝 %lld 行，耗时 %.2f 秒（%.0f 行/秒）\n",
+           stats.rows, stats.imported, stats.rejected, stats.seconds,
+           stats.seconds > 0 ? stats.rows / stats.seconds : 0.0);
+    return stats.rejected > 0 ? 3 : 0;
+}
+
+// 批处理命令：添加、清除、列出院系/专业/成绩名预设，经由日志持久化（与交互菜单中的预设管理相同）
+int batchPreset(StudentManager *manager, int argc, char *argv[]) {
+    static const char *const kindNames[3] = {"成绩名", "院系", "专业"};
+    static const char *const kindOptions[3] = {"--score", "--department", "--major"};
+    static const size_t kindSizes[3] = {SCORE_NAME_SIZE, DEPARTMENT_NAME_SIZE, MAJOR_NAME_SIZE};
+    char ***lists[3] = {&manager->scoreNames, &manager->departmentNames, &manager->majorNames};
+    int *counts[3] = {&manager->scoreNameCount, &manager->departmentCount, &manager->majorCount};
+    int *capacities[3] = {&manager->scoreNameCapacity, &manager->departmentCapacity, &manager->majorCapacity};
+    const char *operation = argc > 0 ? argv[0] : "";
+    int isAdd = strcmp(operation, "add") == 0;
+    int isClear = strcmp(operation, "clear") == 0;
+    
+    if (strcmp(operation, "list") == 0 && argc == 1) {
+        for (int kind = 0; kind < 3; kind++) {
+            for (int i = 0; i < *counts[kind]; i++) {
+                printf("%s\t%s\n", kindNames[kind], (*lists[kind])[i]);
+            }
+        }
         return 0;
     }
     
+    // 先检查全部参数，参数有误时不做任何修改
+    int selected[3] = {0, 0, 0};
+    int actions = 0;
+    for (int i = 1; i < argc; i++) {
+        int kind = 0;
+        while (kind < 3 && strcmp(argv[i], kindOptions[kind]) != 0) {
+            kind++;
+        }
+        if (kind == 3 || (isAdd && i + 1 >= argc)) {
+            fprintf(stderr, "未知参数 %s\n", argv[i]);
+            return 2;
+        }
+        if (isAdd) {
+            const char *name = argv[++i];
+            if (isEmptyString(name) || strlen(name) >= kindSizes[kind]) {
+                fprintf(stderr, "无效的%s: %s\n", kindNames[kind], name);
+                return 2;
+            }
+        }
+        selected[kind] = 1;
+        actions++;
+    }
+    if ((!isAdd && !isClear) || actions == 0) {
+        fprintf(stderr, "用法: sims preset add [--department <院系>] [--major <专业>] [--score <成绩名>] ...\n"
+                        "      sims preset clear [--department] [--major] [--score]\n"
+                        "      sims preset list\n");
+        return 2;
+    }
+    
+    if (isClear) {
+        for (int kind = 0; kind < 3; kind++) {
+            if (!selected[kind]) {
+                continue;
+            }
+            for (int i = 0; i < *counts[kind]; i++) {
+                free((*lists[kind])[i]);
+            }
+            *counts[kind] = 0;
+            journalRecordPreset(manager, kind, NULL);
+            printf("已清除全部%s预设\n", kindNames[kind]);
+        }
+        return 0;
+    }
     
-    return 1;
+    for (int i = 1; i < argc; i += 2) {
+        int kind = 0;
+        while (strcmp(argv[i], kindOptions[kind]) != 0) {
+            kind++;
+        }
+        const char *name = argv[i + 1];
+        int exists = 0;
+        for (int j = 0; j < *counts[kind] && !exists; j++) {
+            exists = strcmp((*lists[kind])[j], name) == 0;
+        }
+        if (exists) {
+            printf("%s %s 已存在，跳过\n", kindNames[kind], name);
+            continue;
+        }
+        if (!pushPresetName(lists[kind], counts[kind], capacities[kind], name)) {
+            fprintf(stderr, "内存分配失败，无法添加%s %s\n", kindNames[kind], name);
+            return 1;
+        }
+        journalRecordPreset(manager, kind, name);
+        printf("已添加%s %s\n", kindNames[kind], name);
+    }
+    return 0;
+}
+
+// 批处理命令：统计信息
+int batchStats(StudentManager *manager) {
+    int live = liveStudentCount(manager);
+    printf("学生总数\t%d\n", live);
+    printf("院系预设\t%d\n", manager->departmentCount);
+    printf("专业预设\t%d\n", manager->majorCount);
+    printf("成绩名预设\t%d\n", manager->scoreNameCount);
+    
+    double sum = 0;
+    long long hundredths = 0;
+    long long scoreTotal = 0;
+    for (int i = 0; i < manager->count; i++) {
+        const Student *student = getStudent(manager, i);
+        if (student->deleted) {
+            continue;
+        }
+        // 定点模式下按整数累加，总和没有舍入误差
+        if (fixedScoreMode) {
+            hundredths += student->total.totalHundredths;
+        } else {
+            sum += student->total.totalScore;
+        }
+        scoreTotal += student->scoreCount;
+    }
+    if (fixedScoreMode) {
+        sum = hundredths / 100.0;
+    }
+    printf("成绩存储模式\t%s（记录内最多 %d 门）\n", fixedScoreMode ? "16位定点" : "float", inlineScoreCapacity());
+    printf("成绩总数\t%lld\n", scoreTotal);
+    printf("平均总分\t%.2f\n", live > 0 ? sum / live : 0.0);
+    reportStudentMemory(manager);
+    reportScorePool(&manager->scorePool);
+    
+    // 各专业、院系人数直接取倒排列表长度
+    for (int m = 0; m < manager->majorCount; m++) {
+        const PostingList *list = postingFind(&manager->majorIndex, dictLookup(&manager->strings, manager->majorNames[m]));
+        printf("专业:%s\t%d\n", manager->majorNames[m], list != NULL ? list->count : 0);
+    }
+    for (int d = 0; d < manager->departmentCount; d++) {
+        const PostingList *list = postingFind(&manager->departmentIndex,
+                                              dictLookup(&manager->strings, manager->departmentNames[d]));
+        printf("院系:%s\t%d\n", manager->departmentNames[d], list != NULL ? list->count : 0);
+    }
+    return 0;
+}
+
+// 批处理模式入口：不清屏、不等待按键，返回进程退出码
+// 退出码：0 成功，1 失败，2 参数错误，3 导入时有被拒绝的行
+int runBatch(int argc, char *argv[]) {
+    const char *command = argv[1];
+    useColor = 0;
+    
+    if (strcmp(command, "help") == 0 || strcmp(command, "--help") == 0 || strcmp(command, "-h") == 0) {
+        printBatchUsage();
+        return 0;
+    }
+    if (strcmp(command, "selftest") == 0) {
+        return runSelfTest();
+    }
+    if (strcmp(command, "bench") == 0) {
+        if (argc > 2 && strcmp(argv[2], "index") == 0) {
+            benchmarkIdIndex(argc > 3 ? atoi(argv[3]) : 10000000);
+            return 0;
+        }
+        if (argc > 2 && strcmp(argv[2], "names") == 0) {
+            benchmarkNameIndex(argc > 3 ? atoi(argv[3]) : 5000000);
+            return 0;
+        }
+        if (argc > 2 && strcmp(argv[2], "pinyin") == 0) {
+            benchmarkPinyinIndex(argc > 3 ? atoi(argv[3]) : 1000000);
+            return 0;
+        }
+        if (argc > 2 && strcmp(argv[2], "idrange") == 0) {
+            benchmarkIdOrder(argc > 3 ? atoi(argv[3]) : 1000000);
+            return 0;
+        }
+        if (argc > 2 && strcmp(argv[2], "rank") == 0) {
+            benchmarkRank(argc > 3 ? atoi(argv[3]) : 1000000);
+            return 0;
+        }
+        if (argc > 2 && strcmp(argv[2], "courses") == 0) {
+            benchmarkCourseStats(argc > 3 ? atoi(argv[3]) : 10000000);
+            return 0;
+        }
+        if (argc > 2 && strcmp(argv[2], "dist") == 0) {
+            benchmarkDistribution(argc > 3 ? atoi(argv[3]) : 1000000);
+            return 0;
+        }
+        if (argc > 2 && strcmp(argv[2], "graduate") == 0) {
+            benchmarkGraduation(argc > 3 ? atoi(argv[3]) : 1000000);
+            return 0;
+        }
+        if (argc > 2 && strcmp(argv[2], "merge") == 0) {
+            benchmarkMergeScores(argc > 3 ? atoi(argv[3]) : 1000000);
+            return 0;
+        }
+        if (argc > 2 && strcmp(argv[2], "stress") == 0) {
+            stressTestStore(argc > 3 ? atoi(argv[3]) : 10000000);
+            return 0;
+        }
+        if (argc > 2 && strcmp(argv[2], "render") == 0) {
+            benchmarkRender(argc > 3 ? atoi(argv[3]) : 100000);
+            return 0;
+        }
+        if (argc > 2 && strcmp(argv[2], "export") == 0) {
+            benchmarkExport(argc > 3 ? atoi(argv[3]) : 1000000);
+            return 0;
+        }
+        if (argc > 2 && strcmp(argv[2], "dict") == 0) {
+            benchmarkStringDict(argc > 3 ? atoi(argv[3]) : 1000000);
+            return 0;
+        }
+        if (argc > 2 && strcmp(argv[2], "columns") == 0) {
+            benchmarkColumns(argc > 3 ? atoi(argv[3]) : 1000000);
+            return 0;
+        }
+        if (argc > 2 && strcmp(argv[2], "scores") == 0) {
+            benchmarkScorePool(argc > 3 ? atoi(argv[3]) : 1000000);
+            return 0;
+        }
+        if (argc > 2 && strcmp(argv[2], "inline") == 0) {
+            benchmarkInlineScores(argc > 3 ? atoi(argv[3]) : 1000000);
+            return 0;
+        }
+        fprintf(stderr, "用法: sims bench index|names|pinyin|idrange|rank|courses|dist|graduate|merge|stress|render|export|dict|columns|scores|inline [数量]\n");
+        return 2;
+    }
+    if (strcmp(command, "import") != 0 && strcmp(command, "query") != 0 &&
+        strcmp(command, "export") != 0 && strcmp(command, "stats") != 0 &&
+        strcmp(command, "list") != 0 && strcmp(command, "rank") != 0 && strcmp(command, "courses") != 0 &&
+        strcmp(command, "dist") != 0 && strcmp(command, "bulk") != 0 &&
+        strcmp(command, "merge-scores") != 0 && strcmp(command, "preset") != 0) {
+        fprintf(stderr, "未知命令 %s\n\n", command);
+        printBatchUsage();
+        return 2;
+    }
+    
+    // 只读命令在内存中重放日志，不写任何数据文件，可与交互界面或其他命令同时运行；
+    // 会修改数据的命令须先取得数据文件锁
+    int readOnly = strcmp(command, "query") == 0 || strcmp(command, "export") == 0 ||
+                   strcmp(command, "stats") == 0 || strcmp(command, "list") == 0 ||
+                   strcmp(command, "rank") == 0 || strcmp(command, "courses") == 0 ||
+                   strcmp(command, "dist") == 0 ||
+                   (strcmp(command, "preset") == 0 && argc == 3 && strcmp(argv[2], "list") == 0);
+    if (!readOnly) {
+        int locked = lockDataFiles();
+        if (locked != 1) {
+            fprintf(stderr, locked == 0 ? "数据文件正被另一个进程修改（%s 已锁定），请稍后再试\n"
+                                        : "无法创建锁文件 %s\n", LOCK_FILE);
+            return 1;
+        }
+    }
+    
+    StudentManager *manager = initManager(100);
+    if (manager == NULL) {
+        unlockDataFiles();
+        return 1;
+    }
+    int loaded;
+    if (readOnly) {
+        recoverManagerReadOnly(manager, &loaded);
+    } else {
+        recoverManager(manager, &loaded);
+    }
+    if (loaded == -2) {
+        fprintf(stderr, "数据文件 %s 已损坏，已改名为 %s.bad 保留\n", SNAPSHOT_FILE, SNAPSHOT_FILE);
+    }
+    
+    int result;
+    if (strcmp(command, "import") == 0) {
+        result = batchImport(manager, argc - 2, argv + 2);
+    } else if (strcmp(command, "query") == 0) {
+        result = batchQuery(manager, argc - 2, argv + 2);
+    } else if (strcmp(command, "export") == 0) {
+        result = batchExport(manager, argc - 2, argv + 2);
+    } else if (strcmp(command, "list") == 0) {
+        result = batchList(manager, argc - 2, argv + 2);
+    } else if (strcmp(command, "rank") == 0) {
+        result = batchRank(manager, argc - 2, argv + 2);
+    } else if (strcmp(command, "courses") == 0) {
+        result = batchCourses(manager, argc - 2, argv + 2);
+    } else if (strcmp(command, "dist") == 0) {
+        result = batchDistribution(manager, argc - 2, argv + 2);
+    } else if (strcmp(command, "bulk") == 0) {
+        result = batchBulk(manager, argc - 2, argv + 2);
+    } else if (strcmp(command, "merge-scores") == 0) {
+        result = batchMergeScores(manager, argc - 2, argv + 2);
+    } else if (strcmp(command, "preset") == 0) {
+        result = batchPreset(manager, argc - 2, argv + 2);
+    } else {
+        result = batchStats(manager);
+    }
+    
+    freeManager(manager);
+    unlockDataFiles();
+    return result;
 }
 
-int main() {
+int main(int argc, char *argv[]) {
+    // 启动选项：成绩存储模式必须在载入任何学生之前确定
+    if (argc > 1 && strcmp(argv[1], "--fixed-scores") == 0) {
+        fixedScoreMode = 1;
+        argv[1] = argv[0];
+        argc--;
+        argv++;
+    }
+    
+    // 带命令行参数时进入批处理模式
+    if (argc > 1) {
+        return runBatch(argc, argv);
+    }
+    
+    // 输出被重定向到文件或管道时不输出颜色控制码
+#ifdef _WIN32
+    useColor = _isatty(_fileno(stdout));
+#else
+    useColor = isatty(STDOUT_FILENO);
+#endif
+    
     // 设置控制台标题
+#ifdef _WIN32
     SetConsoleOutputCP(65001);
     SetConsoleCP(65001);
     char consoleTitle[100];
     sprintf(consoleTitle, "学生信息管理系统 %s", SOFTWARE_VERSION_TEXT);
     SetConsoleTitle(consoleTitle);
+#endif
     
     clearScreen();
     setColor(COLOR_GREEN);
@@ -648,7 +9354,7 @@ int main() {
     
     // 初始化系统
     printf("\n\t\t正在初始化系统...");
-    StudentManager *manager = initManager(100);  // 初始容量100
+    StudentManager *manager = initManager(100);  // 初始容量100，之后按需扩容
     
     if (manager == NULL) {
         setColor(COLOR_RED);
@@ -663,6 +9369,46 @@ int main() {
     printf("\n\t\t系统初始化成功！\n");
     setColor(COLOR_RESET);
     
+    // 同一目录下同时只允许一个进程修改数据
+    int locked = lockDataFiles();
+    if (locked != 1) {
+        setColor(COLOR_RED);
+        if (locked == 0) {
+            printf("\t\t数据文件正被另一个进程使用（%s 已锁定），请先关闭另一个窗口！\n", LOCK_FILE);
+        } else {
+            printf("\t\t无法创建锁文件 %s！\n", LOCK_FILE);
+        }
+        setColor(COLOR_RESET);
+        printf("\t\t按任意键退出...");
+        getKey();
+        freeManager(manager);
+        return 1;
+    }
+    
+    // 加载上次保存的数据快照，并重放之后的操作日志
+    long long loadStart = currentTimeMs();
+    int loaded;
+    int replayed = recoverManager(manager, &loaded);
+    if (loaded >= 0) {
+        setColor(COLOR_GREEN);
+        printf("\t\t已从 %s 加载 %d 名学生（%lld 毫秒）\n", SNAPSHOT_FILE, loaded, currentTimeMs() - loadStart);
+        setColor(COLOR_RESET);
+    } else if (loaded == -2) {
+        setColor(COLOR_RED);
+        printf("\t\t数据文件 %s 已损坏，已改名为 %s.bad 保留，本次以空数据启动！\n", SNAPSHOT_FILE, SNAPSHOT_FILE);
+        setColor(COLOR_RESET);
+    }
+    if (replayed > 0) {
+        setColor(COLOR_YELLOW);
+        printf("\t\t已从操作日志恢复 %d 项未保存的操作，当前共 %d 名学生\n", replayed, liveStudentCount(manager));
+        setColor(COLOR_RESET);
+    }
+    if (manager->journal == NULL) {
+        setColor(COLOR_RED);
+        printf("\t\t无法创建操作日志 %s，本次修改仅在正常退出时保存！\n", JOURNAL_FILE);
+        setColor(COLOR_RESET);
+    }
+    
     printf("\t\t按任意键继续...");
     getKey();
     
@@ -678,7 +9424,7 @@ int main() {
         }
         
         // 验证输入是否有效
-        if (!((choice >= '0' && choice <= '9') || choice == 'a' || choice == 'b')) {
+        if (!((choice >= '0' && choice <= '9') || (choice >= 'a' && choice <= 'f'))) {
             clearScreen();
             setColor(COLOR_RED);
             printf("\n\n\t\t无效的选择，请重新输入！\n");
@@ -722,12 +9468,40 @@ int main() {
             case 'b':
                 showDeveloperMessage();
                 break;
+            case 'c':
+                showLeaderboard(manager);
+                break;
+            case 'd':
+                showCourseStats(manager);
+                break;
+            case 'e':
+                showScoreDistribution(manager);
+                break;
+            case 'f':
+                bulkOperations(manager);
+                break;
             case '0':
                 clearScreen();
+                // 退出前保存数据快照，快照已包含全部操作，随后清除日志
+                if (manager->journal != NULL && manager->journal->compacting) {
+                    joinThread(manager->journal->compactThread);
+                    manager->journal->compacting = 0;
+                }
+                if (saveSnapshot(manager, SNAPSHOT_FILE)) {
+                    journalClose(manager->journal);
+                    manager->journal = NULL;
+                    remove(JOURNAL_FILE);
+                    setColor(COLOR_GREEN);
+                    printf("\n\n\t\t数据已保存到 %s\n", SNAPSHOT_FILE);
+                } else {
+                    setColor(COLOR_RED);
+                    printf("\n\n\t\t数据保存失败！\n");
+                }
                 setColor(COLOR_GREEN);
                 printf("\n\n\t\t感谢使用学生信息管理系统！\n\n");
                 setColor(COLOR_RESET);
                 freeManager(manager);
+                unlockDataFiles();
                 return 0;
             default:
                 clearScreen();
@@ -739,339 +9513,883 @@ int main() {
         }
     }
     
-    return 0;
+    return 0;
+}
+
+// 逐门录入成绩（有预设成绩名时按预设名提示），输入 end 结束，一门都没录入时记0分
+// 返回成绩数组（需调用者释放），*count 为成绩数；内存不足返回NULL
+float *inputScores(StudentManager *manager, int *count) {
+    int maxScores = 10; // 初始最大成绩数量
+    float *entered = (float *)malloc(sizeof(float) * (size_t)maxScores);
+    int enteredCount = 0;
+    if (entered == NULL) {
+        return NULL;
+    }
+    
+    while (1) {
+        char input[20];
+        // 如果有预设的成绩名且当前输入的成绩索引小于预设数量，显示预设的成绩名
+        if (manager->scoreNameCount > 0 && enteredCount < manager->scoreNameCount) {
+            printf("\t\t%s: ", manager->scoreNames[enteredCount]);
+        } else {
+            printf("\t\t成绩 %d: ", enteredCount + 1);
+        }
+        scanf("%s", input);
+        
+        // 检查是否输入end
+        if (strcmp(input, "end") == 0) {
+            break;
+        }
+        
+        // 尝试转换为数字
+        char *endptr;
+        float scoreValue = strtof(input, &endptr);
+        
+        // 验证输入是否为有效数字且在0-100之间
+        if (*endptr == '\0' && isValidScore(scoreValue)) {
+            // 检查是否需要扩容
+            if (enteredCount >= maxScores) {
+                float *grown = (float *)realloc(entered, sizeof(float) * (size_t)maxScores * 2);
+                if (grown == NULL) {
+                    free(entered);
+                    return NULL;
+                }
+                entered = grown;
+                maxScores *= 2;
+            }
+            
+            // 添加成绩
+            entered[enteredCount++] = scoreValue;
+        } else {
+            setColor(COLOR_RED);
+            printf("\t\t成绩无效，请输入0-100之间的数字或输入end结束！\n");
+            setColor(COLOR_RESET);
+        }
+    }
+    
+    // 如果没有输入任何成绩，设置一个默认值
+    if (enteredCount == 0) {
+        entered[enteredCount++] = 0.0;
+        setColor(COLOR_YELLOW);
+        printf("\t\t未输入成绩，已设置默认值0分\n");
+        setColor(COLOR_RESET);
+    }
+    
+    *count = enteredCount;
+    return entered;
+}
+
+// 录入学生信息
+int addStudent(StudentManager *manager) {
+    clearScreen();
+    setColor(COLOR_YELLOW);
+    printf("\n\n\t\t===== 录入学生信息 =====\n\n");
+    setColor(COLOR_RESET);
+    
+    // 检查是否已经设置了院系和专业预设
+    if (manager->departmentCount == 0 || manager->majorCount == 0) {
+        setColor(COLOR_RED);
+        printf("\t\t尚未输入预设！请先设置院系和专业预设。\n");
+        setColor(COLOR_RESET);
+        printf("\t\t按任意键返回...");
+        getKey();
+        return 0;
+    }
+    
+    // 先在临时记录中录入，完成后再追加到分块存储（存储会按需扩容）
+    Student newStudent;
+    memset(&newStudent, 0, sizeof(Student));
+    Student *student = &newStudent;
+    char temp[100];
+    int result;
+    
+    // 录入姓名（带验证）
+    while (1) {
+        printf("\t\t姓名: ");
+        result = scanf("%s", temp);
+        clearInputBuffer();
+        
+        if (result == 1 && isValidName(temp)) {
+            strcpy(student->name, temp);
+            break;
+        } else {
+            setColor(COLOR_RED);
+            printf("\t\t姓名无效，请输入1-20个字符！\n");
+            setColor(COLOR_RESET);
+        }
+    }
+    
+    // 录入性别（带验证）
+    while (1) {
+        printf("\t\t性别 (男/女): ");
+        fgets(temp, sizeof(temp), stdin);
+        // 移除末尾的换行符
+        size_t len = strlen(temp);
+        if (len > 0 && temp[len - 1] == '\n') {
+            temp[len - 1] = '\0';
+        }
+        
+        if (isValidGender(temp)) {
+            strcpy(student->gender, temp);
+            break;
+        } else {
+            setColor(COLOR_RED);
+            printf("\t\t性别无效，请输入'男'或'女'！\n");
+            setColor(COLOR_RESET);
+        }
+    }
+    
+    // 录入学号（带验证）
+    while (1) {
+        printf("\t\t学号 (4-20位数字和字母): ");
+        result = scanf("%s", temp);
+        clearInputBuffer();
+        
+        if (result == 1 && isValidId(temp)) {
+            // 检查学号是否已存在
+            if (findStudentById(manager, temp) != -1) {
+                setColor(COLOR_RED);
+                printf("\t\t学号已存在！\n");
+                setColor(COLOR_RESET);
+            } else {
+                strcpy(student->id, temp);
+                break;
+            }
+        } else {
+            setColor(COLOR_RED);
+            printf("\t\t学号无效，请输入4-20位数字和字母！\n");
+            setColor(COLOR_RESET);
+        }
+    }
+    
+    // 录入班级（带基本验证）
+    while (1) {
+        printf("\t\t班级: ");
+        result = scanf("%s", temp);
+        clearInputBuffer();
+        
+        if (result == 1 && !isEmptyString(temp) && strlen(temp) < CLASS_NAME_SIZE) {
+            student->classId = dictIntern(&manager->strings, temp);
+            if (student->classId == -1) {
+                setColor(COLOR_RED);
+                printf("\t\t内存分配失败，无法添加新学生！\n");
+                setColor(COLOR_RESET);
+                printf("\t\t按任意键返回...");
+                getKey();
+                return 0;
+            }
+            break;
+        } else {
+            setColor(COLOR_RED);
+            printf("\t\t班级名称无效，请输入有效名称！\n");
+            setColor(COLOR_RESET);
+        }
+    }
+    
+    // 从预设列表中选择院系
+    while (1) {
+        setColor(COLOR_CYAN);
+        printf("\t\t预设院系列表：\n");
+        for (int i = 0; i < manager->departmentCount; i++) {
+            printf("\t\t%d. %s\n", i + 1, manager->departmentNames[i]);
+        }
+        setColor(COLOR_RESET);
+        
+        printf("\t\t请选择院系 (1-%d): ", manager->departmentCount);
+        int choice;
+        result = scanf("%d", &choice);
+        clearInputBuffer();
+        
+        if (result == 1 && choice >= 1 && choice <= manager->departmentCount) {
+            student->departmentId = dictIntern(&manager->strings, manager->departmentNames[choice - 1]);
+            if (student->departmentId == -1) {
+                setColor(COLOR_RED);
+                printf("\t\t内存分配失败，无法添加新学生！\n");
+                setColor(COLOR_RESET);
+                printf("\t\t按任意键返回...");
+                getKey();
+                return 0;
+            }
+            break;
+        } else {
+            setColor(COLOR_RED);
+            printf("\t\t选择无效，请输入正确的序号！\n");
+            setColor(COLOR_RESET);
+        }
+    }
+    
+    // 从预设列表中选择专业
+    while (1) {
+        setColor(COLOR_CYAN);
+        printf("\t\t预设专业列表：\n");
+        for (int i = 0; i < manager->majorCount; i++) {
+            printf("\t\t%d. %s\n", i + 1, manager->majorNames[i]);
+        }
+        setColor(COLOR_RESET);
+        
+        printf("\t\t请选择专业 (1-%d): ", manager->majorCount);
+        int choice;
+        result = scanf("%d", &choice);
+        clearInputBuffer();
+        
+        if (result == 1 && choice >= 1 && choice <= manager->majorCount) {
+            student->majorId = dictIntern(&manager->strings, manager->majorNames[choice - 1]);
+            if (student->majorId == -1) {
+                setColor(COLOR_RED);
+                printf("\t\t内存分配失败，无法添加新学生！\n");
+                setColor(COLOR_RESET);
+                printf("\t\t按任意键返回...");
+                getKey();
+                return 0;
+            }
+            break;
+        } else {
+            setColor(COLOR_RED);
+            printf("\t\t选择无效，请输入正确的序号！\n");
+            setColor(COLOR_RESET);
+        }
+    }
+    
+    // 初始化成绩
+    student->scoreCount = 0;
+    
+    // 录入成绩（支持多个成绩，输入end结束）
+    setColor(COLOR_YELLOW);
+    printf("\t\t请输入成绩 (0-100)，输入end结束输入：\n");
+    
+    // 如果有预设的成绩名，显示出来
+    if (manager->scoreNameCount > 0) {
+        setColor(COLOR_CYAN);
+        printf("\t\t预设成绩名：");
+        for (int i = 0; i < manager->scoreNameCount; i++) {
+            printf("%s", manager->scoreNames[i]);
+            if (i < manager->scoreNameCount - 1) {
+                printf(", ");
+            }
+        }
+        printf("\n");
+    }
+    setColor(COLOR_RESET);
+    
+    int enteredCount;
+    float *entered = inputScores(manager, &enteredCount); // 录入中的成绩，完成后存入学生记录
+    
+    // 存入学生记录（放得下时直接存放在记录内），同时计算成绩总和
+    int stored = entered != NULL && setStudentScores(&manager->scorePool, student, entered, enteredCount);
+    free(entered);
+    
+    // 追加到学生存储并加入学号哈希索引
+    if (!stored || appendStudent(manager, student) == -1) {
+        releaseStudentScores(&manager->scorePool, student);
+        setColor(COLOR_RED);
+        printf("\t\t内存分配失败，无法添加新学生！\n");
+        setColor(COLOR_RESET);
+        printf("\t\t按任意键返回...");
+        getKey();
+        return 0;
+    }
+    journalRecordStudent(manager, JOURNAL_ADD, student);
+    
+    setColor(COLOR_GREEN);
+    printf("\n\t\t学生信息录入成功！\n");
+    setColor(COLOR_RESET);
+    printf("\t\t按任意键返回...");
+    getKey();
+    return 1;
+}
+
+// 根据姓名查找学生
+int findStudentByName(StudentManager *manager, const char *name) {
+    if (manager == NULL || name == NULL || isEmptyString(name)) {
+        return -1;
+    }
+    
+    // 姓名完全相同的优先，其次是包含该姓名的学生（模糊查找）
+    int count;
+    int *matches = findStudentsByName(manager, name, &count);
+    int index = count > 0 ? matches[0] : -1;
+    free(matches);
+    return index;
+}
+
+// 根据学号查找学生
+int findStudentById(StudentManager *manager, const char *id) {
+    if (manager == NULL || id == NULL || isEmptyString(id)) {
+        return -1;
+    }
+    
+    return idIndexFind(manager, id);
 }
 
-// 录入学生信息
-int addStudent(StudentManager *manager) {
-    clearScreen();
+// 显示单个学生信息
+void displayStudent(StudentManager *manager, const Student *student) {
+    if (student == NULL) {
+        return;
+    }
+    
+    setColor(COLOR_CYAN);
+    printf("\n============================================================\n");
+    printf("\t             学生信息详情\n");
+    printf("============================================================\n");
+    setColor(COLOR_RESET);
+    
     setColor(COLOR_YELLOW);
-    printf("\n\n\t\t===== 录入学生信息 =====\n\n");
+    printf("\t姓名: %s\n", student->name);
+    printf("\t学号: %s\n", student->id);
+    printf("\t性别: %s\n", student->gender);
+    printf("\t班级: %s\n", dictString(&manager->strings, student->classId));
+    printf("\t院系: %s\n", dictString(&manager->strings, student->departmentId));
+    printf("\t专业: %s\n", dictString(&manager->strings, student->majorId));
+    printf("\t成绩列表: ");
+    for (int i = 0; i < student->scoreCount; i++) {
+        printf("%.2f", studentScore(student, i));
+        if (i < student->scoreCount - 1) {
+            printf(", ");
+        }
+    }
+    printf("\n");
+    printf("\t成绩总和: %.2f\n", studentTotal(student));
     setColor(COLOR_RESET);
     
-    // 检查是否已经设置了院系和专业预设
-    if (manager->departmentCount == 0 || manager->majorCount == 0) {
+    setColor(COLOR_CYAN);
+    printf("============================================================\n");
+    setColor(COLOR_RESET);
+}
+
+// 显示查找结果：一名学生时显示详情，多名时分页浏览（返回1，调用者直接返回），并释放 matches
+// matches 为NULL表示内存不足；title 为列表标题，会补上人数
+int showSearchMatches(StudentManager *manager, int *matches, int count, const char *title) {
+    if (matches == NULL) {
         setColor(COLOR_RED);
-        printf("\t\t尚未输入预设！请先设置院系和专业预设。\n");
+        printf("\n\t\t内存分配失败！\n");
         setColor(COLOR_RESET);
-        printf("\t\t按任意键返回...");
-        getKey();
         return 0;
     }
-    
-    // 检查是否已满
-    if (manager->count >= manager->capacity) {
+    if (count > 1) {
+        char fullTitle[300];
+        snprintf(fullTitle, sizeof(fullTitle), "%s（共 %d 名）", title, count);
+        browseStudents(manager, matches, count, fullTitle);
+        free(matches);
+        return 1;
+    }
+    if (count == 1) {
+        displayStudent(manager, getStudent(manager, matches[0]));
+        setColor(COLOR_GREEN);
+        printf("\t\t学生信息查找成功！\n");
+        setColor(COLOR_RESET);
+    } else {
+        setColor(COLOR_RED);
+        printf("\n\t\t未找到该学生信息！\n");
+        setColor(COLOR_RESET);
+    }
+    free(matches);
+    return 0;
+}
+
+// 查找学生信息
+void searchStudents(StudentManager *manager) {
+    if (manager == NULL) {
         setColor(COLOR_RED);
-        printf("\t\t系统容量已满，无法添加新学生！\n");
+        printf("\n系统错误！\n");
+        setColor(COLOR_RESET);
+        return;
+    }
+    
+    if (liveStudentCount(manager) == 0) {
+        setColor(COLOR_YELLOW);
+        printf("\n暂无学生信息！\n");
         setColor(COLOR_RESET);
         printf("\t\t按任意键返回...");
         getKey();
-        return 0;
+        return;
     }
     
-    Student *student = &manager->students[manager->count];
-    char temp[100];
-    int result;
+    char searchChoice;
+    char searchInput[100];
+    int index;
     
-    // 录入姓名（带验证）
     while (1) {
-        printf("\t\t姓名: ");
-        result = scanf("%s", temp);
-        clearInputBuffer();
+        clearScreen();
+        setColor(COLOR_GREEN);
+        printf("\n\n\t\t\t=======================================\n");
+        printf("\t\t\t          查找学生信息          \n");
+        printf("\t\t\t=======================================\n\n");
+        setColor(COLOR_RESET);
         
-        if (result == 1 && isValidName(temp)) {
-            strcpy(student->name, temp);
+        setColor(COLOR_YELLOW);
+        printf("\t\t[1] 按姓名查找\n");
+        printf("\t\t[2] 按学号查找\n");
+        printf("\t\t[3] 按拼音查找（全拼或首字母，如 zhangsan、zs）\n");
+        printf("\t\t[4] 按学号前缀查找\n");
+        printf("\t\t[5] 按学号范围查找\n");
+        printf("\t\t[0] 返回主菜单\n\n");
+        setColor(COLOR_RESET);
+        
+        setColor(COLOR_CYAN);
+        printf("\t\t请选择查找方式: ");
+        setColor(COLOR_RESET);
+        
+        searchChoice = getKey();
+        
+        if (searchChoice == '0') {
+            return;
+        }
+        
+        if (searchChoice >= '1' && searchChoice <= '5') {
             break;
-        } else {
-            setColor(COLOR_RED);
-            printf("\t\t姓名无效，请输入1-20个字符！\n");
-            setColor(COLOR_RESET);
         }
+        
+        setColor(COLOR_RED);
+        printf("\n\t\t无效的选择，请重新输入！\n");
+        setColor(COLOR_RESET);
+        Sleep(1000);
     }
     
-    // 录入性别（带验证）
-    while (1) {
-        printf("\t\t性别 (男/女): ");
-        fgets(temp, sizeof(temp), stdin);
-        // 移除末尾的换行符
-        size_t len = strlen(temp);
-        if (len > 0 && temp[len - 1] == '\n') {
-            temp[len - 1] = '\0';
+    clearInputBuffer();
+    
+    if (searchChoice == '1') {
+        setColor(COLOR_CYAN);
+        printf("\n\t\t请输入要查找的学生姓名: ");
+        setColor(COLOR_RESET);
+        
+        if (fgets(searchInput, sizeof(searchInput), stdin) != NULL) {
+            // 去除换行符
+            searchInput[strcspn(searchInput, "\n")] = '\0';
+            
+            if (isEmptyString(searchInput)) {
+                setColor(COLOR_RED);
+                printf("\n\t\t姓名不能为空！\n");
+                setColor(COLOR_RESET);
+                printf("\t\t按任意键返回...");
+                getKey();
+                return;
+            }
+            
+            // 返回全部匹配的学生（姓名完全相同的在前），多名时分页浏览
+            int count;
+            int *matches = findStudentsByName(manager, searchInput, &count);
+            char title[200];
+            snprintf(title, sizeof(title), "姓名包含“%s”的学生", searchInput);
+            if (showSearchMatches(manager, matches, count, title)) {
+                return;
+            }
         }
+    } else if (searchChoice == '2') {
+        setColor(COLOR_CYAN);
+        printf("\n\t\t请输入要查找的学生学号: ");
+        setColor(COLOR_RESET);
         
-        if (isValidGender(temp)) {
-            strcpy(student->gender, temp);
-            break;
-        } else {
-            setColor(COLOR_RED);
-            printf("\t\t性别无效，请输入'男'或'女'！\n");
-            setColor(COLOR_RESET);
+        if (fgets(searchInput, sizeof(searchInput), stdin) != NULL) {
+            // 去除换行符
+            searchInput[strcspn(searchInput, "\n")] = '\0';
+            
+            if (isEmptyString(searchInput)) {
+                setColor(COLOR_RED);
+                printf("\n\t\t学号不能为空！\n");
+                setColor(COLOR_RESET);
+                printf("\t\t按任意键返回...");
+                getKey();
+                return;
+            }
+            
+            index = findStudentById(manager, searchInput);
+            
+            if (index != -1) {
+                displayStudent(manager, getStudent(manager, index));
+                setColor(COLOR_GREEN);
+                printf("\t\t学生信息查找成功！\n");
+                setColor(COLOR_RESET);
+            } else {
+                setColor(COLOR_RED);
+                printf("\n\t\t未找到该学生信息！\n");
+                setColor(COLOR_RESET);
+            }
         }
-    }
-    
-    // 录入学号（带验证）
-    while (1) {
-        printf("\t\t学号 (4-20位数字和字母): ");
-        result = scanf("%s", temp);
-        clearInputBuffer();
+    } else if (searchChoice == '3') {
+        setColor(COLOR_CYAN);
+        printf("\n\t\t请输入拼音或拼音首字母: ");
+        setColor(COLOR_RESET);
         
-        if (result == 1 && isValidId(temp)) {
-            // 检查学号是否已存在
-            int exists = 0;
-            for (int i = 0; i < manager->count; i++) {
-                if (strcmp(manager->students[i].id, temp) == 0) {
-                    exists = 1;
-                    break;
+        if (fgets(searchInput, sizeof(searchInput), stdin) != NULL) {
+            // 去除换行符
+            searchInput[strcspn(searchInput, "\n")] = '\0';
+            
+            if (isEmptyString(searchInput)) {
+                setColor(COLOR_RED);
+                printf("\n\t\t拼音不能为空！\n");
+                setColor(COLOR_RESET);
+                printf("\t\t按任意键返回...");
+                getKey();
+                return;
+            }
+            
+            // 按拼音前缀取出候选学生，多名时分页浏览
+            int count;
+            int *matches = findStudentsByPinyin(manager, searchInput, &count);
+            char title[200];
+            snprintf(title, sizeof(title), "拼音以“%s”开头的学生", searchInput);
+            if (showSearchMatches(manager, matches, count, title)) {
+                return;
+            }
+        }
+    } else if (searchChoice == '4' || searchChoice == '5') {
+        char rangeEnd[100] = "";
+        setColor(COLOR_CYAN);
+        printf(searchChoice == '4' ? "\n\t\t请输入学号前缀（如 202305）: " : "\n\t\t请输入起始学号: ");
+        setColor(COLOR_RESET);
+        
+        if (fgets(searchInput, sizeof(searchInput), stdin) != NULL) {
+            // 去除换行符
+            searchInput[strcspn(searchInput, "\n")] = '\0';
+            if (searchChoice == '5') {
+                setColor(COLOR_CYAN);
+                printf("\t\t请输入结束学号: ");
+                setColor(COLOR_RESET);
+                if (fgets(rangeEnd, sizeof(rangeEnd), stdin) != NULL) {
+                    rangeEnd[strcspn(rangeEnd, "\n")] = '\0';
                 }
             }
-            if (exists) {
+            
+            if (isEmptyString(searchInput) || (searchChoice == '5' && isEmptyString(rangeEnd))) {
                 setColor(COLOR_RED);
-                printf("\t\t学号已存在！\n");
+                printf("\n\t\t学号不能为空！\n");
                 setColor(COLOR_RESET);
+                printf("\t\t按任意键返回...");
+                getKey();
+                return;
+            }
+            
+            // 在学号有序索引中定位后顺序取出，结果按学号排列
+            int count;
+            int *matches;
+            char title[250];
+            if (searchChoice == '4') {
+                matches = findStudentsByIdPrefix(manager, searchInput, &count);
+                snprintf(title, sizeof(title), "学号以“%s”开头的学生", searchInput);
             } else {
-                strcpy(student->id, temp);
-                break;
+                matches = findStudentsByIdRange(manager, searchInput, rangeEnd, &count);
+                snprintf(title, sizeof(title), "学号在 %s ~ %s 之间的学生", searchInput, rangeEnd);
+            }
+            if (showSearchMatches(manager, matches, count, title)) {
+                return;
             }
-        } else {
-            setColor(COLOR_RED);
-            printf("\t\t学号无效，请输入4-20位数字和字母！\n");
-            setColor(COLOR_RESET);
         }
     }
     
-    // 录入班级（带基本验证）
-    while (1) {
-        printf("\t\t班级: ");
-        result = scanf("%s", temp);
-        clearInputBuffer();
-        
-        if (result == 1 && !isEmptyString(temp) && strlen(temp) < 20) {
-            strcpy(student->className, temp);
-            break;
-        } else {
-            setColor(COLOR_RED);
-            printf("\t\t班级名称无效，请输入有效名称！\n");
-            setColor(COLOR_RESET);
-        }
+    printf("\n\t\t按任意键返回...");
+    getKey();
+}
+
+// 成绩排行榜：全体、某专业或某班级的总分前N名，以及某学号的名次和百分位
+void showLeaderboard(StudentManager *manager) {
+    if (liveStudentCount(manager) == 0) {
+        setColor(COLOR_YELLOW);
+        printf("\n暂无学生信息！\n");
+        setColor(COLOR_RESET);
+        printf("\t\t按任意键返回...");
+        getKey();
+        return;
     }
     
-    // 从预设列表中选择院系
-    while (1) {
-        setColor(COLOR_CYAN);
-        printf("\t\t预设院系列表：\n");
-        for (int i = 0; i < manager->departmentCount; i++) {
-            printf("\t\t%d. %s\n", i + 1, manager->departmentNames[i]);
-        }
+    char scopeChoice, queryChoice;
+    char input[100];
+    
+    while (1) {
+        clearScreen();
+        setColor(COLOR_GREEN);
+        printf("\n\n\t\t\t=======================================\n");
+        printf("\t\t\t            成绩排行榜          \n");
+        printf("\t\t\t=======================================\n\n");
         setColor(COLOR_RESET);
         
-        printf("\t\t请选择院系 (1-%d): ", manager->departmentCount);
-        int choice;
-        result = scanf("%d", &choice);
-        clearInputBuffer();
+        setColor(COLOR_YELLOW);
+        printf("\t\t[1] 全体学生\n");
+        printf("\t\t[2] 指定专业\n");
+        printf("\t\t[3] 指定班级\n");
+        printf("\t\t[0] 返回主菜单\n\n");
+        setColor(COLOR_RESET);
         
-        if (result == 1 && choice >= 1 && choice <= manager->departmentCount) {
-            strcpy(student->department, manager->departmentNames[choice - 1]);
+        setColor(COLOR_CYAN);
+        printf("\t\t请选择排行范围: ");
+        setColor(COLOR_RESET);
+        
+        scopeChoice = getKey();
+        if (scopeChoice == '0') {
+            return;
+        }
+        if (scopeChoice >= '1' && scopeChoice <= '3') {
             break;
-        } else {
-            setColor(COLOR_RED);
-            printf("\t\t选择无效，请输入正确的序号！\n");
-            setColor(COLOR_RESET);
         }
+        
+        setColor(COLOR_RED);
+        printf("\n\t\t无效的选择，请重新输入！\n");
+        setColor(COLOR_RESET);
+        Sleep(1000);
     }
+    clearInputBuffer();
     
-    // 从预设列表中选择专业
-    while (1) {
+    int scope = scopeChoice == '1' ? RANK_SCOPE_ALL : (scopeChoice == '2' ? RANK_SCOPE_MAJOR : RANK_SCOPE_CLASS);
+    int scopeId = -1;
+    char scopeName[100] = "全体学生";
+    if (scope != RANK_SCOPE_ALL) {
         setColor(COLOR_CYAN);
-        printf("\t\t预设专业列表：\n");
-        for (int i = 0; i < manager->majorCount; i++) {
-            printf("\t\t%d. %s\n", i + 1, manager->majorNames[i]);
-        }
+        printf(scope == RANK_SCOPE_MAJOR ? "\n\t\t请输入专业名称: " : "\n\t\t请输入班级名称: ");
         setColor(COLOR_RESET);
-        
-        printf("\t\t请选择专业 (1-%d): ", manager->majorCount);
-        int choice;
-        result = scanf("%d", &choice);
-        clearInputBuffer();
-        
-        if (result == 1 && choice >= 1 && choice <= manager->majorCount) {
-            strcpy(student->major, manager->majorNames[choice - 1]);
-            break;
-        } else {
+        if (fgets(scopeName, sizeof(scopeName), stdin) == NULL) {
+            return;
+        }
+        scopeName[strcspn(scopeName, "\n")] = '\0';
+        scopeId = dictLookup(&manager->strings, scopeName);
+        PostingList *list = scopeId == -1 ? NULL
+                          : postingFind(scope == RANK_SCOPE_MAJOR ? &manager->majorIndex : &manager->classIndex, scopeId);
+        if (list == NULL || list->count == 0) {
             setColor(COLOR_RED);
-            printf("\t\t选择无效，请输入正确的序号！\n");
+            printf("\n\t\t%s“%s”下没有学生！\n", scope == RANK_SCOPE_MAJOR ? "专业" : "班级", scopeName);
             setColor(COLOR_RESET);
+            printf("\t\t按任意键返回...");
+            getKey();
+            return;
         }
     }
     
-    // 初始化成绩数组
-    student->scores = NULL;
-    student->scoreCount = 0;
-    student->totalScore = 0.0;
-    
-    // 录入成绩（支持多个成绩，输入end结束）
     setColor(COLOR_YELLOW);
-    printf("\t\t请输入成绩 (0-100)，输入end结束输入：\n");
+    printf("\n\t\t[1] 查看总分前N名\n");
+    printf("\t\t[2] 查询学号的名次与百分位\n");
+    setColor(COLOR_CYAN);
+    printf("\t\t请选择: ");
+    setColor(COLOR_RESET);
+    queryChoice = getKey();
+    clearInputBuffer();
     
-    // 如果有预设的成绩名，显示出来
-    if (manager->scoreNameCount > 0) {
+    if (queryChoice == '1') {
         setColor(COLOR_CYAN);
-        printf("\t\t预设成绩名：");
-        for (int i = 0; i < manager->scoreNameCount; i++) {
-            printf("%s", manager->scoreNames[i]);
-            if (i < manager->scoreNameCount - 1) {
-                printf(", ");
-            }
+        printf("\n\t\t显示前几名（直接回车为50）: ");
+        setColor(COLOR_RESET);
+        int limit = 50;
+        if (fgets(input, sizeof(input), stdin) != NULL && atoi(input) > 0) {
+            limit = atoi(input);
         }
-        printf("\n");
-    }
-    setColor(COLOR_RESET);
-    
-    int maxScores = 10; // 初始最大成绩数量
-    student->scores = (float *)malloc(maxScores * sizeof(float));
-    
-    while (1) {
-        char input[20];
-        // 如果有预设的成绩名且当前输入的成绩索引小于预设数量，显示预设的成绩名
-        if (manager->scoreNameCount > 0 && student->scoreCount < manager->scoreNameCount) {
-            printf("\t\t%s: ", manager->scoreNames[student->scoreCount]);
+        
+        int count;
+        int *top = rankTopStudents(manager, scope, scopeId, limit, &count);
+        if (top == NULL) {
+            setColor(COLOR_RED);
+            printf("\n\t\t内存分配失败！\n");
+            setColor(COLOR_RESET);
         } else {
-            printf("\t\t成绩 %d: ", student->scoreCount + 1);
+            char title[200];
+            snprintf(title, sizeof(title), "%s 总分前 %d 名", scopeName, count);
+            browseStudents(manager, top, count, title);
+            free(top);
+            return;
         }
-        scanf("%s", input);
-        
-        // 检查是否输入end
-        if (strcmp(input, "end") == 0) {
-            break;
+    } else if (queryChoice == '2') {
+        setColor(COLOR_CYAN);
+        printf("\n\t\t请输入学号: ");
+        setColor(COLOR_RESET);
+        if (fgets(input, sizeof(input), stdin) != NULL) {
+            input[strcspn(input, "\n")] = '\0';
         }
         
-        // 尝试转换为数字
-        char *endptr;
-        float scoreValue = strtof(input, &endptr);
-        
-        // 验证输入是否为有效数字且在0-100之间
-        if (*endptr == '\0' && isValidScore(scoreValue)) {
-            // 检查是否需要扩容
-            if (student->scoreCount >= maxScores) {
-                maxScores *= 2;
-                student->scores = (float *)realloc(student->scores, maxScores * sizeof(float));
-            }
-            
-            // 添加成绩
-            student->scores[student->scoreCount] = scoreValue;
-            student->totalScore += scoreValue;
-            student->scoreCount++;
-        } else {
+        int index = findStudentById(manager, input);
+        int rank, total;
+        double percentile;
+        if (index == -1) {
             setColor(COLOR_RED);
-            printf("\t\t成绩无效，请输入0-100之间的数字或输入end结束！\n");
+            printf("\n\t\t未找到该学生信息！\n");
+            setColor(COLOR_RESET);
+        } else if (!rankOfStudent(manager, scope, scopeId, index, &rank, &total, &percentile)) {
+            setColor(COLOR_RED);
+            printf("\n\t\t该学生不在%s中！\n", scopeName);
+            setColor(COLOR_RESET);
+        } else {
+            displayStudent(manager, getStudent(manager, index));
+            setColor(COLOR_GREEN);
+            printf("\t\t%s 中排名第 %d / %d，百分位 %.1f%%\n", scopeName, rank, total, percentile);
             setColor(COLOR_RESET);
         }
-    }
-    
-    // 如果没有输入任何成绩，设置一个默认值
-    if (student->scoreCount == 0) {
-        student->scores[0] = 0.0;
-        student->scoreCount = 1;
-        student->totalScore = 0.0;
-        setColor(COLOR_YELLOW);
-        printf("\t\t未输入成绩，已设置默认值0分\n");
-        setColor(COLOR_RESET);
     } else {
-        // 重新分配内存到实际需要的大小
-        student->scores = (float *)realloc(student->scores, student->scoreCount * sizeof(float));
+        setColor(COLOR_RED);
+        printf("\n\t\t无效的选择！\n");
+        setColor(COLOR_RESET);
     }
     
-    manager->count++;
-    
-    setColor(COLOR_GREEN);
-    printf("\n\t\t学生信息录入成功！\n");
-    setColor(COLOR_RESET);
-    printf("\t\t按任意键返回...");
+    printf("\n\t\t按任意键返回...");
     getKey();
-    return 1;
 }
 
-// 根据姓名查找学生
-int findStudentByName(StudentManager *manager, const char *name) {
-    if (manager == NULL || name == NULL || isEmptyString(name)) {
-        return -1;
+// 课程成绩统计：全部学生或按专业、院系、班级筛选后，各门课程的平均分、方差、最低最高分和及格率
+void showCourseStats(StudentManager *manager) {
+    clearScreen();
+    setColor(COLOR_GREEN);
+    printf("\n\n\t\t\t=======================================\n");
+    printf("\t\t\t          课程成绩统计          \n");
+    printf("\t\t\t=======================================\n\n");
+    setColor(COLOR_RESET);
+    
+    if (liveStudentCount(manager) == 0) {
+        setColor(COLOR_YELLOW);
+        printf("\t\t暂无学生信息！\n");
+        setColor(COLOR_RESET);
+        printf("\t\t按任意键返回...");
+        getKey();
+        return;
     }
     
-    for (int i = 0; i < manager->count; i++) {
-        if (strcmp(manager->students[i].name, name) == 0) {
-            return i;
+    // 依次输入筛选条件，直接回车表示不限
+    const char *prompts[3] = {"专业", "院系", "班级"};
+    char filters[3][100];
+    for (int i = 0; i < 3; i++) {
+        setColor(COLOR_CYAN);
+        printf("\t\t%s（直接回车为不限）: ", prompts[i]);
+        setColor(COLOR_RESET);
+        if (fgets(filters[i], sizeof(filters[i]), stdin) == NULL) {
+            filters[i][0] = '\0';
         }
+        filters[i][strcspn(filters[i], "\n")] = '\0';
     }
     
-    // 查找包含该姓名的学生（模糊查找）
-    for (int i = 0; i < manager->count; i++) {
-        if (strstr(manager->students[i].name, name) != NULL) {
-            return i;
-        }
+    long long start = currentTimeMs();
+    int count, courses;
+    int *indexes = filterStudents(manager, filters[0][0] != '\0' ? filters[0] : NULL,
+                                  filters[1][0] != '\0' ? filters[1] : NULL,
+                                  filters[2][0] != '\0' ? filters[2] : NULL, &count);
+    CourseStats *stats = count < 0 ? NULL : computeCourseStats(manager, indexes, count, &courses);
+    long long elapsed = currentTimeMs() - start;
+    free(indexes);
+    if (stats == NULL) {
+        setColor(COLOR_RED);
+        printf("\n\t\t内存分配失败！\n");
+        setColor(COLOR_RESET);
+        printf("\t\t按任意键返回...");
+        getKey();
+        return;
+    }
+    
+    static const char *simdNames[] = {"无", "SSE2", "AVX2"};
+    setColor(COLOR_YELLOW);
+    printf("\n\t\t统计 %d 名学生，%d 门课程，耗时 %lld 毫秒（向量指令：%s）\n\n", count, courses, elapsed,
+           simdNames[courseStatsSimdLevel()]);
+    printf("\t\t课程            人数      平均分    方差      最低分    最高分    及格率\n");
+    setColor(COLOR_RESET);
+    for (int j = 0; j < courses; j++) {
+        char buffer[32];
+        const char *name = courseName(manager, j, buffer, sizeof(buffer));
+        int padding = 16 - utf8DisplayWidth(name);
+        printf("\t\t%s%*s%-10d%-10.2f%-10.2f%-10.2f%-10.2f%.1f%%\n", name, padding > 0 ? padding : 0, "",
+               stats[j].count, courseMean(&stats[j]), courseVariance(&stats[j]), stats[j].min, stats[j].max,
+               stats[j].count > 0 ? stats[j].passCount * 100.0 / stats[j].count : 0.0);
+    }
+    if (courses == 0) {
+        printf("\t\t（没有成绩）\n");
     }
+    free(stats);
     
-    return -1;  // 未找到
+    printf("\n\t\t按任意键返回...");
+    getKey();
 }
 
-// 根据学号查找学生
-int findStudentById(StudentManager *manager, const char *id) {
-    if (manager == NULL || id == NULL || isEmptyString(id)) {
-        return -1;
+// 输出第 j 门成绩的分布：人数、中位数、P90、P99，以及每10分一段的文字直方图（每行以 indent 开头）
+void printScoreDistribution(const ScoreHistogram *histogram, int j, const char *name, const char *indent) {
+    int total = j < histogram->courseCount ? histogram->totals[j] : 0;
+    if (total <= 0) {
+        printf("%s%s：没有成绩\n", indent, name);
+        return;
     }
+    int median = histogramQuantile(histogram, j, 0.5);
+    int p90 = histogramQuantile(histogram, j, 0.9);
+    int p99 = histogramQuantile(histogram, j, 0.99);
+    printf("%s%s：%d 人，中位数 %.2f，P90 %.2f，P99 %.2f\n", indent, name, total, median / 100.0, p90 / 100.0,
+           p99 / 100.0);
     
-    for (int i = 0; i < manager->count; i++) {
-        if (strcmp(manager->students[i].id, id) == 0) {
-            return i;
-        }
+    int buckets[10], largest = 1;
+    histogramBuckets(histogram, j, buckets);
+    for (int b = 0; b < 10; b++) {
+        largest = buckets[b] > largest ? buckets[b] : largest;
+    }
+    for (int b = 0; b < 10; b++) {
+        char bar[41];
+        int length = (int)((long long)buckets[b] * 40 / largest);
+        length = length == 0 && buckets[b] > 0 ? 1 : length;
+        memset(bar, '#', (size_t)length);
+        bar[length] = '\0';
+        char label[16];
+        snprintf(label, sizeof(label), b < 9 ? "[%d,%d)" : "[%d,%d]", b * 10, b * 10 + 10);
+        printf("%s  %-9s %8d  %s\n", indent, label, buckets[b], bar);
     }
-    
-    return -1;  // 未找到
 }
 
-// 显示单个学生信息
-void displayStudent(const Student *student) {
-    if (student == NULL) {
+// 成绩分布报告：全体学生或某专业各门课程的中位数、P90、P99和分段直方图
+void showScoreDistribution(StudentManager *manager) {
+    clearScreen();
+    setColor(COLOR_GREEN);
+    printf("\n\n\t\t\t=======================================\n");
+    printf("\t\t\t          成绩分布报告          \n");
+    printf("\t\t\t=======================================\n\n");
+    setColor(COLOR_RESET);
+    
+    if (liveStudentCount(manager) == 0) {
+        setColor(COLOR_YELLOW);
+        printf("\t\t暂无学生信息！\n");
+        setColor(COLOR_RESET);
+        printf("\t\t按任意键返回...");
+        getKey();
         return;
     }
     
+    char major[100];
     setColor(COLOR_CYAN);
-    printf("\n============================================================\n");
-    printf("\t             学生信息详情\n");
-    printf("============================================================\n");
+    printf("\t\t专业（直接回车为全体学生）: ");
     setColor(COLOR_RESET);
+    if (fgets(major, sizeof(major), stdin) == NULL) {
+        major[0] = '\0';
+    }
+    major[strcspn(major, "\n")] = '\0';
     
-    setColor(COLOR_YELLOW);
-    printf("\t姓名: %s\n", student->name);
-    printf("\t学号: %s\n", student->id);
-    printf("\t性别: %s\n", student->gender);
-    printf("\t班级: %s\n", student->className);
-    printf("\t院系: %s\n", student->department);
-    printf("\t专业: %s\n", student->major);
-    printf("\t成绩列表: ");
-    for (int i = 0; i < student->scoreCount; i++) {
-        printf("%.2f", student->scores[i]);
-        if (i < student->scoreCount - 1) {
-            printf(", ");
+    int majorId = -1;
+    if (major[0] != '\0') {
+        majorId = dictLookup(&manager->strings, major);
+        PostingList *list = majorId == -1 ? NULL : postingFind(&manager->majorIndex, majorId);
+        if (list == NULL || list->count == 0) {
+            setColor(COLOR_RED);
+            printf("\n\t\t专业“%s”下没有学生！\n", major);
+            setColor(COLOR_RESET);
+            printf("\t\t按任意键返回...");
+            getKey();
+            return;
         }
     }
-    printf("\n");
-    printf("\t成绩总和: %.2f\n", student->totalScore);
-    setColor(COLOR_RESET);
     
-    setColor(COLOR_CYAN);
-    printf("============================================================\n");
-    setColor(COLOR_RESET);
-}
-
-// 查找学生信息
-void searchStudents(StudentManager *manager) {
-    if (manager == NULL) {
+    ScoreHistogram *histogram = histogramFor(manager, majorId);
+    if (histogram == NULL) {
         setColor(COLOR_RED);
-        printf("\n系统错误！\n");
+        printf("\n\t\t内存分配失败！\n");
         setColor(COLOR_RESET);
+        printf("\t\t按任意键返回...");
+        getKey();
         return;
     }
     
-    if (manager->count == 0) {
+    printf("\n");
+    for (int j = 0; j < histogram->courseCount; j++) {
+        char buffer[32];
+        setColor(COLOR_YELLOW);
+        printScoreDistribution(histogram, j, courseName(manager, j, buffer, sizeof(buffer)), "\t\t");
+        setColor(COLOR_RESET);
+        printf("\n");
+    }
+    if (histogram->courseCount == 0) {
+        printf("\t\t（没有成绩）\n");
+    }
+    
+    printf("\t\t按任意键返回...");
+    getKey();
+}
+
+// 批量操作：删除整个班级、专业整体转入另一专业、给某个班级的一门课程加分
+// 先给出受影响的人数，确认一次后一次完成；和批量导入一样不逐条写日志，结束后整体合并进快照
+void bulkOperations(StudentManager *manager) {
+    if (liveStudentCount(manager) == 0) {
         setColor(COLOR_YELLOW);
         printf("\n暂无学生信息！\n");
         setColor(COLOR_RESET);
@@ -1080,109 +10398,161 @@ void searchStudents(StudentManager *manager) {
         return;
     }
     
-    char searchChoice;
-    char searchInput[100];
-    int index;
-    
+    char choice;
     while (1) {
         clearScreen();
         setColor(COLOR_GREEN);
         printf("\n\n\t\t\t=======================================\n");
-        printf("\t\t\t          查找学生信息          \n");
+        printf("\t\t\t             批量操作          \n");
         printf("\t\t\t=======================================\n\n");
         setColor(COLOR_RESET);
         
         setColor(COLOR_YELLOW);
-        printf("\t\t[1] 按姓名查找\n");
-        printf("\t\t[2] 按学号查找\n");
+        printf("\t\t[1] 删除整个班级\n");
+        printf("\t\t[2] 专业整体转入另一专业\n");
+        printf("\t\t[3] 给某个班级的一门课程加分\n");
         printf("\t\t[0] 返回主菜单\n\n");
         setColor(COLOR_RESET);
         
         setColor(COLOR_CYAN);
-        printf("\t\t请选择查找方式: ");
+        printf("\t\t请选择: ");
+        setColor(COLOR_RESET);
+        
+        choice = getKey();
+        if (choice == '0') {
+            return;
+        }
+        if (choice >= '1' && choice <= '3') {
+            break;
+        }
+        
+        setColor(COLOR_RED);
+        printf("\n\t\t无效的选择，请重新输入！\n");
+        setColor(COLOR_RESET);
+        Sleep(1000);
+    }
+    clearInputBuffer();
+    
+    char className[100] = "", source[100] = "", target[100] = "", course[100] = "", points[100] = "";
+    const char *error = NULL;
+    int *indexes = NULL;
+    int count = 0, courseIndex = -1, fromId = -1, toId = -1;
+    float delta = 0;
+    if (choice == '1' || choice == '3') {
+        setColor(COLOR_CYAN);
+        printf("\n\t\t请输入班级名称: ");
+        setColor(COLOR_RESET);
+        if (fgets(className, sizeof(className), stdin) == NULL) {
+            return;
+        }
+        className[strcspn(className, "\n")] = '\0';
+        indexes = filterStudents(manager, NULL, NULL, className, &count);
+        if (indexes == NULL) {
+            error = "内存分配失败！";
+        } else if (count == 0) {
+            error = "该班级下没有学生！";
+        }
+    }
+    if (error == NULL && choice == '3') {
+        setColor(COLOR_CYAN);
+        printf("\t\t请输入课程（成绩名或序号）: ");
+        setColor(COLOR_RESET);
+        if (fgets(course, sizeof(course), stdin) != NULL) {
+            course[strcspn(course, "\n")] = '\0';
+        }
+        courseIndex = findCourse(manager, course);
+        setColor(COLOR_CYAN);
+        printf("\t\t请输入加分（可为负数）: ");
+        setColor(COLOR_RESET);
+        if (fgets(points, sizeof(points), stdin) != NULL) {
+            points[strcspn(points, "\n")] = '\0';
+        }
+        if (courseIndex == -1) {
+            error = "没有这门课程！";
+        } else if (sscanf(points, "%f", &delta) != 1 || delta < -100.0f || delta > 100.0f) {
+            error = "加分无效！";
+        }
+    }
+    if (choice == '2') {
+        setColor(COLOR_CYAN);
+        printf("\n\t\t请输入原专业: ");
         setColor(COLOR_RESET);
-        
-        searchChoice = getKey();
-        
-        if (searchChoice == '0') {
+        if (fgets(source, sizeof(source), stdin) == NULL) {
             return;
         }
-        
-        if (searchChoice == '1' || searchChoice == '2') {
-            break;
+        source[strcspn(source, "\n")] = '\0';
+        fromId = dictLookup(&manager->strings, source);
+        PostingList *list = fromId == -1 ? NULL : postingFind(&manager->majorIndex, fromId);
+        count = list == NULL ? 0 : list->count;
+        setColor(COLOR_CYAN);
+        printf("\t\t请输入转入专业: ");
+        setColor(COLOR_RESET);
+        if (fgets(target, sizeof(target), stdin) != NULL) {
+            target[strcspn(target, "\n")] = '\0';
         }
-        
+        if (count == 0) {
+            error = "该专业下没有学生！";
+        } else if (!isValidMajor(manager, target)) {
+            error = "转入专业不在预设中！";
+        } else if (strcmp(source, target) == 0) {
+            error = "原专业与转入专业相同！";
+        } else {
+            toId = dictIntern(&manager->strings, target);
+        }
+    }
+    if (error == NULL && toId == -1 && choice == '2') {
+        error = "内存分配失败！";
+    }
+    if (error != NULL) {
         setColor(COLOR_RED);
-        printf("\n\t\t无效的选择，请重新输入！\n");
+        printf("\n\t\t%s\n", error);
         setColor(COLOR_RESET);
-        Sleep(1000);
+        free(indexes);
+        printf("\t\t按任意键返回...");
+        getKey();
+        return;
     }
     
-    clearInputBuffer();
+    // 只确认一次
+    char buffer[32];
+    setColor(COLOR_RED);
+    if (choice == '1') {
+        printf("\n\t\t⚠️  将永久删除班级“%s”的 %d 名学生，是否确认？(y/n): ", className, count);
+    } else if (choice == '2') {
+        printf("\n\t\t将把专业“%s”的 %d 名学生转入“%s”，是否确认？(y/n): ", source, count, target);
+    } else {
+        printf("\n\t\t将给班级“%s”的 %d 名学生的“%s”加 %.2f 分（超出0~100分的按边界计），是否确认？(y/n): ",
+               className, count, courseName(manager, courseIndex, buffer, sizeof(buffer)), delta);
+    }
+    setColor(COLOR_RESET);
     
-    if (searchChoice == '1') {
-        setColor(COLOR_CYAN);
-        printf("\n\t\t请输入要查找的学生姓名: ");
-        setColor(COLOR_RESET);
-        
-        if (fgets(searchInput, sizeof(searchInput), stdin) != NULL) {
-            // 去除换行符
-            searchInput[strcspn(searchInput, "\n")] = '\0';
-            
-            if (isEmptyString(searchInput)) {
-                setColor(COLOR_RED);
-                printf("\n\t\t姓名不能为空！\n");
-                setColor(COLOR_RESET);
-                printf("\t\t按任意键返回...");
-                getKey();
-                return;
-            }
-            
-            index = findStudentByName(manager, searchInput);
-            
-            if (index != -1) {
-                displayStudent(&manager->students[index]);
-                setColor(COLOR_GREEN);
-                printf("\t\t学生信息查找成功！\n");
-                setColor(COLOR_RESET);
-            } else {
-                setColor(COLOR_RED);
-                printf("\n\t\t未找到该学生信息！\n");
-                setColor(COLOR_RESET);
-            }
+    char confirm = getKey();
+    if (confirm == 'y' || confirm == 'Y') {
+        int affected;
+        if (choice == '1') {
+            affected = bulkDeleteStudents(manager, indexes, count);
+        } else if (choice == '2') {
+            affected = bulkMoveMajor(manager, fromId, toId);
+        } else {
+            affected = bulkAddScore(manager, indexes, count, courseIndex, delta);
         }
-    } else if (searchChoice == '2') {
-        setColor(COLOR_CYAN);
-        printf("\n\t\t请输入要查找的学生学号: ");
-        setColor(COLOR_RESET);
-        
-        if (fgets(searchInput, sizeof(searchInput), stdin) != NULL) {
-            // 去除换行符
-            searchInput[strcspn(searchInput, "\n")] = '\0';
-            
-            if (isEmptyString(searchInput)) {
-                setColor(COLOR_RED);
-                printf("\n\t\t学号不能为空！\n");
-                setColor(COLOR_RESET);
-                printf("\t\t按任意键返回...");
-                getKey();
-                return;
-            }
-            
-            index = findStudentById(manager, searchInput);
-            
-            if (index != -1) {
-                displayStudent(&manager->students[index]);
-                setColor(COLOR_GREEN);
-                printf("\t\t学生信息查找成功！\n");
-                setColor(COLOR_RESET);
-            } else {
-                setColor(COLOR_RED);
-                printf("\n\t\t未找到该学生信息！\n");
-                setColor(COLOR_RESET);
-            }
+        if (affected != 0) {
+            compactJournal(manager);
         }
+        if (affected == -1) {
+            setColor(COLOR_RED);
+            printf("\n\t\t内存分配失败，操作未全部完成！\n");
+        } else {
+            setColor(COLOR_GREEN);
+            printf("\n\t\t✅ 操作完成，共影响 %d 名学生！\n", affected);
+        }
+        setColor(COLOR_RESET);
+    } else {
+        setColor(COLOR_YELLOW);
+        printf("\n\t\t已取消操作！\n");
+        setColor(COLOR_RESET);
     }
+    free(indexes);
     
     printf("\n\t\t按任意键返回...");
     getKey();
@@ -1197,7 +10567,7 @@ void modifyStudent(StudentManager *manager) {
         return;
     }
     
-    if (manager->count == 0) {
+    if (liveStudentCount(manager) == 0) {
         setColor(COLOR_YELLOW);
         printf("\n暂无学生信息！\n");
         setColor(COLOR_RESET);
@@ -1277,14 +10647,15 @@ void modifyStudent(StudentManager *manager) {
     }
     
     // 显示找到的学生信息
-    displayStudent(&manager->students[index]);
+    Student *student = getStudent(manager, index);
+    displayStudent(manager, student);
     
     char modifyChoice;
     char newData[100];
     
     while (1) {
         clearScreen();
-        displayStudent(&manager->students[index]);
+        displayStudent(manager, student);
         
         setColor(COLOR_YELLOW);
         printf("\n\t\t请选择要修改的信息项：\n");
@@ -1320,7 +10691,9 @@ void modifyStudent(StudentManager *manager) {
                         newData[strcspn(newData, "\n")] = '\0';
                         
                         if (isValidName(newData)) {
-                            strcpy(manager->students[index].name, newData);
+                            unindexStudentName(manager, index);
+                            strcpy(student->name, newData);
+                            indexStudentName(manager, index);
                             setColor(COLOR_GREEN);
                             printf("\t\t姓名修改成功！\n");
                             setColor(COLOR_RESET);
@@ -1351,7 +10724,7 @@ void modifyStudent(StudentManager *manager) {
                         }
                         
                         if (isValidGender(newData)) {
-                            strcpy(manager->students[index].gender, newData);
+                            strcpy(student->gender, newData);
                             setColor(COLOR_GREEN);
                             printf("\t\t性别修改成功！\n");
                             setColor(COLOR_RESET);
@@ -1374,15 +10747,24 @@ void modifyStudent(StudentManager *manager) {
                     if (fgets(newData, sizeof(newData), stdin) != NULL) {
                         newData[strcspn(newData, "\n")] = '\0';
                         
-                        if (!isEmptyString(newData) && strlen(newData) <= 50) {
-                            strcpy(manager->students[index].className, newData);
+                        if (!isEmptyString(newData) && strlen(newData) < CLASS_NAME_SIZE) {
+                            int newId = dictIntern(&manager->strings, newData);
+                            if (newId == -1) {
+                                setColor(COLOR_RED);
+                                printf("\t\t内存分配失败，班级未修改！\n");
+                                setColor(COLOR_RESET);
+                                break;
+                            }
+                            unindexStudent(manager, index);
+                            student->classId = newId;
+                            indexStudent(manager, index);
                             setColor(COLOR_GREEN);
                             printf("\t\t班级修改成功！\n");
                             setColor(COLOR_RESET);
                             break;
                         } else {
                             setColor(COLOR_RED);
-                            printf("\t\t班级名称不能为空且不能超过50个字符！\n");
+                            printf("\t\t班级名称不能为空且不能超过%d个字节！\n", CLASS_NAME_SIZE - 1);
                             setColor(COLOR_RESET);
                         }
                     }
@@ -1398,15 +10780,24 @@ void modifyStudent(StudentManager *manager) {
                     if (fgets(newData, sizeof(newData), stdin) != NULL) {
                         newData[strcspn(newData, "\n")] = '\0';
                         
-                        if (!isEmptyString(newData) && strlen(newData) <= 50) {
-                            strcpy(manager->students[index].department, newData);
+                        if (!isEmptyString(newData) && strlen(newData) < DEPARTMENT_NAME_SIZE) {
+                            int newId = dictIntern(&manager->strings, newData);
+                            if (newId == -1) {
+                                setColor(COLOR_RED);
+                                printf("\t\t内存分配失败，院系未修改！\n");
+                                setColor(COLOR_RESET);
+                                break;
+                            }
+                            unindexStudent(manager, index);
+                            student->departmentId = newId;
+                            indexStudent(manager, index);
                             setColor(COLOR_GREEN);
                             printf("\t\t院系修改成功！\n");
                             setColor(COLOR_RESET);
                             break;
                         } else {
                             setColor(COLOR_RED);
-                            printf("\t\t院系名称不能为空且不能超过50个字符！\n");
+                            printf("\t\t院系名称不能为空且不能超过%d个字节！\n", DEPARTMENT_NAME_SIZE - 1);
                             setColor(COLOR_RESET);
                         }
                     }
@@ -1422,15 +10813,24 @@ void modifyStudent(StudentManager *manager) {
                     if (fgets(newData, sizeof(newData), stdin) != NULL) {
                         newData[strcspn(newData, "\n")] = '\0';
                         
-                        if (!isEmptyString(newData) && strlen(newData) <= 50) {
-                            strcpy(manager->students[index].major, newData);
+                        if (!isEmptyString(newData) && strlen(newData) < MAJOR_NAME_SIZE) {
+                            int newId = dictIntern(&manager->strings, newData);
+                            if (newId == -1) {
+                                setColor(COLOR_RED);
+                                printf("\t\t内存分配失败，专业未修改！\n");
+                                setColor(COLOR_RESET);
+                                break;
+                            }
+                            unindexStudent(manager, index);
+                            student->majorId = newId;
+                            indexStudent(manager, index);
                             setColor(COLOR_GREEN);
                             printf("\t\t专业修改成功！\n");
                             setColor(COLOR_RESET);
                             break;
                         } else {
                             setColor(COLOR_RED);
-                            printf("\t\t专业名称不能为空且不能超过50个字符！\n");
+                            printf("\t\t专业名称不能为空且不能超过%d个字节！\n", MAJOR_NAME_SIZE - 1);
                             setColor(COLOR_RESET);
                         }
                     }
@@ -1441,14 +10841,14 @@ void modifyStudent(StudentManager *manager) {
                 // 显示当前成绩
                 setColor(COLOR_YELLOW);
                 printf("\n\t\t当前成绩列表: ");
-                for (int i = 0; i < manager->students[index].scoreCount; i++) {
+                for (int i = 0; i < student->scoreCount; i++) {
                     // 如果有预设的成绩名，显示成绩名
                     if (manager->scoreNameCount > 0 && i < manager->scoreNameCount) {
-                        printf("%s: %.2f", manager->scoreNames[i], manager->students[index].scores[i]);
+                        printf("%s: %.2f", manager->scoreNames[i], studentScore(student, i));
                     } else {
-                        printf("%.2f", manager->students[index].scores[i]);
+                        printf("%.2f", studentScore(student, i));
                     }
-                    if (i < manager->students[index].scoreCount - 1) {
+                    if (i < student->scoreCount - 1) {
                         printf(", ");
                     }
                 }
@@ -1468,66 +10868,26 @@ void modifyStudent(StudentManager *manager) {
                 }
                 setColor(COLOR_RESET);
                 
-                // 释放旧的成绩数组
-                if (manager->students[index].scores != NULL) {
-                    free(manager->students[index].scores);
-                }
-                
-                // 重新初始化成绩信息
-                int maxScores = 10;
-                manager->students[index].scores = (float *)malloc(maxScores * sizeof(float));
-                manager->students[index].scoreCount = 0;
-                manager->students[index].totalScore = 0.0;
-                
-                while (1) {
-                    char input[20];
-                    // 如果有预设的成绩名且当前输入的成绩索引小于预设数量，显示预设的成绩名
-                    if (manager->scoreNameCount > 0 && manager->students[index].scoreCount < manager->scoreNameCount) {
-                        printf("\t\t%s: ", manager->scoreNames[manager->students[index].scoreCount]);
-                    } else {
-                        printf("\t\t成绩 %d: ", manager->students[index].scoreCount + 1);
-                    }
-                    scanf("%s", input);
-                    
-                    // 检查是否输入end
-                    if (strcmp(input, "end") == 0) {
-                        break;
-                    }
-                    
-                    // 尝试转换为数字
-                    char *endptr;
-                    float scoreValue = strtof(input, &endptr);
-                    
-                    // 验证输入是否为有效数字且在0-100之间
-                    if (*endptr == '\0' && isValidScore(scoreValue)) {
-                        // 检查是否需要扩容
-                        if (manager->students[index].scoreCount >= maxScores) {
-                            maxScores *= 2;
-                            manager->students[index].scores = (float *)realloc(manager->students[index].scores, maxScores * sizeof(float));
-                        }
-                        
-                        // 添加成绩
-                        manager->students[index].scores[manager->students[index].scoreCount] = scoreValue;
-                        manager->students[index].totalScore += scoreValue;
-                        manager->students[index].scoreCount++;
-                    } else {
-                        setColor(COLOR_RED);
-                        printf("\t\t成绩无效，请输入0-100之间的数字或输入end结束！\n");
-                        setColor(COLOR_RESET);
-                    }
+                // 新成绩先录入临时数组，完成后替换学生原有成绩
+                int enteredCount;
+                float *entered = inputScores(manager, &enteredCount);
+                if (entered == NULL) {
+                    setColor(COLOR_RED);
+                    printf("\t\t内存分配失败，成绩未修改！\n");
+                    setColor(COLOR_RESET);
+                    break;
                 }
                 
-                // 如果没有输入任何成绩，设置一个默认值
-                if (manager->students[index].scoreCount == 0) {
-                    manager->students[index].scores[0] = 0.0;
-                    manager->students[index].scoreCount = 1;
-                    manager->students[index].totalScore = 0.0;
-                    setColor(COLOR_YELLOW);
-                    printf("\t\t未输入成绩，已设置默认值0分\n");
+                // 成绩改变，先移出排行和成绩分布，换上新成绩后再按新成绩放回
+                unindexStudentScores(manager, index);
+                int stored = setStudentScores(&manager->scorePool, student, entered, enteredCount);
+                indexStudentScores(manager, index);
+                free(entered);
+                if (!stored) {
+                    setColor(COLOR_RED);
+                    printf("\t\t内存分配失败，成绩未修改！\n");
                     setColor(COLOR_RESET);
-                } else {
-                    // 重新分配内存到实际需要的大小
-                    manager->students[index].scores = (float *)realloc(manager->students[index].scores, manager->students[index].scoreCount * sizeof(float));
+                    break;
                 }
                 
                 setColor(COLOR_GREEN);
@@ -1542,6 +10902,12 @@ void modifyStudent(StudentManager *manager) {
                 Sleep(1000);
         }
         
+        // 记录修改后的完整学生信息
+        if (modifyChoice >= '1' && modifyChoice <= '6') {
+            invalidateColumns(manager);
+            journalRecordStudent(manager, JOURNAL_MODIFY, student);
+        }
+        
         printf("\t\t按任意键继续...");
         getKey();
     }
@@ -1569,7 +10935,7 @@ void deleteStudent(StudentManager *manager) {
     printf("\t\t\t=======================================\n\n");
     setColor(COLOR_RESET);
     
-    if (manager->count == 0) {
+    if (liveStudentCount(manager) == 0) {
         setColor(COLOR_YELLOW);
         printf("\n\t\t暂无学生信息！\n");
         setColor(COLOR_RESET);
@@ -1664,7 +11030,7 @@ void deleteStudent(StudentManager *manager) {
     setColor(COLOR_CYAN);
     printf("\n\t\t要删除的学生信息:\n");
     setColor(COLOR_RESET);
-    displayStudent(&manager->students[index]);
+    displayStudent(manager, getStudent(manager, index));
     
     setColor(COLOR_RED);
     printf("\n\t\t⚠️  警告：此操作将永久删除该学生信息！\n");
@@ -1673,15 +11039,19 @@ void deleteStudent(StudentManager *manager) {
     
     char confirm = getKey();
     if (confirm == 'y' || confirm == 'Y') {
-        // 删除学生（将后面的学生前移）
-        for (int i = index; i < manager->count - 1; i++) {
-            manager->students[i] = manager->students[i + 1];
+        // 删除学生（归还成绩存储，全部索引同步更新，学生数组中的空位稍后统一压缩）
+        char id[20];
+        strcpy(id, getStudent(manager, index)->id);
+        if (removeStudentAt(manager, index)) {
+            journalRecordDelete(manager, id);
+            setColor(COLOR_GREEN);
+            printf("\n\t\t✅ 学生信息删除成功！\n");
+            setColor(COLOR_RESET);
+        } else {
+            setColor(COLOR_RED);
+            printf("\n\t\t内存分配失败，未删除！\n");
+            setColor(COLOR_RESET);
         }
-        manager->count--;
-        
-        setColor(COLOR_GREEN);
-        printf("\n\t\t✅ 学生信息删除成功！\n");
-        setColor(COLOR_RESET);
     } else {
         setColor(COLOR_YELLOW);
         printf("\n\t\t已取消删除操作！\n");
@@ -1692,6 +11062,145 @@ void deleteStudent(StudentManager *manager) {
     getKey();
 }
 
+// 在下标列表中查找学生下标的位置，未找到返回-1
+// 列表通常升序，先二分查找；分段有序的列表（如按姓名查找的结果）再顺序查找
+int findListPosition(const int *indexes, int total, int index) {
+    int low = 0, high = total - 1;
+    while (low <= high) {
+        int mid = low + (high - low) / 2;
+        if (indexes[mid] == index) {
+            return mid;
+        }
+        if (indexes[mid] < index) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    for (int i = 0; i < total; i++) {
+        if (indexes[i] == index) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// 分页浏览学生：每次只格式化当前页的 BROWSE_PAGE_SIZE 行，翻页耗时与学生总数无关
+// indexes 为学生下标列表（通常按升序排列），为NULL时浏览全部学生（并记住光标位置供下次进入）
+void browseStudents(StudentManager *manager, const int *indexes, int total, const char *title) {
+    int cursor = indexes == NULL ? manager->browseCursor : 0;
+    char input[100];
+    
+    while (1) {
+        if (cursor >= total) {
+            cursor = total - 1;
+        }
+        if (cursor < 0) {
+            cursor = 0;
+        }
+        int pageCount = (total + BROWSE_PAGE_SIZE - 1) / BROWSE_PAGE_SIZE;
+        int page = cursor / BROWSE_PAGE_SIZE;
+        int first = page * BROWSE_PAGE_SIZE;
+        int last = first + BROWSE_PAGE_SIZE < total ? first + BROWSE_PAGE_SIZE : total;
+        
+        clearScreen();
+        outputColor(&screenBuffer, COLOR_YELLOW);
+        outputString(&screenBuffer, "\n\n\t\t===== ");
+        outputString(&screenBuffer, title);
+        outputString(&screenBuffer, " =====\n\n");
+        outputColor(&screenBuffer, COLOR_RESET);
+        renderTableHeader(&screenBuffer);
+        for (int pos = first; pos < last; pos++) {
+            const Student *student = getStudent(manager, indexes == NULL ? pos : indexes[pos]);
+            if (pos == cursor) {
+                outputColor(&screenBuffer, COLOR_GREEN);
+                renderStudentRow(&screenBuffer, manager, student, pos + 1);
+                outputColor(&screenBuffer, COLOR_RESET);
+            } else {
+                renderStudentRow(&screenBuffer, manager, student, pos + 1);
+            }
+        }
+        outputColor(&screenBuffer, COLOR_CYAN);
+        outputString(&screenBuffer, "\n\t\t第 ");
+        outputInt(&screenBuffer, page + 1);
+        outputString(&screenBuffer, "/");
+        outputInt(&screenBuffer, pageCount);
+        outputString(&screenBuffer, " 页，共 ");
+        outputInt(&screenBuffer, total);
+        outputString(&screenBuffer, " 名学生，当前第 ");
+        outputInt(&screenBuffer, cursor + 1);
+        outputString(&screenBuffer, " 名\n");
+        outputColor(&screenBuffer, COLOR_RESET);
+        outputColor(&screenBuffer, COLOR_YELLOW);
+        outputString(&screenBuffer, "\t\t[n]下一页 [p]上一页 [s]下移 [w]上移 [回车]查看详情 "
+                                    "[g]跳转到页 [i]按学号跳转 [0]返回\n");
+        outputColor(&screenBuffer, COLOR_RESET);
+        outputFlush(&screenBuffer);
+        
+        char key = getKey();
+        if (key >= 'A' && key <= 'Z') {
+            key += 32;
+        }
+        if (key == '0' || key == 'q') {
+            break;
+        }
+        switch (key) {
+            case 'n':
+                cursor = page + 1 < pageCount ? (page + 1) * BROWSE_PAGE_SIZE : cursor;
+                break;
+            case 'p':
+                cursor = page > 0 ? (page - 1) * BROWSE_PAGE_SIZE : cursor;
+                break;
+            case 's':
+                cursor++;
+                break;
+            case 'w':
+                cursor--;
+                break;
+            case '\r':
+            case '\n':
+                clearScreen();
+                displayStudent(manager, getStudent(manager, indexes == NULL ? cursor : indexes[cursor]));
+                printf("\t\t按任意键返回列表...");
+                getKey();
+                break;
+            case 'g': {
+                printf("\t\t请输入页码 (1-%d): ", pageCount);
+                if (fgets(input, sizeof(input), stdin) != NULL) {
+                    int target = atoi(input);
+                    if (target >= 1 && target <= pageCount) {
+                        cursor = (target - 1) * BROWSE_PAGE_SIZE;
+                    }
+                }
+                break;
+            }
+            case 'i': {
+                printf("\t\t请输入学号: ");
+                if (fgets(input, sizeof(input), stdin) != NULL) {
+                    input[strcspn(input, "\r\n")] = '\0';
+                    int index = findStudentById(manager, input);
+                    int pos = index == -1 ? -1 : (indexes == NULL ? index : findListPosition(indexes, total, index));
+                    if (pos != -1) {
+                        cursor = pos;
+                    } else {
+                        setColor(COLOR_RED);
+                        printf("\t\t当前列表中没有该学号的学生！\n");
+                        setColor(COLOR_RESET);
+                        Sleep(1000);
+                    }
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    
+    if (indexes == NULL) {
+        manager->browseCursor = cursor;
+    }
+}
+
 // 显示所有学生信息
 void displayAllStudents(StudentManager *manager) {
     clearScreen();
@@ -1701,16 +11210,19 @@ void displayAllStudents(StudentManager *manager) {
     
     // 显示筛选菜单
     setColor(COLOR_CYAN);
-    printf("\t\t1. 查看所有学生\n");
+    printf("\t\t1. 分页浏览所有学生\n");
     printf("\t\t2. 按专业筛选查看\n");
+    printf("\t\t3. 表格形式列出所有学生\n");
+    printf("\t\t4. 详细列出所有学生\n");
+    printf("\t\t5. 组合筛选（专业/院系/班级）\n");
     setColor(COLOR_RESET);
     
-    printf("\t\t请选择操作 (1-2): ");
+    printf("\t\t请选择操作 (1-5): ");
     int choice;
     int result = scanf("%d", &choice);
     clearInputBuffer();
     
-    if (result != 1 || (choice != 1 && choice != 2)) {
+    if (result != 1 || choice < 1 || choice > 5) {
         setColor(COLOR_RED);
         printf("\t\t选择无效！\n");
         setColor(COLOR_RESET);
@@ -1720,6 +11232,8 @@ void displayAllStudents(StudentManager *manager) {
     }
     
     clearScreen();
+    // 列出全部学生本身就是 O(n)，先压缩掉逐个删除留下的空位，序号与下标保持连续
+    compactStudents(manager);
     
     if (manager->count == 0) {
         setColor(COLOR_YELLOW);
@@ -1734,7 +11248,11 @@ void displayAllStudents(StudentManager *manager) {
     }
     
     if (choice == 1) {
-        // 查看所有学生
+        // 分页浏览
+        browseStudents(manager, NULL, manager->count, "所有学生信息");
+        return;
+    } else if (choice == 4) {
+        // 详细列出所有学生
         setColor(COLOR_YELLOW);
         printf("\n\n\t\t===== 所有学生信息 =====\n\n");
         setColor(COLOR_RESET);
@@ -1744,10 +11262,24 @@ void displayAllStudents(StudentManager *manager) {
         setColor(COLOR_RESET);
         
         for (int i = 0; i < manager->count; i++) {
-            printf("\t\t学生 %d:\n", i + 1);
-            displayStudent(&manager->students[i]);
-            printf("\t\t-----------------------------\n");
+            renderStudentDetail(&screenBuffer, manager, getStudent(manager, i), i + 1);
+        }
+        outputFlush(&screenBuffer);
+    } else if (choice == 3) {
+        // 紧凑表格：每名学生一行
+        setColor(COLOR_YELLOW);
+        printf("\n\n\t\t===== 所有学生信息 =====\n\n");
+        setColor(COLOR_RESET);
+        
+        renderTableHeader(&screenBuffer);
+        for (int i = 0; i < manager->count; i++) {
+            renderStudentRow(&screenBuffer, manager, getStudent(manager, i), i + 1);
         }
+        outputFlush(&screenBuffer);
+        
+        setColor(COLOR_CYAN);
+        printf("\n\t\t共有 %d 名学生\n", manager->count);
+        setColor(COLOR_RESET);
     } else if (choice == 2) {
         // 按专业筛选查看
         if (manager->majorCount == 0) {
@@ -1787,39 +11319,129 @@ void displayAllStudents(StudentManager *manager) {
             return;
         }
         
-        // 显示选中专业的学生信息
+        // 从专业倒排索引取出选中专业的学生后分页浏览
         const char *selectedMajor = manager->majorNames[majorChoice - 1];
-        clearScreen();
-        
-        setColor(COLOR_YELLOW);
-        printf("\n\n\t\t===== %s 专业学生信息 =====\n\n", selectedMajor);
-        setColor(COLOR_RESET);
-        
-        int count = 0;
-        for (int i = 0; i < manager->count; i++) {
-            if (strcmp(manager->students[i].major, selectedMajor) == 0) {
-                count++;
-                printf("\t\t学生 %d:\n", count);
-                displayStudent(&manager->students[i]);
-                printf("\t\t-----------------------------\n");
-            }
+        int count;
+        int *matches = filterStudents(manager, selectedMajor, NULL, NULL, &count);
+        if (matches == NULL) {
+            setColor(COLOR_RED);
+            printf("\t\t内存分配失败！\n");
+            setColor(COLOR_RESET);
+            printf("\t\t按任意键返回...");
+            getKey();
+            return;
         }
         
         if (count == 0) {
+            free(matches);
+            setColor(COLOR_YELLOW);
+            printf("\n\n\t\t===== %s 专业学生信息 =====\n\n", selectedMajor);
+            setColor(COLOR_RESET);
             setColor(COLOR_RED);
             printf("\t\t该专业暂无学生信息！\n");
             setColor(COLOR_RESET);
         } else {
-            setColor(COLOR_CYAN);
-            printf("\t\t共有 %d 名学生\n", count);
-            setColor(COLOR_RESET);
+            char title[100];
+            snprintf(title, sizeof(title), "%s 专业学生信息", selectedMajor);
+            browseStudents(manager, matches, count, title);
+            free(matches);
+            return;
         }
+    } else if (choice == 5) {
+        filterStudentsMenu(manager);
+        return;
     }
     
     printf("\t\t按任意键返回...");
     getKey();
 }
 
+// 组合筛选：依次选择专业、院系（0 表示不限）并输入班级（直接回车表示不限），按倒排列表求交集后分页浏览
+void filterStudentsMenu(StudentManager *manager) {
+    setColor(COLOR_YELLOW);
+    printf("\n\n\t\t===== 组合筛选 =====\n\n");
+    setColor(COLOR_RESET);
+    
+    const char *major = NULL;
+    const char *department = NULL;
+    int choice;
+    
+    setColor(COLOR_CYAN);
+    printf("\t\t0. 不限专业\n");
+    for (int i = 0; i < manager->majorCount; i++) {
+        printf("\t\t%d. %s\n", i + 1, manager->majorNames[i]);
+    }
+    setColor(COLOR_RESET);
+    printf("\t\t请选择专业 (0-%d): ", manager->majorCount);
+    if (scanf("%d", &choice) != 1 || choice < 0 || choice > manager->majorCount) {
+        clearInputBuffer();
+        setColor(COLOR_RED);
+        printf("\t\t选择无效！\n");
+        setColor(COLOR_RESET);
+        printf("\t\t按任意键返回...");
+        getKey();
+        return;
+    }
+    clearInputBuffer();
+    if (choice > 0) {
+        major = manager->majorNames[choice - 1];
+    }
+    
+    setColor(COLOR_CYAN);
+    printf("\n\t\t0. 不限院系\n");
+    for (int i = 0; i < manager->departmentCount; i++) {
+        printf("\t\t%d. %s\n", i + 1, manager->departmentNames[i]);
+    }
+    setColor(COLOR_RESET);
+    printf("\t\t请选择院系 (0-%d): ", manager->departmentCount);
+    if (scanf("%d", &choice) != 1 || choice < 0 || choice > manager->departmentCount) {
+        clearInputBuffer();
+        setColor(COLOR_RED);
+        printf("\t\t选择无效！\n");
+        setColor(COLOR_RESET);
+        printf("\t\t按任意键返回...");
+        getKey();
+        return;
+    }
+    clearInputBuffer();
+    if (choice > 0) {
+        department = manager->departmentNames[choice - 1];
+    }
+    
+    char className[50];
+    printf("\n\t\t请输入班级（直接回车表示不限）: ");
+    if (fgets(className, sizeof(className), stdin) == NULL) {
+        className[0] = '\0';
+    }
+    className[strcspn(className, "\r\n")] = '\0';
+    
+    int count;
+    int *matches = filterStudents(manager, major, department, className[0] != '\0' ? className : NULL, &count);
+    if (count < 0) {
+        setColor(COLOR_RED);
+        printf("\t\t内存分配失败！\n");
+        setColor(COLOR_RESET);
+        printf("\t\t按任意键返回...");
+        getKey();
+        return;
+    }
+    
+    if (count == 0) {
+        setColor(COLOR_RED);
+        printf("\n\t\t没有符合条件的学生！\n");
+        setColor(COLOR_RESET);
+        printf("\t\t按任意键返回...");
+        getKey();
+    } else {
+        char title[200];
+        snprintf(title, sizeof(title), "筛选结果（专业:%s 院系:%s 班级:%s）",
+                 major != NULL ? major : "不限", department != NULL ? department : "不限",
+                 className[0] != '\0' ? className : "不限");
+        browseStudents(manager, matches, count, title);
+    }
+    free(matches);
+}
+
 // 显示使用说明
 void showInstructions() {
     clearScreen();
@@ -1840,7 +11462,7 @@ void showInstructions() {
     setColor(COLOR_YELLOW);
     printf("\t\t【重要提示】\n");
     setColor(COLOR_RED);
-    printf("\t\t该软件目前仍处于开发中，尚未实现长期的数据保存功能，慎用！\n");
+    printf("\t\t该软件目前仍处于开发中，数据仅在通过 '0. 退出系统' 退出时保存到 %s，慎用！\n", SNAPSHOT_FILE);
     printf("\t\t建议仅在测试环境中使用，正式环境请备份数据！\n");
     setColor(COLOR_RESET);
     
@@ -2002,6 +11624,7 @@ void addScoreName(StudentManager *manager, const char *name) {
     
     strcpy(manager->scoreNames[manager->scoreNameCount], name);
     manager->scoreNameCount++;
+    journalRecordPreset(manager, PRESET_SCORE_NAME, name);
     
     setColor(COLOR_GREEN);
     printf("\n成功添加成绩名：%s\n", name);
@@ -2018,6 +11641,7 @@ void clearScoreNames(StudentManager *manager) {
         }
         manager->scoreNameCount = 0;
     }
+    journalRecordPreset(manager, PRESET_SCORE_NAME, NULL);
     
     setColor(COLOR_GREEN);
     printf("\n所有成绩名预设已清除！\n");
@@ -2027,7 +11651,7 @@ void clearScoreNames(StudentManager *manager) {
 // 管理成绩名预设
 void manageScoreNames(StudentManager *manager) {
     char choice;
-    char scoreName[50];
+    char scoreName[SCORE_NAME_SIZE];
     
     while (1) {
         clearScreen();